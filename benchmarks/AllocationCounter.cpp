@@ -0,0 +1,146 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<juce::int64> allocationCount{0};
+
+void* allocate(std::size_t size) noexcept
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* allocateAligned(std::size_t size, std::size_t alignment) noexcept
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+#if JUCE_WINDOWS
+    return _aligned_malloc(size == 0 ? 1 : size, alignment);
+#else
+    void* result = nullptr;
+    alignment = juce::jmax(alignment, sizeof(void*));
+    return posix_memalign(&result, alignment, size == 0 ? 1 : size) == 0 ? result : nullptr;
+#endif
+}
+
+void freeAligned(void* pointer) noexcept
+{
+#if JUCE_WINDOWS
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+
+void* allocateOrThrow(std::size_t size)
+{
+    if (auto* result = allocate(size))
+    {
+        return result;
+    }
+
+    throw std::bad_alloc();
+}
+
+void* allocateAlignedOrThrow(std::size_t size, std::size_t alignment)
+{
+    if (auto* result = allocateAligned(size, alignment))
+    {
+        return result;
+    }
+
+    throw std::bad_alloc();
+}
+} // namespace
+
+juce::int64 AllocationCounter::getCount() noexcept
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+//==============================================================================
+// Global replacements (this translation unit is only linked into DAIW_benchmarks)
+
+void* operator new(std::size_t size)
+{
+    return allocateOrThrow(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return allocateOrThrow(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocateAlignedOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return allocateAlignedOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+    freeAligned(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept
+{
+    freeAligned(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept
+{
+    freeAligned(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept
+{
+    freeAligned(pointer);
+}
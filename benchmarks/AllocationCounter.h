@@ -0,0 +1,29 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * AllocationCounter counts heap allocations made by the benchmark binary.
+ *
+ * AllocationCounter.cpp replaces the global operator new/delete family for the
+ * DAIW_benchmarks target only, so every allocation on any thread (including
+ * JUCE's) bumps one relaxed atomic. Compare two readings around the measured
+ * code; anything non-zero on the audio path is a real-time safety bug.
+ */
+namespace AllocationCounter
+{
+// Total allocations since the process started
+juce::int64 getCount() noexcept;
+
+/** Counts allocations between construction and getCount(). */
+class Scope
+{
+public:
+    Scope() noexcept : start(AllocationCounter::getCount()) {}
+
+    juce::int64 getCount() const noexcept { return AllocationCounter::getCount() - start; }
+
+private:
+    const juce::int64 start;
+};
+} // namespace AllocationCounter
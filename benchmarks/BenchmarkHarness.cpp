@@ -0,0 +1,287 @@
+#include "BenchmarkHarness.h"
+#include "AllocationCounter.h"
+#include "PerfCounters.h"
+
+#include <iostream>
+#include <limits>
+#include <map>
+
+//==============================================================================
+// BenchmarkRegistry
+//==============================================================================
+
+BenchmarkRegistry& BenchmarkRegistry::getInstance()
+{
+    // Function-local so registrars in other files can run during static initialisation
+    static BenchmarkRegistry registry;
+    return registry;
+}
+
+void BenchmarkRegistry::add(const juce::String& name, Factory factory)
+{
+    entries.push_back({name, std::move(factory)});
+}
+
+//==============================================================================
+// BenchmarkResult
+//==============================================================================
+
+juce::String BenchmarkResult::getKey() const
+{
+    return name + "/" + juce::String(config.numChannels) + "ch/" +
+           juce::String(config.blockSize) + "/" + juce::String(config.sampleRate, 0);
+}
+
+juce::var BenchmarkResult::toVar() const
+{
+    auto* object = new juce::DynamicObject();
+    object->setProperty("name", name);
+    object->setProperty("channels", config.numChannels);
+    object->setProperty("blockSize", config.blockSize);
+    object->setProperty("sampleRate", config.sampleRate);
+    object->setProperty("nsPerSample", nsPerSample);
+    object->setProperty("allocationsPerBlock", allocationsPerBlock);
+    object->setProperty("cacheMissesPerBlock",
+                        cacheMissesPerBlock >= 0.0 ? juce::var(cacheMissesPerBlock) : juce::var());
+    return juce::var(object);
+}
+
+BenchmarkResult BenchmarkResult::fromVar(const juce::var& value)
+{
+    BenchmarkResult result;
+    result.name = value["name"].toString();
+    result.config.numChannels = value["channels"];
+    result.config.blockSize = value["blockSize"];
+    result.config.sampleRate = value["sampleRate"];
+    result.nsPerSample = value["nsPerSample"];
+    result.allocationsPerBlock = value["allocationsPerBlock"];
+
+    auto cacheMisses = value["cacheMissesPerBlock"];
+    result.cacheMissesPerBlock = cacheMisses.isVoid() ? -1.0 : static_cast<double>(cacheMisses);
+    return result;
+}
+
+//==============================================================================
+// BenchmarkRunner
+//==============================================================================
+
+BenchmarkRunner::Matrix BenchmarkRunner::Matrix::quick()
+{
+    Matrix matrix;
+    matrix.channelCounts = {2, 64};
+    matrix.blockSizes = {32, 256, 4096};
+    matrix.sampleRates = {48000.0};
+    return matrix;
+}
+
+BenchmarkRunner::BenchmarkRunner(const Options& runnerOptions) : options(runnerOptions)
+{
+}
+
+BenchmarkResult BenchmarkRunner::measure(Benchmark& benchmark, const juce::String& name,
+                                         const BenchmarkConfig& config, int numRuns,
+                                         int samplesPerRun)
+{
+    const int blocksPerRun = juce::jmax(4, samplesPerRun / config.blockSize);
+
+    BenchmarkResult result;
+    result.name = name;
+    result.config = config;
+
+    benchmark.prepare(config);
+
+    // Warm-up: caches, branch predictors, lazily initialised state
+    for (int i = 0; i < blocksPerRun; ++i)
+    {
+        benchmark.processBlock();
+    }
+
+    PerfCounters perfCounters;
+    juce::int64 totalCacheMisses = 0;
+    juce::int64 totalAllocations = 0;
+    double bestTicks = std::numeric_limits<double>::max();
+
+    for (int run = 0; run < numRuns; ++run)
+    {
+        AllocationCounter::Scope allocations;
+        perfCounters.start();
+        auto start = juce::Time::getHighResolutionTicks();
+
+        for (int i = 0; i < blocksPerRun; ++i)
+        {
+            benchmark.processBlock();
+        }
+
+        auto elapsed = juce::Time::getHighResolutionTicks() - start;
+        auto cacheMisses = perfCounters.stop();
+
+        totalAllocations += allocations.getCount();
+        totalCacheMisses += juce::jmax(static_cast<juce::int64>(0), cacheMisses);
+        bestTicks = juce::jmin(bestTicks, static_cast<double>(elapsed));
+    }
+
+    benchmark.release();
+
+    const auto totalBlocks = static_cast<double>(numRuns) * blocksPerRun;
+    const auto samplesPerRunTotal =
+        static_cast<double>(blocksPerRun) * config.blockSize * config.numChannels;
+
+    auto bestSeconds =
+        juce::Time::highResolutionTicksToSeconds(static_cast<juce::int64>(bestTicks));
+
+    result.nsPerSample = bestSeconds * 1.0e9 / samplesPerRunTotal;
+    result.allocationsPerBlock = static_cast<double>(totalAllocations) / totalBlocks;
+    result.cacheMissesPerBlock =
+        perfCounters.isAvailable() ? static_cast<double>(totalCacheMisses) / totalBlocks : -1.0;
+
+    return result;
+}
+
+std::vector<BenchmarkResult> BenchmarkRunner::run()
+{
+    std::vector<BenchmarkResult> results;
+
+    std::cout << "benchmark\tchannels\tblock\trate\tns/sample\tallocs/block\tmisses/block"
+              << std::endl;
+
+    for (const auto& entry : BenchmarkRegistry::getInstance().getEntries())
+    {
+        if (options.filter.isNotEmpty() && !entry.name.contains(options.filter))
+        {
+            continue;
+        }
+
+        for (auto numChannels : options.matrix.channelCounts)
+        {
+            for (auto blockSize : options.matrix.blockSizes)
+            {
+                for (auto sampleRate : options.matrix.sampleRates)
+                {
+                    BenchmarkConfig config{numChannels, blockSize, sampleRate};
+
+                    // Fresh instance per configuration so no state leaks between points
+                    auto benchmark = entry.create();
+                    auto result = measure(*benchmark, entry.name, config, options.numRuns,
+                                          options.samplesPerRun);
+
+                    std::cout << entry.name << "\t" << numChannels << "\t" << blockSize << "\t"
+                              << sampleRate << "\t" << juce::String(result.nsPerSample, 3)
+                              << "\t" << juce::String(result.allocationsPerBlock, 2) << "\t"
+                              << (result.cacheMissesPerBlock >= 0.0
+                                      ? juce::String(result.cacheMissesPerBlock, 1)
+                                      : juce::String("n/a"))
+                              << std::endl;
+
+                    results.push_back(result);
+                }
+            }
+        }
+    }
+
+    return results;
+}
+
+//==============================================================================
+// BenchmarkResults
+//==============================================================================
+
+juce::Result BenchmarkResults::writeJSON(const std::vector<BenchmarkResult>& results,
+                                         const juce::String& label, const juce::File& file)
+{
+    juce::Array<juce::var> resultArray;
+    for (const auto& result : results)
+    {
+        resultArray.add(result.toVar());
+    }
+
+    auto* object = new juce::DynamicObject();
+    object->setProperty("label", label);
+    object->setProperty("cpu", juce::SystemStats::getCpuModel());
+    object->setProperty("os", juce::SystemStats::getOperatingSystemName());
+    object->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(true));
+    object->setProperty("results", resultArray);
+
+    if (!file.replaceWithText(juce::JSON::toString(juce::var(object))))
+    {
+        return juce::Result::fail("Could not write " + file.getFullPathName());
+    }
+
+    return juce::Result::ok();
+}
+
+juce::Result BenchmarkResults::readJSON(const juce::File& file,
+                                        std::vector<BenchmarkResult>& results)
+{
+    juce::var parsed;
+    auto parseResult = juce::JSON::parse(file.loadFileAsString(), parsed);
+
+    if (parseResult.failed())
+    {
+        return juce::Result::fail("Could not parse " + file.getFullPathName() + ": " +
+                                  parseResult.getErrorMessage());
+    }
+
+    if (auto* resultArray = parsed["results"].getArray())
+    {
+        for (const auto& value : *resultArray)
+        {
+            results.push_back(BenchmarkResult::fromVar(value));
+        }
+    }
+
+    return juce::Result::ok();
+}
+
+int BenchmarkResults::compare(const std::vector<BenchmarkResult>& baseline,
+                              const std::vector<BenchmarkResult>& current,
+                              double thresholdPercent)
+{
+    std::map<juce::String, BenchmarkResult> baselineByKey;
+    for (const auto& result : baseline)
+    {
+        baselineByKey[result.getKey()] = result;
+    }
+
+    int regressions = 0;
+
+    std::cout << std::endl << "Comparison against baseline (threshold "
+              << juce::String(thresholdPercent, 1) << "%)" << std::endl;
+
+    for (const auto& result : current)
+    {
+        auto found = baselineByKey.find(result.getKey());
+        if (found == baselineByKey.end())
+        {
+            continue;
+        }
+
+        const auto& previous = found->second;
+        auto changePercent = previous.nsPerSample > 0.0
+                                 ? 100.0 * (result.nsPerSample / previous.nsPerSample - 1.0)
+                                 : 0.0;
+        auto slower = changePercent > thresholdPercent;
+        auto newAllocations = result.allocationsPerBlock > 0.0 &&
+                              previous.allocationsPerBlock == 0.0;
+
+        if (slower || newAllocations)
+        {
+            ++regressions;
+            std::cout << "REGRESSION " << result.getKey() << ": "
+                      << juce::String(previous.nsPerSample, 3) << " -> "
+                      << juce::String(result.nsPerSample, 3) << " ns/sample ("
+                      << (changePercent >= 0.0 ? "+" : "") << juce::String(changePercent, 1)
+                      << "%)";
+
+            if (newAllocations)
+            {
+                std::cout << ", now allocates " << juce::String(result.allocationsPerBlock, 2)
+                          << " per block";
+            }
+
+            std::cout << std::endl;
+        }
+    }
+
+    std::cout << regressions << " regression(s)" << std::endl;
+    return regressions;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * Benchmark harness for the audio processing path.
+ *
+ * A Benchmark is one unit of audio work (the engine's block processing, a DSP
+ * kernel, ...). The runner prepares it for every point of a configuration
+ * matrix (channel count x block size x sample rate), then times processBlock()
+ * and records nanoseconds per sample, heap allocations per block and, where
+ * perf events are available, cache misses per block.
+ *
+ * New benchmarks register themselves from their own file:
+ *
+ *   static BenchmarkRegistry::Registrar<MyBenchmark> registrar("dsp/my-kernel");
+ */
+struct BenchmarkConfig
+{
+    int numChannels = 2;
+    int blockSize = 256;
+    double sampleRate = 48000.0;
+};
+
+class Benchmark
+{
+public:
+    virtual ~Benchmark() = default;
+
+    // Allocate and fill buffers for this configuration (not measured)
+    virtual void prepare(const BenchmarkConfig& config) = 0;
+
+    // One block of work; this is what gets timed
+    virtual void processBlock() = 0;
+
+    virtual void release() {}
+};
+
+class BenchmarkRegistry
+{
+public:
+    using Factory = std::function<std::unique_ptr<Benchmark>()>;
+
+    struct Entry
+    {
+        juce::String name;
+        Factory create;
+    };
+
+    static BenchmarkRegistry& getInstance();
+
+    void add(const juce::String& name, Factory factory);
+    const std::vector<Entry>& getEntries() const { return entries; }
+
+    template <typename BenchmarkType>
+    struct Registrar
+    {
+        explicit Registrar(const juce::String& name)
+        {
+            BenchmarkRegistry::getInstance().add(
+                name, [] { return std::make_unique<BenchmarkType>(); });
+        }
+    };
+
+private:
+    std::vector<Entry> entries;
+};
+
+struct BenchmarkResult
+{
+    juce::String name;
+    BenchmarkConfig config;
+
+    double nsPerSample = 0.0; // Per channel sample, best of all runs
+    double allocationsPerBlock = 0.0;
+    double cacheMissesPerBlock = -1.0; // -1 when perf counters are unavailable
+
+    juce::String getKey() const;
+    juce::var toVar() const;
+    static BenchmarkResult fromVar(const juce::var& value);
+};
+
+class BenchmarkRunner
+{
+public:
+    struct Matrix
+    {
+        juce::Array<int> channelCounts{1, 2, 8, 16, 32, 64};
+        juce::Array<int> blockSizes{32, 64, 128, 256, 512, 1024, 2048, 4096};
+        juce::Array<double> sampleRates{44100.0, 48000.0, 96000.0, 192000.0};
+
+        // Smaller matrix for quick local runs
+        static Matrix quick();
+    };
+
+    struct Options
+    {
+        Matrix matrix;
+        juce::String filter;         // Only run benchmarks whose name contains this
+        int numRuns = 7;             // Timing runs per configuration (best one is kept)
+        int samplesPerRun = 1 << 17; // Per channel; sets the blocks per run
+    };
+
+    explicit BenchmarkRunner(const Options& options);
+
+    // Runs every matching benchmark over the matrix, printing each result as it goes
+    std::vector<BenchmarkResult> run();
+
+    static BenchmarkResult measure(Benchmark& benchmark, const juce::String& name,
+                                   const BenchmarkConfig& config, int numRuns, int samplesPerRun);
+
+private:
+    const Options options;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BenchmarkRunner)
+};
+
+namespace BenchmarkResults
+{
+// Machine-readable results: {"label", "cpu", "timestamp", "results": [...]}
+juce::Result writeJSON(const std::vector<BenchmarkResult>& results, const juce::String& label,
+                       const juce::File& file);
+juce::Result readJSON(const juce::File& file, std::vector<BenchmarkResult>& results);
+
+// Prints the comparison and returns the number of regressions: a result slower than the
+// baseline by more than thresholdPercent, or allocating where the baseline did not
+int compare(const std::vector<BenchmarkResult>& baseline,
+            const std::vector<BenchmarkResult>& current, double thresholdPercent);
+} // namespace BenchmarkResults
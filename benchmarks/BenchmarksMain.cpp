@@ -0,0 +1,134 @@
+#include <JuceHeader.h>
+#include "BenchmarkHarness.h"
+
+#include <iostream>
+
+/**
+ * DAIW_benchmarks runs every registered benchmark over the configuration matrix.
+ *
+ *   DAIW_benchmarks [--quick] [--filter=<text>] [--channels=1,2,64] [--block-sizes=64,256]
+ *                   [--sample-rates=48000] [--runs=<n>] [--json=<file>] [--label=<text>]
+ *                   [--baseline=<file> [--threshold=<percent>]]
+ *
+ * With --baseline the exit code is 1 when any result regressed, so CI can run it
+ * against the previous commit's JSON.
+ */
+namespace
+{
+void printUsage()
+{
+    std::cout << "Usage: DAIW_benchmarks [options]\n"
+                 "  --quick                 Small matrix (2/64 channels, 32/256/4096, 48 kHz)\n"
+                 "  --filter=<text>         Only benchmarks whose name contains <text>\n"
+                 "  --channels=<list>       Comma-separated channel counts\n"
+                 "  --block-sizes=<list>    Comma-separated block sizes\n"
+                 "  --sample-rates=<list>   Comma-separated sample rates\n"
+                 "  --runs=<n>              Timing runs per configuration (default 7)\n"
+                 "  --json=<file>           Write machine-readable results\n"
+                 "  --label=<text>          Label stored in the JSON (e.g. a commit hash)\n"
+                 "  --baseline=<file>       Compare against earlier JSON results\n"
+                 "  --threshold=<percent>   Slowdown counted as a regression (default 10)\n"
+                 "  --list                  List registered benchmarks\n";
+}
+
+template <typename ValueType>
+juce::Array<ValueType> parseList(const juce::String& text)
+{
+    juce::Array<ValueType> values;
+    for (const auto& token : juce::StringArray::fromTokens(text, ",", {}))
+    {
+        values.add(static_cast<ValueType>(token.trim().getDoubleValue()));
+    }
+    return values;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    if (args.containsOption("--list"))
+    {
+        for (const auto& entry : BenchmarkRegistry::getInstance().getEntries())
+        {
+            std::cout << entry.name << std::endl;
+        }
+        return 0;
+    }
+
+    // Message manager for the engine's broadcasters; no window is ever created
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    BenchmarkRunner::Options options;
+
+    if (args.containsOption("--quick"))
+    {
+        options.matrix = BenchmarkRunner::Matrix::quick();
+    }
+
+    if (args.containsOption("--channels"))
+    {
+        options.matrix.channelCounts = parseList<int>(args.getValueForOption("--channels"));
+    }
+
+    if (args.containsOption("--block-sizes"))
+    {
+        options.matrix.blockSizes = parseList<int>(args.getValueForOption("--block-sizes"));
+    }
+
+    if (args.containsOption("--sample-rates"))
+    {
+        options.matrix.sampleRates = parseList<double>(args.getValueForOption("--sample-rates"));
+    }
+
+    if (args.containsOption("--runs"))
+    {
+        options.numRuns = juce::jmax(1, args.getValueForOption("--runs").getIntValue());
+    }
+
+    options.filter = args.getValueForOption("--filter");
+
+    BenchmarkRunner runner(options);
+    auto results = runner.run();
+
+    if (args.containsOption("--json"))
+    {
+        auto writeResult = BenchmarkResults::writeJSON(
+            results, args.getValueForOption("--label"), args.getFileForOption("--json"));
+
+        if (writeResult.failed())
+        {
+            std::cerr << writeResult.getErrorMessage() << std::endl;
+            return 1;
+        }
+    }
+
+    if (args.containsOption("--baseline"))
+    {
+        std::vector<BenchmarkResult> baseline;
+        auto readResult = BenchmarkResults::readJSON(args.getFileForOption("--baseline"), baseline);
+
+        if (readResult.failed())
+        {
+            std::cerr << readResult.getErrorMessage() << std::endl;
+            return 1;
+        }
+
+        auto threshold = args.containsOption("--threshold")
+                             ? args.getValueForOption("--threshold").getDoubleValue()
+                             : 10.0;
+
+        if (BenchmarkResults::compare(baseline, results, threshold) > 0)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <JuceHeader.h>
+#include "Audio/GarbageCollector.h"
+#include "Audio/Graph/MixGraph.h"
+#include "Audio/RealtimeThreadPool.h"
+#include "BenchmarkHarness.h"
+
+/**
+ * Mix graph benchmarks: a 100-track session of tone generators, rendered
+ * serially on the calling thread and in parallel on the real-time pool, with
+ * tracks going straight to the master or through group buses, and with tracks
+ * reporting latency so every path into a bus needs compensating.
+ */
+namespace
+{
+template <int numWorkers, int numBuses, int maxTrackLatency = 0>
+class TrackMixBenchmark : public Benchmark
+{
+public:
+    static constexpr int numTracks = 100;
+
+    TrackMixBenchmark()
+        : pool(numWorkers < 0 ? RealtimeThreadPool::getDefaultNumWorkers() : numWorkers),
+          graph(garbageCollector)
+    {
+        MixGraph::ScopedBatch batch(graph);
+        std::vector<MixGraph::NodeID> buses;
+
+        for (int i = 0; i < numBuses; ++i)
+        {
+            buses.push_back(graph.addBus("Bus " + juce::String(i + 1)));
+        }
+
+        for (int i = 0; i < numTracks; ++i)
+        {
+            auto tone = std::make_unique<juce::ToneGeneratorAudioSource>();
+            tone->setFrequency(110.0 + 10.0 * i);
+            tone->setAmplitude(0.01f);
+            auto track = graph.addTrack("Track " + juce::String(i + 1), std::move(tone));
+            graph.getTrack(track)->setLatencySamples((i * 37) % (maxTrackLatency + 1));
+
+            if (!buses.empty())
+            {
+                graph.setOutput(track, buses[static_cast<size_t>(i % numBuses)]);
+            }
+        }
+    }
+
+    void prepare(const BenchmarkConfig& config) override
+    {
+        buffer.setSize(config.numChannels, config.blockSize);
+        pool.prepare(config.sampleRate, config.blockSize);
+        graph.prepareToPlay(config.sampleRate, config.blockSize, config.numChannels);
+    }
+
+    void processBlock() override
+    {
+        buffer.clear();
+        graph.process(buffer, 0, buffer.getNumSamples(), pool);
+    }
+
+    void release() override
+    {
+        graph.releaseResources();
+        pool.stopWorkers();
+    }
+
+private:
+    RealtimeThreadPool pool;
+    GarbageCollector garbageCollector;
+    MixGraph graph;
+    juce::AudioBuffer<float> buffer;
+};
+
+BenchmarkRegistry::Registrar<TrackMixBenchmark<0, 0>> serialMix("graph/100-tracks-serial");
+BenchmarkRegistry::Registrar<TrackMixBenchmark<-1, 0>> parallelMix("graph/100-tracks-parallel");
+BenchmarkRegistry::Registrar<TrackMixBenchmark<-1, 8>> busMix("graph/100-tracks-8-buses-parallel");
+BenchmarkRegistry::Registrar<TrackMixBenchmark<-1, 8, 2048>>
+    compensatedMix("graph/100-tracks-8-buses-compensated");
+} // namespace
@@ -0,0 +1,134 @@
+#include <JuceHeader.h>
+#include "UI/Components/LevelMeter.h"
+#include "UI/FrameScheduler.h"
+
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+/**
+ * Meter rendering benchmark.
+ *
+ * A 64-channel mixer strip of stereo meters is driven through a FrameScheduler
+ * at 60 fps with moving levels, and each frame's repainted area is rendered
+ * with the software renderer into an offscreen image. Reports the share of one
+ * core that rendering at 60 fps takes, for the incremental repaints and for
+ * redrawing the whole mixer every frame.
+ */
+namespace
+{
+constexpr int numChannels = 64;
+constexpr int frameRate = 60;
+constexpr int numFrames = frameRate * 10;
+
+class Mixer : public juce::Component
+{
+public:
+    Mixer() : scheduler(*this)
+    {
+        for (int i = 0; i < numChannels; ++i)
+        {
+            auto meter = std::make_unique<StereoLevelMeter>();
+            meter->setScheduler(&scheduler);
+            addAndMakeVisible(*meter);
+            meters.push_back(std::move(meter));
+        }
+
+        setSize(numChannels * 24, 300);
+    }
+
+    void resized() override
+    {
+        auto bounds = getLocalBounds();
+
+        for (auto& meter : meters)
+        {
+            meter->setBounds(bounds.removeFromLeft(24).reduced(2));
+        }
+    }
+
+    // Levels that keep every meter moving: a slow swell per channel with transients on top
+    void setLevels(int frame)
+    {
+        auto t = frame / (double) frameRate;
+
+        for (size_t i = 0; i < meters.size(); ++i)
+        {
+            auto phase = t * (0.3 + 0.05 * (double) i);
+            auto swell = (float) (0.5 + 0.5 * std::sin(phase * juce::MathConstants<double>::twoPi));
+            auto hit = (frame + (int) i * 7) % 23 == 0;
+
+            MeterFrame meterFrame;
+            for (int channel = 0; channel < MeterFrame::maxChannels; ++channel)
+            {
+                meterFrame.rms[channel] = swell * (channel == 0 ? 0.5f : 0.4f);
+                meterFrame.truePeak[channel] = hit ? 0.9f : meterFrame.rms[channel] * 1.4f;
+            }
+            meters[i]->setLevels(meterFrame);
+        }
+    }
+
+    FrameScheduler scheduler;
+
+private:
+    std::vector<std::unique_ptr<StereoLevelMeter>> meters;
+};
+
+// Seconds spent rendering numFrames frames
+double renderFrames(Mixer& mixer, bool incremental)
+{
+    juce::Image image(juce::Image::RGB, mixer.getWidth(), mixer.getHeight(), true,
+                      juce::SoftwareImageType());
+
+    // First paint renders the cached images; not part of the steady state
+    {
+        juce::Graphics g(image);
+        mixer.paintEntireComponent(g, false);
+    }
+
+    auto start = juce::Time::getHighResolutionTicks();
+
+    for (int frame = 0; frame < numFrames; ++frame)
+    {
+        mixer.setLevels(frame);
+        mixer.scheduler.renderFrame(1.0 / frameRate);
+
+        juce::Graphics g(image);
+
+        if (incremental)
+        {
+            g.reduceClipRegion(mixer.scheduler.getLastRepaintedArea());
+        }
+
+        mixer.paintEntireComponent(g, false);
+    }
+
+    return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() -
+                                                    start);
+}
+} // namespace
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+    // Components need the message manager; nothing is ever put on screen
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    Mixer mixer;
+
+    std::cout << numChannels << " stereo meters, " << frameRate
+              << " fps, software renderer (% of one core)" << std::endl;
+
+    for (auto incremental : {true, false})
+    {
+        auto seconds = renderFrames(mixer, incremental);
+        auto msPerFrame = 1000.0 * seconds / numFrames;
+        auto corePercent = 100.0 * seconds / (numFrames / (double) frameRate);
+
+        std::cout << (incremental ? "changed strips\t" : "full redraw\t")
+                  << juce::String(msPerFrame, 3) << " ms/frame\t" << juce::String(corePercent, 2)
+                  << "%" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,289 @@
+#include <JuceHeader.h>
+#include "Audio/Midi/MidiInputQueue.h"
+#include "Audio/Midi/MidiPlayer.h"
+#include "Audio/Session/SessionPublisher.h"
+#include "Audio/Transport.h"
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+/**
+ * MIDI timing benchmark.
+ *
+ * Sequencer: a dense, overlapping set of clips is played through MidiPlayer in
+ * segments from random positions (a seek before each), and every event that
+ * comes out must land on exactly its timeline sample.
+ *
+ * Live input: ten minutes of a simulated device whose clock runs 50 ppm fast
+ * against the system clock, with each callback woken up to 250 us late, and
+ * notes stamped at random times between callbacks. Reports how far each note
+ * lands from where it was played (less the queue's constant latency) once
+ * the clock has had a minute to lock, in samples and including the rounding
+ * to whole samples, next to placing every note at the start of the block, as
+ * a plain block-by-block merge would.
+ *
+ * Exits with 1 if the sequencer is off by any amount or live input jitters by
+ * a sample or more (RMS).
+ */
+namespace
+{
+constexpr double sampleRate = 48000.0;
+constexpr RoutingGraph::NodeID trackId = 2;
+
+struct Deviation
+{
+    double rms = 0.0;
+    double max = 0.0;
+};
+
+// Spread of errors around their mean (the mean itself is latency, not jitter)
+Deviation measureDeviation(const std::vector<double>& errors)
+{
+    Deviation deviation;
+
+    if (errors.empty())
+    {
+        return deviation;
+    }
+
+    double mean = 0.0;
+
+    for (auto error : errors)
+    {
+        mean += error;
+    }
+
+    mean /= static_cast<double>(errors.size());
+
+    for (auto error : errors)
+    {
+        deviation.rms += (error - mean) * (error - mean);
+        deviation.max = juce::jmax(deviation.max, std::abs(error - mean));
+    }
+
+    deviation.rms = std::sqrt(deviation.rms / static_cast<double>(errors.size()));
+    return deviation;
+}
+
+std::vector<MidiClip> createClips(juce::Random& random)
+{
+    std::vector<MidiClip> clips;
+    auto clipLength = static_cast<juce::int64>(sampleRate * 30.0);
+
+    for (int i = 0; i < 8; ++i)
+    {
+        MidiClip clip;
+        clip.timelineStart = static_cast<juce::int64>(i) * clipLength / 2;
+        clip.length = clipLength;
+
+        for (double time = 0.0; time < static_cast<double>(clipLength);
+             time += 1.0 + random.nextInt(2000))
+        {
+            auto channel = 1 + random.nextInt(16);
+            auto note = random.nextInt(128);
+
+            if (random.nextInt(20) == 0)
+            {
+                auto controller = juce::MidiMessage::controllerEvent(channel, random.nextInt(120),
+                                                                     random.nextInt(128));
+                clip.events.addEvent(controller, time);
+            }
+            else if (random.nextInt(200) == 0)
+            {
+                const juce::uint8 data[] = {0x7d, 0x01, 0x02, 0x03};
+                clip.events.addEvent(juce::MidiMessage::createSysExMessage(data, 4), time);
+            }
+            else
+            {
+                auto noteOn = juce::MidiMessage::noteOn(channel, note, juce::uint8(100));
+                clip.events.addEvent(noteOn, time);
+                clip.events.addEvent(juce::MidiMessage::noteOff(channel, note),
+                                     time + random.nextInt(96000));
+            }
+        }
+
+        clips.push_back(std::move(clip));
+    }
+
+    return clips;
+}
+
+// Returns the largest distance, in samples, between an event and its timeline position, or -1
+// if events went missing or came out in the wrong order
+juce::int64 measureSequencer(int blockSize, juce::Random& random, int& numEvents)
+{
+    auto clips = createClips(random);
+    auto sequence = MidiSequence::compile(clips);
+
+    Transport transport;
+    MidiInputQueue liveInput(16);
+    GarbageCollector garbageCollector;
+    SessionPublisher session(garbageCollector);
+    MidiPlayer player(session, trackId, transport, liveInput);
+    player.setSequence(sequence);
+
+    // As the engine does at the start of each block
+    auto startBlock = [&]
+    {
+        transport.advance(blockSize);
+        session.acquire();
+    };
+
+    juce::MidiBuffer midi;
+    midi.ensureSize(1 << 16);
+
+    auto length = sequence->getEvent(sequence->getNumEvents() - 1).time + 1;
+    juce::int64 maxError = 0;
+    numEvents = 0;
+
+    for (int segment = 0; segment < 50; ++segment)
+    {
+        // Stop first, so the notes released on the way out aren't counted
+        transport.stop();
+        startBlock();
+        player.renderBlock(midi, blockSize);
+
+        auto start = static_cast<juce::int64>(random.nextDouble() * static_cast<double>(length));
+        auto end = start + static_cast<juce::int64>(sampleRate * (1.0 + random.nextInt(20)));
+        auto expected = sequence->findFirstEventAt(start);
+
+        transport.setPosition(start);
+        transport.play();
+
+        do
+        {
+            startBlock();
+            player.renderBlock(midi, blockSize);
+
+            for (const auto metadata : midi)
+            {
+                if (expected >= sequence->getNumEvents())
+                {
+                    return -1;
+                }
+
+                const auto& event = sequence->getEvent(expected++);
+                auto position = transport.getBlockPosition() + metadata.samplePosition;
+
+                if (metadata.numBytes != static_cast<int>(event.size) ||
+                    std::memcmp(metadata.data, sequence->getData(event), event.size) != 0)
+                {
+                    return -1;
+                }
+
+                maxError = juce::jmax(maxError, std::abs(position - event.time));
+                ++numEvents;
+            }
+        } while (transport.getBlockPosition() + blockSize < end);
+
+        // Everything due before the block that ended the segment must have come out
+        if (expected < sequence->getNumEvents() &&
+            sequence->getEvent(expected).time < transport.getBlockPosition() + blockSize)
+        {
+            return -1;
+        }
+    }
+
+    return maxError;
+}
+
+struct LiveResult
+{
+    Deviation placed;
+    Deviation blockStart;
+    int numEvents = 0;
+};
+
+LiveResult measureLiveInput(int blockSize, juce::Random& random)
+{
+    constexpr double simulatedSeconds = 600.0;
+    constexpr double lockSeconds = 60.0;
+    constexpr double maxLateness = 0.00025;
+    constexpr double deviceRate = sampleRate * (1.0 + 50.0e-6); // Samples per system second
+
+    MidiInputQueue queue;
+    queue.prepare(sampleRate, blockSize);
+
+    // Simulated time ends in the past, as real timestamps do
+    auto origin = juce::Time::getMillisecondCounterHiRes() * 0.001 - simulatedSeconds - 1.0;
+    auto nextNote = origin;
+    std::vector<double> sent;
+    size_t numReceived = 0;
+    std::vector<double> placed, blockStart;
+
+    for (juce::int64 block = 0;; ++block)
+    {
+        auto blockSample = block * blockSize;
+        auto blockTime = static_cast<double>(blockSample) / deviceRate;
+
+        if (blockTime > simulatedSeconds)
+        {
+            break;
+        }
+
+        auto callbackTime = origin + blockTime + random.nextDouble() * maxLateness;
+
+        // Notes played before the callback woke up
+        while (nextNote < callbackTime)
+        {
+            auto note = juce::MidiMessage::noteOn(1, 60, juce::uint8(100));
+            note.setTimeStamp(nextNote);
+            queue.push(note);
+            sent.push_back(nextNote);
+            nextNote += 0.001 + random.nextDouble() * 0.02;
+        }
+
+        queue.collect(callbackTime, blockSize);
+
+        for (const auto metadata : queue.getBlock())
+        {
+            auto playedAt = (sent[numReceived++] - origin) * deviceRate;
+
+            if (playedAt > lockSeconds * sampleRate)
+            {
+                placed.push_back(static_cast<double>(blockSample + metadata.samplePosition) -
+                                 playedAt);
+                blockStart.push_back(static_cast<double>(blockSample) - playedAt);
+            }
+        }
+    }
+
+    LiveResult result;
+    result.placed = measureDeviation(placed);
+    result.blockStart = measureDeviation(blockStart);
+    result.numEvents = static_cast<int>(placed.size());
+    return result;
+}
+} // namespace
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+    juce::Random random(0x44414957);
+    const int blockSizes[] = {32, 64, 128, 256, 441, 512, 1024, 2048, 4096};
+    bool passed = true;
+
+    std::cout << "MIDI timing at " << sampleRate << " Hz (samples)" << std::endl;
+    std::cout << "block\tsequencer events\tmax error\tlive events\trms\tmax"
+              << "\tblock-start rms\tmax" << std::endl;
+
+    for (auto blockSize : blockSizes)
+    {
+        int numSequencerEvents = 0;
+        auto sequencerError = measureSequencer(blockSize, random, numSequencerEvents);
+        auto live = measureLiveInput(blockSize, random);
+
+        std::cout << blockSize << "\t" << numSequencerEvents << "\t\t\t"
+                  << (sequencerError < 0 ? juce::String("MISMATCH")
+                                         : juce::String(sequencerError))
+                  << "\t\t" << live.numEvents << "\t\t" << juce::String(live.placed.rms, 3)
+                  << "\t" << juce::String(live.placed.max, 3) << "\t"
+                  << juce::String(live.blockStart.rms, 1) << "\t\t"
+                  << juce::String(live.blockStart.max, 1) << std::endl;
+
+        passed = passed && sequencerError == 0 && live.placed.rms < 1.0;
+    }
+
+    return passed ? 0 : 1;
+}
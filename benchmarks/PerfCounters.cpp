@@ -0,0 +1,63 @@
+#include "PerfCounters.h"
+
+#if JUCE_LINUX
+ #include <linux/perf_event.h>
+ #include <sys/ioctl.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+#endif
+
+PerfCounters::PerfCounters()
+{
+#if JUCE_LINUX
+    perf_event_attr attributes{};
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.size = sizeof(attributes);
+    attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+    attributes.disabled = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+
+    // This thread, any CPU, no group
+    fileDescriptor = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+#if JUCE_LINUX
+    if (fileDescriptor >= 0)
+    {
+        close(fileDescriptor);
+    }
+#endif
+}
+
+void PerfCounters::start() noexcept
+{
+#if JUCE_LINUX
+    if (fileDescriptor >= 0)
+    {
+        ioctl(fileDescriptor, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fileDescriptor, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+juce::int64 PerfCounters::stop() noexcept
+{
+#if JUCE_LINUX
+    if (fileDescriptor >= 0)
+    {
+        ioctl(fileDescriptor, PERF_EVENT_IOC_DISABLE, 0);
+
+        juce::uint64 count = 0;
+        if (read(fileDescriptor, &count, sizeof(count)) == static_cast<ssize_t>(sizeof(count)))
+        {
+            return static_cast<juce::int64>(count);
+        }
+    }
+#endif
+
+    return -1;
+}
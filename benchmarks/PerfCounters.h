@@ -0,0 +1,29 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * PerfCounters reads hardware cache-miss counters for the calling thread.
+ *
+ * Uses perf_event_open on Linux. Elsewhere, or when the kernel refuses
+ * (containers, perf_event_paranoid > 2), isAvailable() is false and results
+ * report no cache-miss data rather than failing the run.
+ */
+class PerfCounters
+{
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    bool isAvailable() const { return fileDescriptor >= 0; }
+
+    void start() noexcept;
+
+    // Cache misses since start(), or -1 when counters are unavailable
+    juce::int64 stop() noexcept;
+
+private:
+    int fileDescriptor = -1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PerfCounters)
+};
@@ -0,0 +1,210 @@
+#include "AudioCallbackProfiler.h"
+
+//==============================================================================
+// LockFreeHistogram
+//==============================================================================
+
+LockFreeHistogram::LockFreeHistogram(double width, int size)
+    : bucketWidth(width), numBuckets(size),
+      buckets(std::make_unique<std::atomic<juce::uint32>[]>(static_cast<size_t>(size) + 1))
+{
+    clear();
+}
+
+void LockFreeHistogram::add(double value) noexcept
+{
+    auto index = juce::jlimit(0, numBuckets, static_cast<int>(value / bucketWidth));
+
+    // Single writer, so a relaxed load/store pair is enough and avoids a locked RMW
+    auto& bucket = buckets[static_cast<size_t>(index)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    if (value > maximum.load(std::memory_order_relaxed))
+    {
+        maximum.store(value, std::memory_order_relaxed);
+    }
+
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void LockFreeHistogram::clear() noexcept
+{
+    for (int i = 0; i <= numBuckets; ++i)
+    {
+        buckets[static_cast<size_t>(i)].store(0, std::memory_order_relaxed);
+    }
+
+    maximum.store(0.0, std::memory_order_relaxed);
+    count.store(0, std::memory_order_release);
+}
+
+double LockFreeHistogram::getPercentile(double percentile) const noexcept
+{
+    auto total = count.load(std::memory_order_acquire);
+
+    if (total <= 0)
+    {
+        return 0.0;
+    }
+
+    auto rank = static_cast<juce::int64>(std::ceil(percentile / 100.0 * static_cast<double>(total)));
+    juce::int64 seen = 0;
+
+    for (int i = 0; i < numBuckets; ++i)
+    {
+        seen += buckets[static_cast<size_t>(i)].load(std::memory_order_relaxed);
+
+        if (seen >= rank)
+        {
+            return juce::jmin((i + 1) * bucketWidth, getMaximum());
+        }
+    }
+
+    // Landed in the overflow bucket
+    return getMaximum();
+}
+
+//==============================================================================
+// AudioCallbackProfiler::Stats
+//==============================================================================
+
+juce::var AudioCallbackProfiler::Stats::toVar() const
+{
+    auto distributionToVar = [](const Distribution& distribution)
+    {
+        auto* object = new juce::DynamicObject();
+        object->setProperty("p50", distribution.p50);
+        object->setProperty("p99", distribution.p99);
+        object->setProperty("max", distribution.max);
+        return juce::var(object);
+    };
+
+    auto* object = new juce::DynamicObject();
+    object->setProperty("sampleRate", sampleRate);
+    object->setProperty("blockSize", blockSize);
+    object->setProperty("callbacks", callbacks);
+    object->setProperty("lateCallbacks", lateCallbacks);
+    object->setProperty("missedCallbacks", missedCallbacks);
+    object->setProperty("deviceXRuns", deviceXRuns);
+    object->setProperty("diskUnderruns", diskUnderruns);
+    object->setProperty("averageLoad", averageLoad);
+    object->setProperty("peakLoad", peakLoad);
+    object->setProperty("load", distributionToVar(load));
+    object->setProperty("durationMs", distributionToVar(durationMs));
+    object->setProperty("intervalMs", distributionToVar(intervalMs));
+    return juce::var(object);
+}
+
+juce::String AudioCallbackProfiler::Stats::toJSON() const
+{
+    return juce::JSON::toString(toVar());
+}
+
+//==============================================================================
+// AudioCallbackProfiler
+//==============================================================================
+
+AudioCallbackProfiler::AudioCallbackProfiler()
+    : ticksToSeconds(1.0 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond())),
+      loadHistogram(0.005, 400), durationHistogram(0.00001, 2000),
+      intervalHistogram(0.00001, 5000)
+{
+}
+
+void AudioCallbackProfiler::prepare(double newSampleRate, int newBlockSize)
+{
+    sampleRate.store(newSampleRate);
+    blockSize.store(newBlockSize);
+
+    startTicks = 0;
+    previousStartTicks = 0;
+    previousPeriodSeconds = 0.0;
+    currentPeriodSeconds = 0.0;
+
+    callbacks.store(0);
+    lateCallbacks.store(0);
+    missedCallbacks.store(0);
+    averageLoad.store(0.0);
+    peakLoad.store(0.0);
+
+    loadHistogram.clear();
+    durationHistogram.clear();
+    intervalHistogram.clear();
+}
+
+void AudioCallbackProfiler::callbackStarted(int numSamples) noexcept
+{
+    startTicks = juce::Time::getHighResolutionTicks();
+
+    auto rate = sampleRate.load(std::memory_order_relaxed);
+    currentPeriodSeconds = rate > 0.0 ? numSamples / rate : 0.0;
+
+    if (previousStartTicks != 0 && previousPeriodSeconds > 0.0)
+    {
+        auto interval = static_cast<double>(startTicks - previousStartTicks) * ticksToSeconds;
+        intervalHistogram.add(interval);
+
+        // The device should call back once per period; a much longer gap means we
+        // (or the driver) missed the deadline and the periods in between were lost
+        if (interval > previousPeriodSeconds * 1.5)
+        {
+            lateCallbacks.fetch_add(1, std::memory_order_relaxed);
+
+            auto skipped = juce::roundToInt(interval / previousPeriodSeconds) - 1;
+            missedCallbacks.fetch_add(juce::jmax(0, skipped), std::memory_order_relaxed);
+        }
+    }
+
+    previousStartTicks = startTicks;
+    previousPeriodSeconds = currentPeriodSeconds;
+}
+
+void AudioCallbackProfiler::callbackFinished() noexcept
+{
+    auto duration =
+        static_cast<double>(juce::Time::getHighResolutionTicks() - startTicks) * ticksToSeconds;
+    durationHistogram.add(duration);
+
+    if (currentPeriodSeconds > 0.0)
+    {
+        auto load = duration / currentPeriodSeconds;
+        loadHistogram.add(load);
+
+        // Smoothed over roughly the last hundred callbacks
+        auto smoothed = averageLoad.load(std::memory_order_relaxed);
+        averageLoad.store(smoothed + (load - smoothed) * 0.01, std::memory_order_relaxed);
+
+        if (load > peakLoad.load(std::memory_order_relaxed))
+        {
+            peakLoad.store(load, std::memory_order_relaxed);
+        }
+    }
+
+    callbacks.fetch_add(1, std::memory_order_relaxed);
+}
+
+AudioCallbackProfiler::Distribution
+AudioCallbackProfiler::getDistribution(const LockFreeHistogram& histogram, double scale)
+{
+    Distribution distribution;
+    distribution.p50 = histogram.getPercentile(50.0) * scale;
+    distribution.p99 = histogram.getPercentile(99.0) * scale;
+    distribution.max = histogram.getMaximum() * scale;
+    return distribution;
+}
+
+AudioCallbackProfiler::Stats AudioCallbackProfiler::getStats() const
+{
+    Stats stats;
+    stats.sampleRate = sampleRate.load();
+    stats.blockSize = blockSize.load();
+    stats.callbacks = callbacks.load();
+    stats.lateCallbacks = lateCallbacks.load();
+    stats.missedCallbacks = missedCallbacks.load();
+    stats.averageLoad = averageLoad.load();
+    stats.peakLoad = peakLoad.load();
+    stats.load = getDistribution(loadHistogram, 1.0);
+    stats.durationMs = getDistribution(durationHistogram, 1000.0);
+    stats.intervalMs = getDistribution(intervalHistogram, 1000.0);
+    return stats;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+
+/**
+ * LockFreeHistogram counts values into fixed-width buckets.
+ *
+ * One writer (the audio thread) adds values without locking or allocating;
+ * any other thread can read percentiles at the same time. Values past the
+ * last bucket land in an overflow bucket and are still tracked by the maximum.
+ */
+class LockFreeHistogram
+{
+public:
+    LockFreeHistogram(double bucketWidth, int numBuckets);
+
+    // Writer thread only
+    void add(double value) noexcept;
+    void clear() noexcept;
+
+    // Any thread. Percentiles are quantised to the upper edge of their bucket.
+    double getPercentile(double percentile) const noexcept;
+    double getMaximum() const noexcept { return maximum.load(std::memory_order_relaxed); }
+    juce::int64 getCount() const noexcept { return count.load(std::memory_order_relaxed); }
+
+private:
+    const double bucketWidth;
+    const int numBuckets;
+    std::unique_ptr<std::atomic<juce::uint32>[]> buckets; // numBuckets + 1 (overflow)
+    std::atomic<double> maximum{0.0};
+    std::atomic<juce::int64> count{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LockFreeHistogram)
+};
+
+/**
+ * AudioCallbackProfiler instruments the audio callback.
+ *
+ * Every callback is timestamped with the monotonic high resolution clock.
+ * From that it derives DSP load (time spent / buffer period), detects
+ * callbacks that arrive late or skip whole periods, and keeps histograms of
+ * callback duration, callback interval and load. All writes happen on the
+ * audio thread without locks; getStats() can be called from the message thread.
+ */
+class AudioCallbackProfiler
+{
+public:
+    struct Distribution
+    {
+        double p50 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+
+    struct Stats
+    {
+        double sampleRate = 0.0;
+        int blockSize = 0;
+
+        juce::int64 callbacks = 0;
+        juce::int64 lateCallbacks = 0;   // Started more than 1.5 periods after the previous one
+        juce::int64 missedCallbacks = 0; // Whole periods skipped by late callbacks
+        int deviceXRuns = -1;            // Reported by the driver, -1 if unsupported
+        juce::int64 diskUnderruns = 0;   // Blocks where a streamed clip had no data ready
+
+        double averageLoad = 0.0; // Fractions of the buffer period
+        double peakLoad = 0.0;
+
+        Distribution load;
+        Distribution durationMs;
+        Distribution intervalMs;
+
+        juce::var toVar() const;
+        juce::String toJSON() const;
+    };
+
+    AudioCallbackProfiler();
+
+    // Resets all counters for a new device configuration (call while callbacks are stopped)
+    void prepare(double sampleRate, int blockSize);
+
+    // Audio thread
+    void callbackStarted(int numSamples) noexcept;
+    void callbackFinished() noexcept;
+
+    // Any thread
+    Stats getStats() const;
+
+    /** Brackets one audio callback. */
+    class ScopedCallback
+    {
+    public:
+        ScopedCallback(AudioCallbackProfiler& p, int numSamples) noexcept : profiler(p)
+        {
+            profiler.callbackStarted(numSamples);
+        }
+
+        ~ScopedCallback() noexcept { profiler.callbackFinished(); }
+
+    private:
+        AudioCallbackProfiler& profiler;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedCallback)
+    };
+
+private:
+    static Distribution getDistribution(const LockFreeHistogram& histogram, double scale);
+
+    std::atomic<double> sampleRate{0.0};
+    std::atomic<int> blockSize{0};
+    double ticksToSeconds = 0.0;
+
+    // Audio thread state
+    juce::int64 startTicks = 0;
+    juce::int64 previousStartTicks = 0;
+    double previousPeriodSeconds = 0.0;
+    double currentPeriodSeconds = 0.0;
+
+    // Shared results
+    std::atomic<juce::int64> callbacks{0};
+    std::atomic<juce::int64> lateCallbacks{0};
+    std::atomic<juce::int64> missedCallbacks{0};
+    std::atomic<double> averageLoad{0.0};
+    std::atomic<double> peakLoad{0.0};
+
+    LockFreeHistogram loadHistogram;     // Fraction of period, 0.5% buckets up to 200%
+    LockFreeHistogram durationHistogram; // Seconds, 10 us buckets up to 20 ms
+    LockFreeHistogram intervalHistogram; // Seconds, 10 us buckets up to 50 ms
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioCallbackProfiler)
+};
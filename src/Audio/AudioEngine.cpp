@@ -1,39 +1,137 @@
 #include "AudioEngine.h"
-
-AudioEngine::AudioEngine()
+#include "VirtualAudioDevice.h"
+
+AudioEngine::AudioEngine(DeviceMode mode)
+    : reconfigurer(deviceManager, sourcePlayer, deviceLock),
+      deviceRegistry(deviceManager, deviceLock),
+      deviceMode(mode),
+      diskStreamer(transport),
+      mixGraph(garbageCollector),
+      session(garbageCollector)
 {
-    // Initialize with default audio device
-    auto result = deviceManager.initialiseWithDefaultDevices(2, 2);
+    // Connect the source player to this AudioSource
+    sourcePlayer.setSource(this);
+
+    if (deviceMode == DeviceMode::offline)
+    {
+        DBG("AudioEngine: Offline mode, no audio device opened");
+
+        // Renders aren't real time, so mismatched clips get the best conversion
+        diskStreamer.setResamplerQuality(PolyphaseResampler::Quality::high);
+        return;
+    }
+
+    // Disk read-ahead (offline renders service the streams before each block instead)
+    diskStreamer.start();
+
+    // Device state and measured latencies, kept across sessions
+    juce::PropertiesFile::Options storeOptions;
+    storeOptions.applicationName = "Engine";
+    storeOptions.folderName = "DAIW";
+    storeOptions.filenameSuffix = ".settings";
+    storeOptions.osxLibrarySubFolder = "Application Support";
+    storeOptions.storageFormat = juce::PropertiesFile::storeAsXML;
+    settings = std::make_unique<juce::PropertiesFile>(storeOptions);
+    startupTrace.mark("settings");
+
+    // Create the platform device types first (the manager only creates them while it
+    // has none), then add the virtual device so it is always selectable
+    deviceManager.getAvailableDeviceTypes();
+    deviceManager.addAudioDeviceType(std::make_unique<VirtualAudioIODeviceType>(
+        VirtualAudioIODeviceType::Options::fromEnvironment()));
+    startupTrace.mark("device types");
+
+    // One open: last session's setup if it still opens, otherwise the default device
+    // with a low-latency buffer (~5 ms at 48 kHz)
+    auto savedState = settings->getXmlValue("deviceState");
+    juce::AudioDeviceManager::AudioDeviceSetup preferredSetup;
+    preferredSetup.bufferSize = 256;
+
+    auto result = deviceManager.initialise(2, 2, savedState.get(), true, {}, &preferredSetup);
+
+    // No hardware (e.g. a headless Linux box): fall back to the virtual device
+    if (result.isNotEmpty() || deviceManager.getCurrentAudioDevice() == nullptr)
+    {
+        DBG("AudioEngine: No hardware device (" + result + "), using virtual device");
+        deviceManager.setCurrentAudioDeviceType(VirtualAudioIODeviceType::typeName, true);
+        result = deviceManager.getCurrentAudioDevice() != nullptr ? juce::String()
+                                                                  : "No audio device available";
+    }
 
     if (result.isNotEmpty())
     {
         DBG("AudioEngine: Failed to initialize audio devices: " + result);
     }
-    else
+
+    startupTrace.mark(savedState != nullptr ? "device open (saved)" : "device open (default)");
+
+    // Device lists and capabilities are cached from here on, and kept current on hot-plug;
+    // last session's list stands in until the first scan reports what changed since
+    if (auto savedDevices = settings->getXmlValue("deviceList"))
+    {
+        deviceRegistry.restoreFromXml(*savedDevices);
+    }
+
+    // Live MIDI from every input the device manager has enabled
+    deviceManager.addMidiInputDeviceCallback({}, &midiInput);
+
+    deviceRegistry.start();
+    deviceRegistry.addListener(this);
+    reconfigurer.addListener(this);
+
+    startupTrace.mark("engine");
+    startupTrace.reportOnFirstCallback();
+}
+
+AudioEngine::~AudioEngine()
+{
+    stop();
+    sourcePlayer.setSource(nullptr);
+
+    if (settings != nullptr)
+    {
+        deviceManager.removeMidiInputDeviceCallback({}, &midiInput);
+        reconfigurer.removeListener(this);
+        deviceRegistry.removeListener(this);
+        saveDeviceState();
+    }
+}
+
+void AudioEngine::saveDeviceState()
+{
+    // Mid-change the setup is half applied (and the worker owns the device manager), so
+    // keep the last saved one: the change saves again once it reaches 'running'
+    if (!reconfigurer.isBusy())
     {
-        // Try to set a lower buffer size for reduced latency
-        auto setup = deviceManager.getAudioDeviceSetup();
-        setup.bufferSize = 256; // Lower latency (~5ms at 48kHz)
-        auto bufferResult = deviceManager.setAudioDeviceSetup(setup, true);
+        std::unique_ptr<juce::XmlElement> state;
 
-        if (bufferResult.isNotEmpty())
         {
-            DBG("AudioEngine: Could not set preferred buffer size: " + bufferResult);
+            const juce::ScopedLock sl(deviceLock);
+            state = deviceManager.createStateXml();
         }
-        else
+
+        // Nothing to save until a device has been chosen here (or restored from a save)
+        if (state != nullptr)
         {
-            DBG("AudioEngine: Set buffer size to 256 samples for lower latency");
+            settings->setValue("deviceState", state.get());
         }
     }
 
-    // Connect the source player to this AudioSource
-    sourcePlayer.setSource(this);
+    settings->setValue("deviceList", deviceRegistry.createXml().get());
+    settings->saveIfNeeded();
 }
 
-AudioEngine::~AudioEngine()
+void AudioEngine::deviceReconfigurationChanged(const DeviceReconfigurer::Progress& progress)
 {
-    stop();
-    sourcePlayer.setSource(nullptr);
+    if (progress.state == DeviceReconfigurer::State::running)
+    {
+        saveDeviceState();
+    }
+}
+
+void AudioEngine::deviceListChanged(const DeviceRegistry::Diff& /*diff*/)
+{
+    saveDeviceState();
 }
 
 void AudioEngine::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
@@ -41,87 +139,172 @@ void AudioEngine::prepareToPlay(int samplesPerBlockExpected, double sampleRate)
     currentSampleRate = sampleRate;
     currentBufferSize = samplesPerBlockExpected;
 
+    if (auto* device = deviceManager.getCurrentAudioDevice())
+    {
+        activeInputChannels = device->getActiveInputChannels();
+    }
+    else if (deviceMode == DeviceMode::offline)
+    {
+        activeInputChannels.clear();
+        activeInputChannels.setRange(0, maxOfflineChannels, true);
+    }
+    else
+    {
+        activeInputChannels.clear();
+    }
+
+    callbackProfiler.prepare(sampleRate, samplesPerBlockExpected);
+    threadPool.prepare(sampleRate, samplesPerBlockExpected);
+    diskStreamer.prepare(sampleRate);
+    recorder.prepare(sampleRate);
+    midiInput.prepare(sampleRate, samplesPerBlockExpected);
+    mixGraph.prepareToPlay(sampleRate, samplesPerBlockExpected, MixGraph::numMixChannels);
+    inputMeterKernel.prepare(MeterFrame::maxChannels);
+    outputMeterKernel.prepare(MeterFrame::maxChannels);
+
     DBG("AudioEngine: Prepared to play - Sample rate: " + juce::String(sampleRate) +
         ", Buffer size: " + juce::String(samplesPerBlockExpected));
 }
 
 void AudioEngine::releaseResources()
 {
+    mixGraph.releaseResources();
     DBG("AudioEngine: Released resources");
 }
 
 void AudioEngine::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
 {
-    auto* device = deviceManager.getCurrentAudioDevice();
+    AudioCallbackProfiler::ScopedCallback profile(callbackProfiler, bufferToFill.numSamples);
+    startupTrace.audioCallbackStarted();
+
+    auto timestamp = juce::Time::getHighResolutionTicks();
+    auto callbackTime = juce::Time::getMillisecondCounterHiRes() * 0.001;
+    auto numChannels = bufferToFill.buffer->getNumChannels();
 
-    if (device == nullptr)
+    // A latency measurement owns the device while it runs: test signal out, loopback in
+    if (latencyCalibrator.process(*bufferToFill.buffer, bufferToFill.startSample,
+                                  bufferToFill.numSamples))
     {
-        bufferToFill.clearActiveBufferRegion();
-        inputLevelLeft.store(0.0f);
-        inputLevelRight.store(0.0f);
-        outputLevelLeft.store(0.0f);
-        outputLevelRight.store(0.0f);
+        pushSilentMeterFrame(inputMeterFifo, bufferToFill.numSamples, timestamp);
+        pushMeterFrame(outputMeterFifo, outputMeterKernel, bufferToFill, timestamp);
         return;
     }
 
-    auto activeInputChannels = device->getActiveInputChannels();
-    auto numChannels = bufferToFill.buffer->getNumChannels();
+    // Fix the playhead and the session version for this block before anything renders
+    transport.advance(bufferToFill.numSamples);
+    session.acquire();
 
-    // Calculate input levels (RMS)
-    if (numChannels > 0 && activeInputChannels[0])
+    if (deviceMode == DeviceMode::offline)
     {
-        auto level = bufferToFill.buffer->getRMSLevel(0, bufferToFill.startSample,
-                                                       bufferToFill.numSamples);
-        inputLevelLeft.store(level);
+        // No deadline here, so wait for the disk rather than underrun
+        diskStreamer.serviceStreams();
     }
     else
     {
-        inputLevelLeft.store(0.0f);
+        // Live MIDI that arrived during the last block, at the offsets it arrived at
+        midiInput.collect(callbackTime, bufferToFill.numSamples);
     }
 
-    if (numChannels > 1 && activeInputChannels[1])
+    if (activeInputChannels.isZero())
     {
-        auto level = bufferToFill.buffer->getRMSLevel(1, bufferToFill.startSample,
-                                                       bufferToFill.numSamples);
-        inputLevelRight.store(level);
+        // No input: tracks are mixed into silence
+        bufferToFill.clearActiveBufferRegion();
+        pushSilentMeterFrame(inputMeterFifo, bufferToFill.numSamples, timestamp);
     }
     else
     {
-        inputLevelRight.store(0.0f);
+        // Passthrough: input is already in the buffer
+        // For channels that have no input, clear them
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            if (!activeInputChannels[channel])
+            {
+                bufferToFill.buffer->clear(channel, bufferToFill.startSample,
+                                           bufferToFill.numSamples);
+            }
+        }
+
+        // Input levels (inactive channels were cleared above and read as silence)
+        pushMeterFrame(inputMeterFifo, inputMeterKernel, bufferToFill, timestamp);
+
+        // Armed inputs go to the recorder's ring; the disk is written from its own thread
+        recorder.capture(*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples);
     }
 
-    // If no input, clear output to silence
-    if (activeInputChannels.isZero())
+    // Tracks are summed on top of the monitored input
+    mixGraph.process(*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples,
+                     threadPool);
+
+    // Output levels
+    pushMeterFrame(outputMeterFifo, outputMeterKernel, bufferToFill, timestamp);
+}
+
+void AudioEngine::pushMeterFrame(MeterFifo& fifo, MeterKernel& kernel,
+                                 const juce::AudioSourceChannelInfo& bufferToFill,
+                                 juce::int64 timestamp) noexcept
+{
+    MeterFrame frame;
+    frame.numSamples = bufferToFill.numSamples;
+    frame.timestamp = timestamp;
+
+    // Peak, energy and true-peak of every channel in a single pass
+    MeterKernel::ChannelLevels levels[MeterFrame::maxChannels];
+    kernel.process(*bufferToFill.buffer, bufferToFill.startSample, bufferToFill.numSamples,
+                   levels, MeterFrame::maxChannels);
+
+    auto numChannels = juce::jmin(bufferToFill.buffer->getNumChannels(), MeterFrame::maxChannels);
+
+    for (int channel = 0; channel < numChannels && frame.numSamples > 0; ++channel)
     {
-        bufferToFill.clearActiveBufferRegion();
-        inputLevelLeft.store(0.0f);
-        inputLevelRight.store(0.0f);
-        outputLevelLeft.store(0.0f);
-        outputLevelRight.store(0.0f);
-        return;
+        const auto& level = levels[channel];
+        frame.peak[channel] = level.peak;
+        frame.truePeak[channel] = level.truePeak;
+        frame.rms[channel] = std::sqrt(level.sumOfSquares / static_cast<float>(frame.numSamples));
+        frame.clipped = frame.clipped || level.peak >= 1.0f || level.truePeak > 1.0f;
+    }
+
+    fifo.push(frame);
+}
+
+void AudioEngine::pushSilentMeterFrame(MeterFifo& fifo, int numSamples,
+                                       juce::int64 timestamp) noexcept
+{
+    MeterFrame frame;
+    frame.numSamples = numSamples;
+    frame.timestamp = timestamp;
+
+    fifo.push(frame);
+}
+
+AudioCallbackProfiler::Stats AudioEngine::getCallbackStats() const
+{
+    auto stats = callbackProfiler.getStats();
+    const juce::ScopedTryLock sl(deviceLock);
+
+    if (auto* device = sl.isLocked() ? deviceManager.getCurrentAudioDevice() : nullptr)
+    {
+        stats.deviceXRuns = device->getXRunCount();
     }
 
-    // Passthrough: input is already in the buffer
-    // For channels that have no input, clear them
-    for (int channel = 0; channel < numChannels; ++channel)
+    stats.diskUnderruns = diskStreamer.getUnderrunCount();
+    return stats;
+}
+
+juce::Result AudioEngine::exportCallbackStats(const juce::File& file) const
+{
+    if (!file.replaceWithText(getCallbackStats().toJSON()))
     {
-        if (!activeInputChannels[channel])
-        {
-            bufferToFill.buffer->clear(channel, bufferToFill.startSample,
-                                       bufferToFill.numSamples);
-        }
+        return juce::Result::fail("Could not write " + file.getFullPathName());
     }
 
-    // Output levels (same as input for passthrough)
-    outputLevelLeft.store(inputLevelLeft.load());
-    outputLevelRight.store(inputLevelRight.load());
+    return juce::Result::ok();
 }
 
 void AudioEngine::start()
 {
     if (!running)
     {
-        deviceManager.addAudioCallback(&sourcePlayer);
+        reconfigurer.setCallbackEnabled(true);
         running = true;
         DBG("AudioEngine: Started");
     }
@@ -131,164 +314,184 @@ void AudioEngine::stop()
 {
     if (running)
     {
-        deviceManager.removeAudioCallback(&sourcePlayer);
+        reconfigurer.setCallbackEnabled(false);
         running = false;
         DBG("AudioEngine: Stopped");
     }
 }
 
-juce::StringArray AudioEngine::getAvailableInputDevices()
+juce::StringArray AudioEngine::getAvailableInputDevices() const
 {
-    juce::StringArray devices;
-    auto& types = deviceManager.getAvailableDeviceTypes();
-
-    for (auto* type : types)
-    {
-        auto deviceNames = type->getDeviceNames(true); // true = input devices
-        devices.addArray(deviceNames);
-    }
+    return deviceRegistry.getDeviceNames(true);
+}
 
-    return devices;
+juce::StringArray AudioEngine::getAvailableOutputDevices() const
+{
+    return deviceRegistry.getDeviceNames(false);
 }
 
-juce::StringArray AudioEngine::getAvailableOutputDevices()
+const AudioEngine::DeviceInfo& AudioEngine::getDeviceInfo() const
 {
-    juce::StringArray devices;
-    auto& types = deviceManager.getAvailableDeviceTypes();
+    // Never wait for the reconfigurer: while it holds the lock the last values stand in
+    const juce::ScopedTryLock sl(deviceLock);
 
-    for (auto* type : types)
+    if (sl.isLocked())
     {
-        auto deviceNames = type->getDeviceNames(false); // false = output devices
-        devices.addArray(deviceNames);
+        deviceInfo = {};
+
+        if (auto* device = deviceManager.getCurrentAudioDevice())
+        {
+            auto setup = deviceManager.getAudioDeviceSetup();
+            deviceInfo.inputDevice = setup.inputDeviceName;
+            deviceInfo.outputDevice = setup.outputDeviceName;
+            deviceInfo.sampleRate = device->getCurrentSampleRate();
+            deviceInfo.bufferSize = device->getCurrentBufferSizeSamples();
+            deviceInfo.sampleRates = device->getAvailableSampleRates();
+            deviceInfo.bufferSizes = device->getAvailableBufferSizes();
+            deviceInfo.reportedLatency = device->getInputLatencyInSamples() +
+                                         device->getOutputLatencyInSamples();
+        }
     }
 
-    return devices;
+    return deviceInfo;
 }
 
 juce::String AudioEngine::getCurrentInputDevice() const
 {
-    auto* setup = deviceManager.getCurrentAudioDevice();
-    if (setup != nullptr)
-    {
-        auto audioSetup = deviceManager.getAudioDeviceSetup();
-        return audioSetup.inputDeviceName;
-    }
-    return {};
+    return getDeviceInfo().inputDevice;
 }
 
 juce::String AudioEngine::getCurrentOutputDevice() const
 {
-    auto* setup = deviceManager.getCurrentAudioDevice();
-    if (setup != nullptr)
-    {
-        auto audioSetup = deviceManager.getAudioDeviceSetup();
-        return audioSetup.outputDeviceName;
-    }
-    return {};
+    return getDeviceInfo().outputDevice;
 }
 
-juce::String AudioEngine::setInputDevice(const juce::String& deviceName)
+void AudioEngine::setInputDevice(const juce::String& deviceName)
 {
     DBG("AudioEngine::setInputDevice called with: " + deviceName);
 
-    auto setup = deviceManager.getAudioDeviceSetup();
-    DBG("Current setup - Input: " + setup.inputDeviceName + ", Output: " + setup.outputDeviceName);
+    DeviceReconfigurer::Request change;
+    change.inputDevice = deviceName;
+    reconfigurer.request(change);
+}
 
-    setup.inputDeviceName = deviceName;
-    setup.useDefaultInputChannels = true;
+void AudioEngine::setOutputDevice(const juce::String& deviceName)
+{
+    DBG("AudioEngine::setOutputDevice called with: " + deviceName);
 
-    auto result = deviceManager.setAudioDeviceSetup(setup, true);
+    DeviceReconfigurer::Request change;
+    change.outputDevice = deviceName;
+    reconfigurer.request(change);
+}
 
-    if (result.isEmpty())
-    {
-        DBG("AudioEngine::setInputDevice succeeded");
-        auto newSetup = deviceManager.getAudioDeviceSetup();
-        DBG("New setup - Input: " + newSetup.inputDeviceName + ", Output: " + newSetup.outputDeviceName);
-    }
-    else
-    {
-        DBG("AudioEngine::setInputDevice failed: " + result);
-    }
+double AudioEngine::getSampleRate() const
+{
+    return getDeviceInfo().sampleRate;
+}
 
-    return result;
+int AudioEngine::getBufferSize() const
+{
+    return getDeviceInfo().bufferSize;
 }
 
-juce::String AudioEngine::setOutputDevice(const juce::String& deviceName)
+void AudioEngine::setSampleRate(double sampleRate)
 {
-    DBG("AudioEngine::setOutputDevice called with: " + deviceName);
+    DeviceReconfigurer::Request change;
+    change.sampleRate = sampleRate;
+    reconfigurer.request(change);
+}
 
-    auto setup = deviceManager.getAudioDeviceSetup();
-    DBG("Current setup - Input: " + setup.inputDeviceName + ", Output: " + setup.outputDeviceName);
+void AudioEngine::setBufferSize(int bufferSize)
+{
+    DeviceReconfigurer::Request change;
+    change.bufferSize = bufferSize;
+    reconfigurer.request(change);
+}
 
-    setup.outputDeviceName = deviceName;
-    setup.useDefaultOutputChannels = true;
+juce::Array<double> AudioEngine::getAvailableSampleRates() const
+{
+    return getDeviceInfo().sampleRates;
+}
 
-    auto result = deviceManager.setAudioDeviceSetup(setup, true);
+juce::Array<int> AudioEngine::getAvailableBufferSizes() const
+{
+    return getDeviceInfo().bufferSizes;
+}
 
-    if (result.isEmpty())
-    {
-        DBG("AudioEngine::setOutputDevice succeeded");
-        auto newSetup = deviceManager.getAudioDeviceSetup();
-        DBG("New setup - Input: " + newSetup.inputDeviceName + ", Output: " + newSetup.outputDeviceName);
-    }
-    else
-    {
-        DBG("AudioEngine::setOutputDevice failed: " + result);
-    }
+juce::String AudioEngine::getLatencyKey() const
+{
+    const auto& info = getDeviceInfo();
 
-    return result;
+    // Converter and driver latency depend on all of these, so each combination is measured
+    return "roundTrip|" + info.outputDevice + "|" + info.inputDevice + "|" +
+           juce::String(info.sampleRate, 0) + "|" + juce::String(info.bufferSize);
 }
 
-double AudioEngine::getSampleRate() const
+juce::Result AudioEngine::measureLatency(
+    int inputChannel, int outputChannel,
+    std::function<void(const LatencyCalibrator::Measurement&)> onComplete)
 {
-    auto* device = deviceManager.getCurrentAudioDevice();
-    if (device != nullptr)
+    if (!running || reconfigurer.isBusy() || getSampleRate() <= 0.0)
     {
-        return device->getCurrentSampleRate();
+        return juce::Result::fail("The audio device isn't running");
     }
-    return 0.0;
-}
 
-int AudioEngine::getBufferSize() const
-{
-    auto* device = deviceManager.getCurrentAudioDevice();
-    if (device != nullptr)
+    if (recorder.isRecording())
     {
-        return device->getCurrentBufferSizeSamples();
+        return juce::Result::fail("Can't measure latency while recording");
     }
-    return 0;
+
+    // Stored against the setup it was measured with, even if that has changed since
+    auto key = getLatencyKey();
+
+    return latencyCalibrator.start(
+        getSampleRate(), inputChannel, outputChannel,
+        [this, key, onComplete](const LatencyCalibrator::Measurement& measurement)
+        {
+            if (measurement.succeeded && settings != nullptr)
+            {
+                settings->setValue(key, measurement.roundTripSamples);
+                settings->saveIfNeeded();
+            }
+
+            if (onComplete)
+            {
+                onComplete(measurement);
+            }
+        });
 }
 
-juce::String AudioEngine::setSampleRate(double sampleRate)
+int AudioEngine::getMeasuredLatency() const
 {
-    auto setup = deviceManager.getAudioDeviceSetup();
-    setup.sampleRate = sampleRate;
-    return deviceManager.setAudioDeviceSetup(setup, true);
+    if (settings == nullptr)
+    {
+        return -1;
+    }
+
+    return settings->getIntValue(getLatencyKey(), -1);
 }
 
-juce::String AudioEngine::setBufferSize(int bufferSize)
+int AudioEngine::getReportedLatency() const
 {
-    auto setup = deviceManager.getAudioDeviceSetup();
-    setup.bufferSize = bufferSize;
-    return deviceManager.setAudioDeviceSetup(setup, true);
+    return getDeviceInfo().reportedLatency;
 }
 
-juce::Array<double> AudioEngine::getAvailableSampleRates() const
+int AudioEngine::getRecordingLatency() const
 {
-    auto* device = deviceManager.getCurrentAudioDevice();
-    if (device != nullptr)
-    {
-        return device->getAvailableSampleRates();
-    }
-    return {};
+    auto measured = getMeasuredLatency();
+    return measured >= 0 ? measured : getReportedLatency();
 }
 
-juce::Array<int> AudioEngine::getAvailableBufferSizes() const
+juce::Result AudioEngine::startRecording(const juce::File& directory,
+                                         const juce::String& takeName,
+                                         const juce::BigInteger& armedInputs,
+                                         Recorder::Options options)
 {
-    auto* device = deviceManager.getCurrentAudioDevice();
-    if (device != nullptr)
+    if (latencyCalibrator.isMeasuring())
     {
-        return device->getAvailableBufferSizes();
+        return juce::Result::fail("Can't record while measuring latency");
     }
-    return {};
+
+    options.latencyCompensation = getRecordingLatency();
+    return recorder.start(directory, takeName, armedInputs, options);
 }
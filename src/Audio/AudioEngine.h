@@ -1,18 +1,55 @@
 #pragma once
 
 #include <JuceHeader.h>
-#include <atomic>
+#include "AudioCallbackProfiler.h"
+#include "DSP/MeterKernel.h"
+#include "DeviceReconfigurer.h"
+#include "DeviceRegistry.h"
+#include "GarbageCollector.h"
+#include "Graph/MixGraph.h"
+#include "LatencyCalibrator.h"
+#include "MeterFifo.h"
+#include "Midi/MidiInputQueue.h"
+#include "RealtimeThreadPool.h"
+#include "Recording/Recorder.h"
+#include "Session/SessionPublisher.h"
+#include "StartupTrace.h"
+#include "Streaming/DiskStreamer.h"
+#include "Transport.h"
+#include "Waveform/PeakCacheBuilder.h"
 
 /**
  * AudioEngine manages audio device I/O and the core audio processing.
  *
- * Currently implements simple passthrough (input -> output).
- * Will eventually handle tracks, mixing, and plugin processing.
+ * Passes the input through (monitoring) and adds the mix of all tracks,
+ * rendered in parallel on a pool of real-time worker threads. Clips are
+ * streamed from disk by a background I/O thread that reads ahead of the
+ * transport, and armed inputs are recorded by a writer thread. Live MIDI
+ * input is queued with timestamps and placed in each block sample by sample.
+ *
+ * Device changes are applied by a DeviceReconfigurer on a background thread;
+ * the device getters report the last known setup while one is in flight, so
+ * the UI never waits on a driver.
+ *
+ * The device setup and the registry's device list are saved between runs,
+ * so a cold start opens the last device once and reports how long it took
+ * to reach the first audio callback.
+ *
+ * In offline mode no device is opened; the owner drives getNextAudioBlock()
+ * directly (see OfflineRenderer) and every input channel counts as active.
  */
-class AudioEngine : public juce::AudioSource
+class AudioEngine : public juce::AudioSource,
+                    private DeviceReconfigurer::Listener,
+                    private DeviceRegistry::Listener
 {
 public:
-    AudioEngine();
+    enum class DeviceMode
+    {
+        openDefaultDevice,
+        offline
+    };
+
+    explicit AudioEngine(DeviceMode mode = DeviceMode::openDefaultDevice);
     ~AudioEngine() override;
 
     // AudioSource interface
@@ -23,49 +60,152 @@ public:
     // Device management
     juce::AudioDeviceManager& getDeviceManager() { return deviceManager; }
 
-    // Device info
-    juce::StringArray getAvailableInputDevices();
-    juce::StringArray getAvailableOutputDevices();
+    // Tracks and mixing
+    MixGraph& getMixGraph() { return mixGraph; }
+
+    // Playhead and disk streaming (see ClipPlayer for putting clips on a track)
+    Transport& getTransport() { return transport; }
+    DiskStreamer& getDiskStreamer() { return diskStreamer; }
+
+    // The session as the audio thread reads it: publish a new version for each edit, and
+    // read SessionPublisher::get() while rendering a block
+    SessionPublisher& getSession() { return session; }
+
+    // Live MIDI from the enabled input devices, collected once per block (see MidiPlayer
+    // for playing MIDI on a track)
+    MidiInputQueue& getMidiInput() { return midiInput; }
+
+    // Input recording (the buffer's input channels, before tracks are mixed in)
+    Recorder& getRecorder() { return recorder; }
+
+    // Waveform peaks for audio files (takes in progress: Recorder::getPeaks)
+    PeakCacheBuilder& getPeakCaches() { return peakCaches; }
+
+    // Starts a take compensated for the round-trip latency of the current setup
+    juce::Result startRecording(const juce::File& directory, const juce::String& takeName,
+                                const juce::BigInteger& armedInputs,
+                                Recorder::Options options = {});
+
+    // Device info (lists come from the registry's cache; it scans in the background)
+    DeviceRegistry& getDeviceRegistry() { return deviceRegistry; }
+    juce::StringArray getAvailableInputDevices() const;
+    juce::StringArray getAvailableOutputDevices() const;
     juce::String getCurrentInputDevice() const;
     juce::String getCurrentOutputDevice() const;
 
-    // Device selection
-    juce::String setInputDevice(const juce::String& deviceName);
-    juce::String setOutputDevice(const juce::String& deviceName);
+    // Device selection (asynchronous: progress and errors arrive through the reconfigurer)
+    void setInputDevice(const juce::String& deviceName);
+    void setOutputDevice(const juce::String& deviceName);
 
     // Audio settings
     double getSampleRate() const;
     int getBufferSize() const;
-    juce::String setSampleRate(double sampleRate);
-    juce::String setBufferSize(int bufferSize);
+    void setSampleRate(double sampleRate);
+    void setBufferSize(int bufferSize);
 
     juce::Array<double> getAvailableSampleRates() const;
     juce::Array<int> getAvailableBufferSizes() const;
 
+    DeviceReconfigurer& getDeviceReconfigurer() { return reconfigurer; }
+
+    // Round-trip latency, measured through a loopback from outputChannel to inputChannel
+    // and stored per device, sample rate and buffer size. onComplete runs on the message
+    // thread; while measuring, the device plays only the test signal.
+    juce::Result measureLatency(
+        int inputChannel, int outputChannel,
+        std::function<void(const LatencyCalibrator::Measurement&)> onComplete);
+    void cancelLatencyMeasurement() { latencyCalibrator.cancel(); }
+    bool isMeasuringLatency() const { return latencyCalibrator.isMeasuring(); }
+
+    int getMeasuredLatency() const;  // Samples; -1 if the current setup hasn't been measured
+    int getReportedLatency() const;  // What the driver reports, input plus output
+    int getRecordingLatency() const; // Measured if available, otherwise reported
+
     // Start/stop audio
     void start();
     void stop();
     bool isRunning() const { return running; }
+    bool isOffline() const { return deviceMode == DeviceMode::offline; }
+
+    // Upper bound on channels rendered in offline mode
+    static constexpr int maxOfflineChannels = 64;
+
+    // Per-block meter frames (drained by the UI on the message thread)
+    MeterFifo& getInputMeterFifo() { return inputMeterFifo; }
+    MeterFifo& getOutputMeterFifo() { return outputMeterFifo; }
 
-    // Audio levels (thread-safe, for UI display)
-    float getInputLevelLeft() const { return inputLevelLeft.load(); }
-    float getInputLevelRight() const { return inputLevelRight.load(); }
-    float getOutputLevelLeft() const { return outputLevelLeft.load(); }
-    float getOutputLevelRight() const { return outputLevelRight.load(); }
+    // Callback timing (DSP load, late/missed callbacks, latency histograms)
+    AudioCallbackProfiler::Stats getCallbackStats() const;
+    const StartupTrace& getStartupTrace() const { return startupTrace; }
+    juce::Result exportCallbackStats(const juce::File& file) const;
 
 private:
+    // What the message thread last saw of the device
+    struct DeviceInfo
+    {
+        juce::String inputDevice;
+        juce::String outputDevice;
+        double sampleRate = 0.0;
+        int bufferSize = 0;
+        juce::Array<double> sampleRates;
+        juce::Array<int> bufferSizes;
+        int reportedLatency = 0;
+    };
+
+    const DeviceInfo& getDeviceInfo() const;
+    juce::String getLatencyKey() const;
+    void saveDeviceState();
+    void deviceReconfigurationChanged(const DeviceReconfigurer::Progress& progress) override;
+    void deviceListChanged(const DeviceRegistry::Diff& diff) override;
+    void pushMeterFrame(MeterFifo& fifo, MeterKernel& kernel,
+                        const juce::AudioSourceChannelInfo& bufferToFill,
+                        juce::int64 timestamp) noexcept;
+    void pushSilentMeterFrame(MeterFifo& fifo, int numSamples, juce::int64 timestamp) noexcept;
+
     juce::AudioDeviceManager deviceManager;
     juce::AudioSourcePlayer sourcePlayer;
 
+    // Held by the reconfigurer around every device call; readers only try-lock it
+    juce::CriticalSection deviceLock;
+    DeviceReconfigurer reconfigurer;
+    DeviceRegistry deviceRegistry;
+    mutable DeviceInfo deviceInfo;
+
+    const DeviceMode deviceMode;
     double currentSampleRate = 0.0;
     int currentBufferSize = 0;
     bool running = false;
 
-    // Audio levels (atomic for thread safety between audio and UI threads)
-    std::atomic<float> inputLevelLeft{0.0f};
-    std::atomic<float> inputLevelRight{0.0f};
-    std::atomic<float> outputLevelLeft{0.0f};
-    std::atomic<float> outputLevelRight{0.0f};
+    // Captured in prepareToPlay (the device only changes channels across a restart)
+    juce::BigInteger activeInputChannels;
+
+    AudioCallbackProfiler callbackProfiler;
+
+    // Round-trip measurements
+    LatencyCalibrator latencyCalibrator;
+
+    // Device state and latencies across runs (none in offline mode)
+    std::unique_ptr<juce::PropertiesFile> settings;
+    StartupTrace startupTrace;
+
+    // Playback position and the clip streams reading ahead of it
+    Transport transport;
+    DiskStreamer diskStreamer;
+    Recorder recorder;
+    PeakCacheBuilder peakCaches;
+    MidiInputQueue midiInput;
+
+    // Track rendering and the session (the pool and collector outlive what uses them)
+    RealtimeThreadPool threadPool;
+    GarbageCollector garbageCollector;
+    MixGraph mixGraph;
+    SessionPublisher session;
+
+    // Audio levels (lock-free SPSC queues from the audio thread to the UI)
+    MeterKernel inputMeterKernel;
+    MeterKernel outputMeterKernel;
+    MeterFifo inputMeterFifo;
+    MeterFifo outputMeterFifo;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioEngine)
 };
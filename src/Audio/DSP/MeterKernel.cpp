@@ -0,0 +1,186 @@
+#include "MeterKernel.h"
+
+#include "Vec4.h"
+
+namespace
+{
+using namespace simd;
+
+//==============================================================================
+// 4x interpolation filter (48-tap windowed sinc, split into four 12-tap phases)
+//==============================================================================
+
+struct InterpolatorCoefficients
+{
+    // taps[k] holds the k-th coefficient of all four phases, so one multiply-add
+    // per history sample advances every phase at once
+    alignas(16) float taps[MeterKernel::tapsPerPhase][MeterKernel::oversamplingFactor];
+
+    InterpolatorCoefficients()
+    {
+        constexpr int factor = MeterKernel::oversamplingFactor;
+        constexpr int numTaps = MeterKernel::tapsPerPhase * factor;
+        constexpr double pi = juce::MathConstants<double>::pi;
+        const double centre = (numTaps - 1) * 0.5;
+
+        double prototype[numTaps];
+
+        for (int n = 0; n < numTaps; ++n)
+        {
+            auto x = (n - centre) / factor;
+            auto sinc = std::abs(x) < 1.0e-9 ? 1.0 : std::sin(pi * x) / (pi * x);
+
+            // Blackman-Harris window
+            auto w = 2.0 * pi * n / (numTaps - 1);
+            auto window = 0.35875 - 0.48829 * std::cos(w) + 0.14128 * std::cos(2.0 * w) -
+                          0.01168 * std::cos(3.0 * w);
+
+            prototype[n] = sinc * window;
+        }
+
+        // Normalise each phase to unity DC gain
+        for (int phase = 0; phase < factor; ++phase)
+        {
+            double sum = 0.0;
+            for (int k = 0; k < MeterKernel::tapsPerPhase; ++k)
+            {
+                sum += prototype[phase + factor * k];
+            }
+
+            for (int k = 0; k < MeterKernel::tapsPerPhase; ++k)
+            {
+                taps[k][phase] = static_cast<float>(prototype[phase + factor * k] / sum);
+            }
+        }
+    }
+};
+
+const InterpolatorCoefficients& getCoefficients() noexcept
+{
+    static const InterpolatorCoefficients coefficients;
+    return coefficients;
+}
+
+} // namespace
+
+//==============================================================================
+// MeterKernel
+//==============================================================================
+
+MeterKernel::MeterKernel()
+{
+    // Build the coefficient table here rather than lazily on the audio thread
+    juce::ignoreUnused(getCoefficients());
+}
+
+void MeterKernel::prepare(int numChannels)
+{
+    states.assign(static_cast<size_t>(juce::jmax(0, numChannels)), TruePeakState());
+}
+
+void MeterKernel::reset() noexcept
+{
+    for (auto& state : states)
+    {
+        state = TruePeakState();
+    }
+}
+
+void MeterKernel::process(const juce::AudioBuffer<float>& buffer, int startSample,
+                          int numSamples, ChannelLevels* results, int numChannels) noexcept
+{
+    numChannels = juce::jmin(numChannels, buffer.getNumChannels(), getNumChannels());
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        results[channel] = ChannelLevels();
+        processChannel(buffer.getReadPointer(channel, startSample), numSamples,
+                       states[static_cast<size_t>(channel)], results[channel]);
+    }
+}
+
+void MeterKernel::processChannel(const float* samples, int numSamples, TruePeakState& state,
+                                 ChannelLevels& result) noexcept
+{
+    const auto& coefficients = getCoefficients();
+
+    // Pushes one sample through the interpolator and returns |all four phases|
+    auto interpolate = [&state, &coefficients](float sample) noexcept
+    {
+        state.position = (state.position == 0 ? tapsPerPhase : state.position) - 1;
+        state.history[state.position] = sample;
+        state.history[state.position + tapsPerPhase] = sample;
+
+        // history[position + k] is the sample k steps in the past
+        const float* window = state.history + state.position;
+        auto phases = vecZero();
+
+        for (int k = 0; k < tapsPerPhase; ++k)
+        {
+            phases = vecAdd(phases, vecMul(vecBroadcast(window[k]),
+                                           vecLoadAligned(coefficients.taps[k])));
+        }
+
+        return vecAbs(phases);
+    };
+
+    auto peak = vecZero();
+    auto sumOfSquares = vecZero();
+    auto truePeak = vecZero();
+    int i = 0;
+
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        auto x = vecLoad(samples + i);
+        peak = vecMax(peak, vecAbs(x));
+        sumOfSquares = vecAdd(sumOfSquares, vecMul(x, x));
+
+        // Reuse the loaded lanes rather than reading the buffer again
+        alignas(16) float lanes[4];
+        vecStoreAligned(lanes, x);
+
+        for (auto sample : lanes)
+        {
+            truePeak = vecMax(truePeak, interpolate(sample));
+        }
+    }
+
+    result.peak = maxAcross(peak);
+    result.sumOfSquares = sumAcross(sumOfSquares);
+    result.truePeak = maxAcross(truePeak);
+
+    for (; i < numSamples; ++i)
+    {
+        auto sample = samples[i];
+        result.peak = juce::jmax(result.peak, std::abs(sample));
+        result.sumOfSquares += sample * sample;
+        result.truePeak = juce::jmax(result.truePeak, maxAcross(interpolate(sample)));
+    }
+
+    // The true peak is never below the sample peak
+    result.truePeak = juce::jmax(result.truePeak, result.peak);
+}
+
+void MeterKernel::measure(const float* samples, int numSamples, float& peak,
+                          float& sumOfSquares) noexcept
+{
+    auto peakVec = vecZero();
+    auto sumVec = vecZero();
+    int i = 0;
+
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        auto x = vecLoad(samples + i);
+        peakVec = vecMax(peakVec, vecAbs(x));
+        sumVec = vecAdd(sumVec, vecMul(x, x));
+    }
+
+    peak = maxAcross(peakVec);
+    sumOfSquares = sumAcross(sumVec);
+
+    for (; i < numSamples; ++i)
+    {
+        peak = juce::jmax(peak, std::abs(samples[i]));
+        sumOfSquares += samples[i] * samples[i];
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+/**
+ * MeterKernel measures peak, energy and true-peak of audio blocks in one pass.
+ *
+ * Each sample is read once: absolute peak and sum of squares are accumulated
+ * four samples at a time (SSE on Intel, NEON on ARM, scalar elsewhere), and
+ * the same samples feed a 4x polyphase interpolator whose four output phases
+ * are computed together in one vector to find inter-sample (true) peaks.
+ *
+ * The interpolator keeps history per channel, so use one kernel per metered
+ * bus and call prepare() before processing.
+ */
+class MeterKernel
+{
+public:
+    struct ChannelLevels
+    {
+        float peak = 0.0f;
+        float sumOfSquares = 0.0f;
+        float truePeak = 0.0f;
+    };
+
+    static constexpr int oversamplingFactor = 4;
+    static constexpr int tapsPerPhase = 12;
+
+    MeterKernel();
+
+    // Allocates interpolator history (not real-time safe)
+    void prepare(int numChannels);
+    void reset() noexcept;
+
+    int getNumChannels() const { return static_cast<int>(states.size()); }
+
+    // Measures the first min(numChannels, getNumChannels()) channels of the buffer region.
+    // Real-time safe.
+    void process(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
+                 ChannelLevels* results, int numChannels) noexcept;
+
+    // Stateless peak and sum of squares for a single channel (no true-peak)
+    static void measure(const float* samples, int numSamples, float& peak,
+                        float& sumOfSquares) noexcept;
+
+private:
+    struct TruePeakState
+    {
+        // Last tapsPerPhase samples, stored twice so the filter window is always contiguous
+        float history[2 * tapsPerPhase] = {};
+        int position = 0;
+    };
+
+    static void processChannel(const float* samples, int numSamples, TruePeakState& state,
+                               ChannelLevels& result) noexcept;
+
+    std::vector<TruePeakState> states;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MeterKernel)
+};
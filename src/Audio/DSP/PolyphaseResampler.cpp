@@ -0,0 +1,244 @@
+#include "PolyphaseResampler.h"
+
+#include "Vec4.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+using namespace simd;
+
+constexpr int phaseShift = 32 - 8; // Top 8 fraction bits pick one of the 256 phases
+constexpr float phaseScale = 1.0f / static_cast<float>(1 << phaseShift);
+
+static_assert((1 << (32 - phaseShift)) == PolyphaseResampler::numPhases,
+              "phaseShift must match numPhases");
+
+// Zeroth-order modified Bessel function, for the Kaiser window
+double besselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+
+    for (int k = 1; k < 32; ++k)
+    {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+
+        if (term < sum * 1.0e-12)
+        {
+            break;
+        }
+    }
+
+    return sum;
+}
+
+struct QualitySettings
+{
+    int taps;
+    double passband; // Fraction of the lower Nyquist kept flat
+    double beta;     // Kaiser window shape (higher: more stopband, wider transition)
+};
+
+QualitySettings getSettings(PolyphaseResampler::Quality quality)
+{
+    switch (quality)
+    {
+        case PolyphaseResampler::Quality::draft:
+            return {16, 0.85, 6.0};
+        case PolyphaseResampler::Quality::high:
+            return {64, 0.95, 10.0};
+        case PolyphaseResampler::Quality::standard:
+        default:
+            return {32, 0.91, 8.0};
+    }
+}
+
+// One output sample: the two neighbouring phases, interpolated by t
+float filterSample(const float* window, const float* phase0, const float* phase1, int numTaps,
+                   float t) noexcept
+{
+    auto sum0 = vecZero();
+    auto sum1 = vecZero();
+
+    for (int k = 0; k < numTaps; k += 4)
+    {
+        auto x = vecLoad(window + k);
+        sum0 = vecAdd(sum0, vecMul(x, vecLoad(phase0 + k)));
+        sum1 = vecAdd(sum1, vecMul(x, vecLoad(phase1 + k)));
+    }
+
+    auto a = sumAcross(sum0);
+    return a + t * (sumAcross(sum1) - a);
+}
+} // namespace
+
+PolyphaseResampler::PolyphaseResampler() = default;
+
+int PolyphaseResampler::getBaseTaps(Quality quality) noexcept
+{
+    return getSettings(quality).taps;
+}
+
+void PolyphaseResampler::prepare(int channels, double inputRate, double outputRate,
+                                 Quality quality, int maxOutputSamples)
+{
+    jassert(inputRate > 0.0 && outputRate > 0.0);
+
+    numChannels = juce::jmax(1, channels);
+    ratio = inputRate / outputRate;
+    step = static_cast<juce::uint64>(std::llround(ratio * 4294967296.0));
+
+    buildFilter(quality);
+
+    // One call's worth of input (a whole filter more straight after a reset), plus what
+    // process() can leave behind
+    maxInputSamples = static_cast<int>(std::ceil(maxOutputSamples * ratio)) + numTaps + 2;
+    auto capacity = maxInputSamples + numTaps + static_cast<int>(std::ceil(ratio)) + 4;
+    history.setSize(numChannels, capacity);
+    reset();
+}
+
+void PolyphaseResampler::buildFilter(Quality quality)
+{
+    constexpr double pi = juce::MathConstants<double>::pi;
+    auto settings = getSettings(quality);
+
+    // Downsampling: cut off at the output's Nyquist, and stretch the filter to keep its slope
+    auto stretch = juce::jmax(1.0, ratio);
+    auto cutoff = settings.passband / stretch;
+    numTaps = (static_cast<int>(std::ceil(settings.taps * stretch)) + 3) & ~3;
+    halfTaps = numTaps / 2;
+
+    coefficients.assign(static_cast<size_t>((numPhases + 1) * numTaps), 0.0f);
+    auto windowNorm = besselI0(settings.beta);
+    std::vector<double> row(static_cast<size_t>(numTaps));
+
+    for (int phase = 0; phase <= numPhases; ++phase)
+    {
+        auto offset = static_cast<double>(phase) / numPhases;
+        double sum = 0.0;
+
+        for (int k = 0; k < numTaps; ++k)
+        {
+            // Distance from tap k to the output position, in input samples
+            auto x = static_cast<double>(k - (halfTaps - 1)) - offset;
+            auto sinc = std::abs(x) < 1.0e-9 ? 1.0 : std::sin(pi * cutoff * x) / (pi * cutoff * x);
+            auto r = x / static_cast<double>(halfTaps);
+            auto window = std::abs(r) >= 1.0
+                              ? 0.0
+                              : besselI0(settings.beta * std::sqrt(1.0 - r * r)) / windowNorm;
+
+            row[static_cast<size_t>(k)] = sinc * window;
+            sum += row[static_cast<size_t>(k)];
+        }
+
+        // Unity DC gain in every phase, so the interpolation between phases can't ripple
+        auto* destination = coefficients.data() + phase * numTaps;
+
+        for (int k = 0; k < numTaps; ++k)
+        {
+            destination[k] = static_cast<float>(row[static_cast<size_t>(k)] / sum);
+        }
+    }
+}
+
+void PolyphaseResampler::reset() noexcept
+{
+    // Half a filter of silence before the first input sample
+    history.clear();
+    numBuffered = halfTaps - 1;
+    positionIndex = halfTaps - 1;
+    positionFraction = 0;
+}
+
+int PolyphaseResampler::getInputNeeded(int numOutputSamples) const noexcept
+{
+    if (numOutputSamples <= 0)
+    {
+        return 0;
+    }
+
+    auto last = ((static_cast<juce::uint64>(positionIndex) << 32) | positionFraction) +
+                static_cast<juce::uint64>(numOutputSamples - 1) * step;
+    auto lastIndex = static_cast<juce::int64>(last >> 32);
+
+    return static_cast<int>(juce::jmax(static_cast<juce::int64>(0),
+                                       lastIndex + halfTaps + 1 - numBuffered));
+}
+
+int PolyphaseResampler::process(const float* const* input, int numInput, float* const* output,
+                                int maxOutput) noexcept
+{
+    auto capacity = history.getNumSamples();
+    jassert(numBuffered + numInput <= capacity);
+    numInput = juce::jlimit(0, capacity - numBuffered, numInput);
+
+    for (int channel = 0; channel < numChannels && numInput > 0; ++channel)
+    {
+        std::memcpy(history.getWritePointer(channel, numBuffered), input[channel],
+                    static_cast<size_t>(numInput) * sizeof(float));
+    }
+
+    numBuffered += numInput;
+
+    // Outputs whose whole window is buffered
+    auto position = (static_cast<juce::uint64>(positionIndex) << 32) | positionFraction;
+    int numOutput = 0;
+
+    while (numOutput < maxOutput)
+    {
+        auto index = static_cast<int>((position + numOutput * step) >> 32);
+
+        if (index + halfTaps >= numBuffered)
+        {
+            break;
+        }
+
+        ++numOutput;
+    }
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const auto* samples = history.getReadPointer(channel);
+        auto* destination = output[channel];
+        auto channelPosition = position;
+
+        for (int i = 0; i < numOutput; ++i)
+        {
+            auto index = static_cast<int>(channelPosition >> 32);
+            auto fraction = static_cast<juce::uint32>(channelPosition);
+            auto phase = static_cast<int>(fraction >> phaseShift);
+            auto t = static_cast<float>(fraction & ((1u << phaseShift) - 1)) * phaseScale;
+
+            const auto* phase0 = coefficients.data() + phase * numTaps;
+            destination[i] = filterSample(samples + index - (halfTaps - 1), phase0,
+                                          phase0 + numTaps, numTaps, t);
+            channelPosition += step;
+        }
+    }
+
+    position += static_cast<juce::uint64>(numOutput) * step;
+    positionIndex = static_cast<int>(position >> 32);
+    positionFraction = static_cast<juce::uint32>(position);
+
+    // Drop input no future window reaches
+    auto consumed = juce::jmin(positionIndex - (halfTaps - 1), numBuffered);
+
+    if (consumed > 0)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* samples = history.getWritePointer(channel);
+            std::memmove(samples, samples + consumed,
+                         static_cast<size_t>(numBuffered - consumed) * sizeof(float));
+        }
+
+        numBuffered -= consumed;
+        positionIndex -= consumed;
+    }
+
+    return numOutput;
+}
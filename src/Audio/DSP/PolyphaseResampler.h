@@ -0,0 +1,82 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+/**
+ * PolyphaseResampler converts audio between two sample rates with a
+ * band-limited (Kaiser-windowed sinc) filter.
+ *
+ * The filter is stored as a table of numPhases + 1 sub-filters; each output
+ * sample runs the two phases either side of its fractional position (four
+ * taps at a time, SSE/NEON/scalar as in MeterKernel) and interpolates between
+ * them, so any ratio works without a table per ratio. The read position is
+ * kept in 32.32 fixed point and never drifts. When downsampling the cutoff
+ * drops to the output Nyquist and the filter widens to match.
+ *
+ * Pull model: ask getInputNeeded() how much input the next numOutputSamples
+ * take, push exactly that through process(). Output sample n lines up with
+ * input time n * getRatio() (no latency), at the cost of reading half the
+ * filter ahead.
+ */
+class PolyphaseResampler
+{
+public:
+    enum class Quality
+    {
+        draft,    // 16 taps, for scrubbing and many voices
+        standard, // 32 taps, real-time playback
+        high      // 64 taps, offline renders and import
+    };
+
+    static constexpr int numPhases = 256;
+
+    PolyphaseResampler();
+
+    // Builds the filter and history for up to maxOutputSamples per process() call
+    // (not real-time safe)
+    void prepare(int numChannels, double inputRate, double outputRate, Quality quality,
+                 int maxOutputSamples);
+
+    // Forgets the history, as after a seek; real-time safe
+    void reset() noexcept;
+
+    int getNumChannels() const { return numChannels; }
+    int getNumTaps() const { return numTaps; }
+    double getRatio() const { return ratio; } // Input samples per output sample
+
+    // Most input getInputNeeded() can ask for at once; size input buffers with this
+    int getMaxInputSamples() const { return maxInputSamples; }
+
+    // Input samples (per channel) to push before numOutputSamples more can be produced
+    int getInputNeeded(int numOutputSamples) const noexcept;
+
+    // Appends numInput samples per channel, then writes up to maxOutput samples per
+    // channel. Returns the number written. Real-time safe.
+    int process(const float* const* input, int numInput, float* const* output,
+                int maxOutput) noexcept;
+
+    static int getBaseTaps(Quality quality) noexcept;
+
+private:
+    void buildFilter(Quality quality);
+
+    int numChannels = 0;
+    int numTaps = 0;
+    int halfTaps = 0;
+    double ratio = 1.0;
+    int maxInputSamples = 0;
+
+    // (numPhases + 1) rows of numTaps; row p is the filter for fractional offset p / numPhases
+    std::vector<float> coefficients;
+
+    // Buffered input per channel; index 0 is the oldest sample still needed
+    juce::AudioBuffer<float> history;
+    int numBuffered = 0;
+
+    juce::uint64 step = 0; // 32.32 fixed point
+    int positionIndex = 0; // History index of the sample at or before the next output
+    juce::uint32 positionFraction = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PolyphaseResampler)
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+#if JUCE_USE_SSE_INTRINSICS
+ #include <emmintrin.h>
+#elif JUCE_USE_ARM_NEON
+ #include <arm_neon.h>
+#endif
+
+/**
+ * Four-lane float vector helpers shared by the DSP kernels: SSE on Intel, NEON
+ * on ARM, and a plain struct elsewhere. Kernels are written once against these
+ * (see MeterKernel) and include this only from their .cpp files.
+ */
+namespace simd
+{
+#if JUCE_USE_SSE_INTRINSICS
+
+using Vec = __m128;
+
+inline Vec vecZero() noexcept { return _mm_setzero_ps(); }
+inline Vec vecBroadcast(float value) noexcept { return _mm_set1_ps(value); }
+inline Vec vecLoad(const float* p) noexcept { return _mm_loadu_ps(p); }
+inline Vec vecLoadAligned(const float* p) noexcept { return _mm_load_ps(p); }
+inline void vecStoreAligned(float* p, Vec v) noexcept { _mm_store_ps(p, v); }
+inline Vec vecAdd(Vec a, Vec b) noexcept { return _mm_add_ps(a, b); }
+inline Vec vecMul(Vec a, Vec b) noexcept { return _mm_mul_ps(a, b); }
+inline Vec vecMax(Vec a, Vec b) noexcept { return _mm_max_ps(a, b); }
+inline Vec vecMin(Vec a, Vec b) noexcept { return _mm_min_ps(a, b); }
+inline Vec vecAbs(Vec v) noexcept
+{
+    return _mm_and_ps(v, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)));
+}
+
+#elif JUCE_USE_ARM_NEON
+
+using Vec = float32x4_t;
+
+inline Vec vecZero() noexcept { return vdupq_n_f32(0.0f); }
+inline Vec vecBroadcast(float value) noexcept { return vdupq_n_f32(value); }
+inline Vec vecLoad(const float* p) noexcept { return vld1q_f32(p); }
+inline Vec vecLoadAligned(const float* p) noexcept { return vld1q_f32(p); }
+inline void vecStoreAligned(float* p, Vec v) noexcept { vst1q_f32(p, v); }
+inline Vec vecAdd(Vec a, Vec b) noexcept { return vaddq_f32(a, b); }
+inline Vec vecMul(Vec a, Vec b) noexcept { return vmulq_f32(a, b); }
+inline Vec vecMax(Vec a, Vec b) noexcept { return vmaxq_f32(a, b); }
+inline Vec vecMin(Vec a, Vec b) noexcept { return vminq_f32(a, b); }
+inline Vec vecAbs(Vec v) noexcept { return vabsq_f32(v); }
+
+#else
+
+struct Vec
+{
+    float lane[4];
+};
+
+inline Vec vecZero() noexcept { return {{0.0f, 0.0f, 0.0f, 0.0f}}; }
+inline Vec vecBroadcast(float value) noexcept { return {{value, value, value, value}}; }
+inline Vec vecLoad(const float* p) noexcept { return {{p[0], p[1], p[2], p[3]}}; }
+inline Vec vecLoadAligned(const float* p) noexcept { return vecLoad(p); }
+inline void vecStoreAligned(float* p, Vec v) noexcept { std::copy(v.lane, v.lane + 4, p); }
+
+template <typename Op>
+inline Vec vecApply(Vec a, Vec b, Op op) noexcept
+{
+    return {{op(a.lane[0], b.lane[0]), op(a.lane[1], b.lane[1]),
+             op(a.lane[2], b.lane[2]), op(a.lane[3], b.lane[3])}};
+}
+
+inline Vec vecAdd(Vec a, Vec b) noexcept { return vecApply(a, b, std::plus<float>()); }
+inline Vec vecMul(Vec a, Vec b) noexcept { return vecApply(a, b, std::multiplies<float>()); }
+inline Vec vecMax(Vec a, Vec b) noexcept
+{
+    return vecApply(a, b, [](float x, float y) { return juce::jmax(x, y); });
+}
+inline Vec vecMin(Vec a, Vec b) noexcept
+{
+    return vecApply(a, b, [](float x, float y) { return juce::jmin(x, y); });
+}
+inline Vec vecAbs(Vec v) noexcept
+{
+    return {{std::abs(v.lane[0]), std::abs(v.lane[1]), std::abs(v.lane[2]), std::abs(v.lane[3])}};
+}
+
+#endif
+
+inline float maxAcross(Vec v) noexcept
+{
+    alignas(16) float lanes[4];
+    vecStoreAligned(lanes, v);
+    return juce::jmax(juce::jmax(lanes[0], lanes[1]), juce::jmax(lanes[2], lanes[3]));
+}
+
+inline float minAcross(Vec v) noexcept
+{
+    alignas(16) float lanes[4];
+    vecStoreAligned(lanes, v);
+    return juce::jmin(juce::jmin(lanes[0], lanes[1]), juce::jmin(lanes[2], lanes[3]));
+}
+
+inline float sumAcross(Vec v) noexcept
+{
+    alignas(16) float lanes[4];
+    vecStoreAligned(lanes, v);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+} // namespace simd
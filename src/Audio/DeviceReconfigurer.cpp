@@ -0,0 +1,383 @@
+#include "DeviceReconfigurer.h"
+
+void DeviceReconfigurer::Request::mergeFrom(const Request& newer)
+{
+    if (newer.inputDevice)
+    {
+        inputDevice = newer.inputDevice;
+    }
+
+    if (newer.outputDevice)
+    {
+        outputDevice = newer.outputDevice;
+    }
+
+    if (newer.sampleRate)
+    {
+        sampleRate = newer.sampleRate;
+    }
+
+    if (newer.bufferSize)
+    {
+        bufferSize = newer.bufferSize;
+    }
+}
+
+bool DeviceReconfigurer::Request::isEmpty() const
+{
+    return !inputDevice && !outputDevice && !sampleRate && !bufferSize;
+}
+
+DeviceReconfigurer::DeviceReconfigurer(juce::AudioDeviceManager& manager,
+                                       juce::AudioIODeviceCallback& deviceCallback,
+                                       juce::CriticalSection& lock)
+    : juce::Thread("DAIW Device Reconfigurer"),
+      deviceManager(manager),
+      callback(deviceCallback),
+      deviceLock(lock)
+{
+}
+
+DeviceReconfigurer::~DeviceReconfigurer()
+{
+    cancelPendingUpdate();
+
+    // Never kill the worker halfway through a driver call; opening can take a while
+    stopThread(10000);
+}
+
+void DeviceReconfigurer::request(const Request& change)
+{
+    pending.mergeFrom(change);
+
+    // Otherwise it is picked up (and checked again) when the change in flight completes
+    if (!busy)
+    {
+        removeUnchanged(pending);
+
+        if (!pending.isEmpty())
+        {
+            beginChange();
+        }
+    }
+}
+
+void DeviceReconfigurer::removeUnchanged(Request& change) const
+{
+    // Only called while no change is in flight, so the worker isn't holding the lock
+    const juce::ScopedLock sl(deviceLock);
+    auto* device = deviceManager.getCurrentAudioDevice();
+
+    // With no device open, every field is a change
+    if (device == nullptr)
+    {
+        return;
+    }
+
+    auto setup = deviceManager.getAudioDeviceSetup();
+
+    if (change.inputDevice && *change.inputDevice == setup.inputDeviceName)
+    {
+        change.inputDevice.reset();
+    }
+
+    if (change.outputDevice && *change.outputDevice == setup.outputDeviceName)
+    {
+        change.outputDevice.reset();
+    }
+
+    if (change.sampleRate && std::abs(*change.sampleRate - device->getCurrentSampleRate()) < 1.0)
+    {
+        change.sampleRate.reset();
+    }
+
+    if (change.bufferSize && *change.bufferSize == device->getCurrentBufferSizeSamples())
+    {
+        change.bufferSize.reset();
+    }
+}
+
+void DeviceReconfigurer::setCallbackEnabled(bool shouldBeEnabled)
+{
+    if (callbackEnabled == shouldBeEnabled)
+    {
+        return;
+    }
+
+    callbackEnabled = shouldBeEnabled;
+
+    if (busy)
+    {
+        return;
+    }
+
+    if (callbackEnabled)
+    {
+        deviceManager.addAudioCallback(&callback);
+    }
+    else
+    {
+        deviceManager.removeAudioCallback(&callback);
+    }
+}
+
+void DeviceReconfigurer::beginChange()
+{
+    busy = true;
+
+    {
+        const juce::ScopedLock sl(stateLock);
+        active = pending;
+        progress = {};
+        progress.state = State::closing;
+    }
+
+    pending = {};
+
+    // Detach here so the audio thread is quiet (and releaseResources() has run on this
+    // thread) before the worker touches the device
+    deviceManager.removeAudioCallback(&callback);
+
+    changeReady = true;
+
+    if (!isThreadRunning())
+    {
+        startThread();
+    }
+
+    notify();
+}
+
+void DeviceReconfigurer::run()
+{
+    while (!threadShouldExit())
+    {
+        if (!changeReady.exchange(false))
+        {
+            wait(-1);
+            continue;
+        }
+
+        Request change;
+
+        {
+            const juce::ScopedLock sl(stateLock);
+            change = active;
+        }
+
+        applyChange(change);
+    }
+}
+
+void DeviceReconfigurer::applyChange(const Request& change)
+{
+    juce::String previousType;
+    juce::AudioDeviceManager::AudioDeviceSetup previous;
+    bool hadDevice = false;
+
+    {
+        const juce::ScopedLock sl(deviceLock);
+        previousType = deviceManager.getCurrentAudioDeviceType();
+        previous = deviceManager.getAudioDeviceSetup();
+        hadDevice = deviceManager.getCurrentAudioDevice() != nullptr;
+    }
+
+    // Device lists span every device type, but a setup only applies within one type,
+    // so switch to whichever type owns the chosen device (an output choice wins)
+    auto typeName = previousType;
+
+    if (change.inputDevice)
+    {
+        typeName = findDeviceTypeFor(*change.inputDevice, true, typeName);
+    }
+
+    if (change.outputDevice)
+    {
+        typeName = findDeviceTypeFor(*change.outputDevice, false, typeName);
+    }
+
+    // No explicit close: setAudioDeviceSetup() only reopens what the new setup changes
+    // (a rate or buffer size change restarts the same device in place)
+    auto target = change.outputDevice.value_or(change.inputDevice.value_or(
+        previous.outputDeviceName));
+    setState(State::opening, "Opening " + target);
+
+    juce::String error;
+
+    {
+        const juce::ScopedLock sl(deviceLock);
+
+        if (typeName != deviceManager.getCurrentAudioDeviceType())
+        {
+            DBG("DeviceReconfigurer: Switching device type to " + typeName);
+            deviceManager.setCurrentAudioDeviceType(typeName, true);
+        }
+
+        // Start from the current setup: after a type switch that holds the new type's
+        // defaults for whatever wasn't asked for
+        auto setup = deviceManager.getAudioDeviceSetup();
+        auto* type = deviceManager.getCurrentDeviceTypeObject();
+        auto combined = type != nullptr && !type->hasSeparateInputsAndOutputs();
+
+        if (change.inputDevice)
+        {
+            setup.inputDeviceName = *change.inputDevice;
+            setup.useDefaultInputChannels = true;
+
+            // Combined input/output devices (e.g. the virtual device) open as a pair
+            if (combined)
+            {
+                setup.outputDeviceName = *change.inputDevice;
+            }
+        }
+
+        if (change.outputDevice)
+        {
+            setup.outputDeviceName = *change.outputDevice;
+            setup.useDefaultOutputChannels = true;
+
+            if (combined)
+            {
+                setup.inputDeviceName = *change.outputDevice;
+            }
+        }
+
+        setup.sampleRate = change.sampleRate.value_or(setup.sampleRate);
+        setup.bufferSize = change.bufferSize.value_or(setup.bufferSize);
+
+        error = deviceManager.setAudioDeviceSetup(setup, true);
+
+        if (error.isEmpty() && deviceManager.getCurrentAudioDevice() == nullptr)
+        {
+            error = "Could not open " + target;
+        }
+    }
+
+    if (error.isEmpty())
+    {
+        setState(State::prepared, target);
+        return;
+    }
+
+    DBG("DeviceReconfigurer: " + error + ", restoring the previous setup");
+    setState(State::rollingBack, "Restoring " + previous.outputDeviceName);
+
+    juce::String rollbackError = hadDevice ? juce::String() : "No previous device";
+
+    if (hadDevice)
+    {
+        const juce::ScopedLock sl(deviceLock);
+
+        if (previousType != deviceManager.getCurrentAudioDeviceType())
+        {
+            deviceManager.setCurrentAudioDeviceType(previousType, true);
+        }
+
+        rollbackError = deviceManager.setAudioDeviceSetup(previous, true);
+    }
+
+    {
+        const juce::ScopedLock sl(stateLock);
+        progress.error = error;
+        progress.rolledBack = rollbackError.isEmpty();
+    }
+
+    if (rollbackError.isEmpty())
+    {
+        setState(State::prepared, previous.outputDeviceName);
+    }
+    else
+    {
+        DBG("DeviceReconfigurer: Rollback failed: " + rollbackError);
+        setState(State::failed, rollbackError);
+    }
+}
+
+juce::String DeviceReconfigurer::findDeviceTypeFor(const juce::String& deviceName, bool isInput,
+                                                   const juce::String& fallback) const
+{
+    const juce::ScopedLock sl(deviceLock);
+
+    for (auto* type : deviceManager.getAvailableDeviceTypes())
+    {
+        if (type->getDeviceNames(isInput).contains(deviceName))
+        {
+            return type->getTypeName();
+        }
+    }
+
+    return fallback;
+}
+
+void DeviceReconfigurer::setState(State newState, const juce::String& description)
+{
+    {
+        const juce::ScopedLock sl(stateLock);
+        progress.state = newState;
+        progress.description = description;
+    }
+
+    triggerAsyncUpdate();
+}
+
+void DeviceReconfigurer::handleAsyncUpdate()
+{
+    Progress current;
+
+    {
+        const juce::ScopedLock sl(stateLock);
+        current = progress;
+    }
+
+    // A stale update from a change that has already completed
+    if (!busy)
+    {
+        return;
+    }
+
+    if (current.state == State::prepared || current.state == State::failed)
+    {
+        removeUnchanged(pending);
+
+        // Merged requests go straight on; no point preparing the engine in between
+        if (!pending.isEmpty())
+        {
+            lastProgress = current;
+            listeners.call([&current](Listener& l) { l.deviceReconfigurationChanged(current); });
+            beginChange();
+            return;
+        }
+
+        // prepareToPlay() runs here, on the message thread, as it always has
+        if (callbackEnabled)
+        {
+            deviceManager.addAudioCallback(&callback);
+        }
+
+        busy = false;
+
+        if (current.state == State::prepared)
+        {
+            current.state = State::running;
+        }
+    }
+
+    lastProgress = current;
+    listeners.call([&current](Listener& l) { l.deviceReconfigurationChanged(current); });
+}
+
+juce::String DeviceReconfigurer::getStateName(State state)
+{
+    switch (state)
+    {
+        case State::idle: return "Idle";
+        case State::closing: return "Closing";
+        case State::opening: return "Opening";
+        case State::rollingBack: return "Rolling back";
+        case State::prepared: return "Prepared";
+        case State::running: return "Running";
+        case State::failed: return "Failed";
+    }
+
+    return {};
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <atomic>
+#include <optional>
+
+/**
+ * DeviceReconfigurer changes the audio device setup without blocking the
+ * message thread.
+ *
+ * Opening a device (a USB interface in particular) can take hundreds of
+ * milliseconds, so each change runs as a small state machine: the audio
+ * callback is detached on the message thread, a worker thread applies the new
+ * setup (reopening only what it changes), and once it is prepared the callback
+ * is attached again back on the message thread (so prepareToPlay still runs
+ * there). If the new setup fails to open, the worker reopens the last setup
+ * that worked.
+ *
+ * Anything a request asks for that the device already has is dropped, and a
+ * request left with nothing to change never touches the device. Requests
+ * arriving while a change is in flight are merged into one pending request,
+ * which runs as soon as the current change is done. Every device
+ * manager call the worker makes happens under the device lock, which message
+ * thread readers only ever try-lock.
+ */
+class DeviceReconfigurer : private juce::Thread, private juce::AsyncUpdater
+{
+public:
+    enum class State
+    {
+        idle,
+        closing,
+        opening,
+        rollingBack,
+        prepared,
+        running,
+        failed
+    };
+
+    // A partial setup: anything left unset keeps its current value
+    struct Request
+    {
+        std::optional<juce::String> inputDevice;
+        std::optional<juce::String> outputDevice;
+        std::optional<double> sampleRate;
+        std::optional<int> bufferSize;
+
+        // Fields set in 'newer' win
+        void mergeFrom(const Request& newer);
+        bool isEmpty() const;
+    };
+
+    struct Progress
+    {
+        State state = State::idle;
+        juce::String description;
+        juce::String error; // Set when the request failed (rolledBack says whether we recovered)
+        bool rolledBack = false;
+    };
+
+    class Listener
+    {
+    public:
+        virtual ~Listener() = default;
+
+        // Message thread
+        virtual void deviceReconfigurationChanged(const Progress& progress) = 0;
+    };
+
+    DeviceReconfigurer(juce::AudioDeviceManager& deviceManager,
+                       juce::AudioIODeviceCallback& callback, juce::CriticalSection& deviceLock);
+    ~DeviceReconfigurer() override;
+
+    // Message thread: queues a change (merged with any that hasn't started yet)
+    void request(const Request& change);
+
+    // Message thread: whether the callback should be attached to the device.
+    // While a change is in flight this only takes effect once it completes.
+    void setCallbackEnabled(bool shouldBeEnabled);
+
+    // Message thread
+    bool isBusy() const { return busy; }
+    Progress getProgress() const { return lastProgress; }
+
+    void addListener(Listener* listener) { listeners.add(listener); }
+    void removeListener(Listener* listener) { listeners.remove(listener); }
+
+    static juce::String getStateName(State state);
+
+private:
+    void removeUnchanged(Request& change) const;
+    void beginChange();
+    void run() override;
+    void applyChange(const Request& change);
+    juce::String findDeviceTypeFor(const juce::String& deviceName, bool isInput,
+                                   const juce::String& fallback) const;
+    void setState(State newState, const juce::String& description);
+    void handleAsyncUpdate() override;
+
+    juce::AudioDeviceManager& deviceManager;
+    juce::AudioIODeviceCallback& callback;
+    juce::CriticalSection& deviceLock;
+
+    // Message thread
+    Request pending;
+    bool busy = false;
+    bool callbackEnabled = false;
+    Progress lastProgress;
+    juce::ListenerList<Listener> listeners;
+
+    // Handed from the message thread to the worker, and progress back the other way
+    juce::CriticalSection stateLock;
+    Request active;
+    Progress progress;
+    std::atomic<bool> changeReady{false};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeviceReconfigurer)
+};
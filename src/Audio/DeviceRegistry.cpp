@@ -0,0 +1,502 @@
+#include "DeviceRegistry.h"
+
+#if JUCE_LINUX
+ #include <fcntl.h>
+ #include <poll.h>
+ #include <sys/inotify.h>
+ #include <unistd.h>
+
+/**
+ * Watches /dev/snd, where ALSA adds and removes device nodes as cards come
+ * and go, and calls back once a burst of changes has settled. Blocks in
+ * poll() in between, so an idle system costs nothing.
+ */
+class DeviceRegistry::HotPlugWatcher : private juce::Thread
+{
+public:
+    explicit HotPlugWatcher(std::function<void()> changed)
+        : juce::Thread("DAIW Hot-Plug Watcher"), onChange(std::move(changed))
+    {
+    }
+
+    ~HotPlugWatcher() override
+    {
+        stop();
+    }
+
+    // False if there is nothing to watch (no sound devices, or no inotify)
+    bool start()
+    {
+        notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+        if (notifyFd < 0 || pipe2(wakePipe, O_CLOEXEC) != 0)
+        {
+            stop();
+            return false;
+        }
+
+        // Attribute changes too: udev fixes a new node's permissions after creating it
+        if (inotify_add_watch(notifyFd, "/dev/snd", IN_CREATE | IN_DELETE | IN_ATTRIB) < 0)
+        {
+            stop();
+            return false;
+        }
+
+        startThread(juce::Thread::Priority::low);
+        return true;
+    }
+
+    void stop()
+    {
+        if (isThreadRunning())
+        {
+            signalThreadShouldExit();
+            [[maybe_unused]] auto written = write(wakePipe[1], "x", 1);
+            stopThread(4000);
+        }
+
+        for (auto* fd : {&notifyFd, &wakePipe[0], &wakePipe[1]})
+        {
+            if (*fd >= 0)
+            {
+                close(*fd);
+                *fd = -1;
+            }
+        }
+    }
+
+private:
+    static constexpr int settleMs = 500;
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            if (!waitForEvents(-1))
+            {
+                continue;
+            }
+
+            // A card brings several nodes, and their permissions follow: wait for quiet
+            while (!threadShouldExit() && waitForEvents(settleMs))
+            {
+            }
+
+            if (!threadShouldExit())
+            {
+                onChange();
+            }
+        }
+    }
+
+    // Returns true if something changed in /dev/snd (the events are read and dropped)
+    bool waitForEvents(int timeoutMs)
+    {
+        pollfd fds[] = {{notifyFd, POLLIN, 0}, {wakePipe[0], POLLIN, 0}};
+
+        if (poll(fds, 2, timeoutMs) <= 0 || (fds[0].revents & POLLIN) == 0)
+        {
+            return false;
+        }
+
+        char events[4096];
+
+        while (read(notifyFd, events, sizeof(events)) > 0)
+        {
+        }
+
+        return true;
+    }
+
+    std::function<void()> onChange;
+    int notifyFd = -1;
+    int wakePipe[2] = {-1, -1};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HotPlugWatcher)
+};
+#endif
+
+bool DeviceRegistry::Device::isSameDevice(const Device& other) const
+{
+    return typeName == other.typeName && name == other.name;
+}
+
+bool DeviceRegistry::Device::operator==(const Device& other) const
+{
+    return isSameDevice(other) && isInput == other.isInput && isOutput == other.isOutput &&
+           sampleRates == other.sampleRates && bufferSizes == other.bufferSizes;
+}
+
+DeviceRegistry::DeviceRegistry(juce::AudioDeviceManager& manager, juce::CriticalSection& lock)
+    : juce::Thread("DAIW Device Registry"), deviceManager(manager), deviceLock(lock)
+{
+}
+
+DeviceRegistry::~DeviceRegistry()
+{
+    stop();
+}
+
+void DeviceRegistry::start()
+{
+    if (isThreadRunning())
+    {
+        return;
+    }
+
+    {
+        const juce::ScopedLock sl(deviceLock);
+
+        for (auto* type : deviceManager.getAvailableDeviceTypes())
+        {
+            type->addListener(this);
+            watchedTypes.push_back(type);
+        }
+    }
+
+#if JUCE_LINUX
+    hotPlugWatcher = std::make_unique<HotPlugWatcher>([this] { refresh(); });
+
+    if (!hotPlugWatcher->start())
+    {
+        DBG("DeviceRegistry: Can't watch /dev/snd; devices only rescan on refresh()");
+        hotPlugWatcher.reset();
+    }
+#endif
+
+    startThread(juce::Thread::Priority::low);
+}
+
+void DeviceRegistry::stop()
+{
+#if JUCE_LINUX
+    hotPlugWatcher.reset();
+#endif
+
+    stopThread(4000);
+    cancelPendingUpdate();
+
+    for (auto* type : watchedTypes)
+    {
+        type->removeListener(this);
+    }
+
+    watchedTypes.clear();
+}
+
+std::unique_ptr<juce::XmlElement> DeviceRegistry::createXml() const
+{
+    auto xml = std::make_unique<juce::XmlElement>("DEVICES");
+
+    for (const auto& device : delivered)
+    {
+        juce::StringArray rates, sizes;
+
+        for (auto rate : device.sampleRates)
+        {
+            rates.add(juce::String(rate));
+        }
+
+        for (auto size : device.bufferSizes)
+        {
+            sizes.add(juce::String(size));
+        }
+
+        auto* child = xml->createNewChildElement("DEVICE");
+        child->setAttribute("type", device.typeName);
+        child->setAttribute("name", device.name);
+        child->setAttribute("input", device.isInput);
+        child->setAttribute("output", device.isOutput);
+        child->setAttribute("sampleRates", rates.joinIntoString(" "));
+        child->setAttribute("bufferSizes", sizes.joinIntoString(" "));
+    }
+
+    return xml;
+}
+
+void DeviceRegistry::restoreFromXml(const juce::XmlElement& xml)
+{
+    jassert(!isThreadRunning());
+
+    delivered.clear();
+    probed.clear();
+
+    for (auto* child : xml.getChildWithTagNameIterator("DEVICE"))
+    {
+        Device device;
+        device.typeName = child->getStringAttribute("type");
+        device.name = child->getStringAttribute("name");
+        device.isInput = child->getBoolAttribute("input");
+        device.isOutput = child->getBoolAttribute("output");
+
+        for (const auto& rate : juce::StringArray::fromTokens(
+                 child->getStringAttribute("sampleRates"), false))
+        {
+            device.sampleRates.add(rate.getDoubleValue());
+        }
+
+        for (const auto& size : juce::StringArray::fromTokens(
+                 child->getStringAttribute("bufferSizes"), false))
+        {
+            device.bufferSizes.add(size.getIntValue());
+        }
+
+        delivered.push_back(device);
+        probed[device.typeName + "|" + device.name] = device;
+    }
+
+    // The first scan then reports only what changed while the app wasn't running
+    const juce::ScopedLock sl(publishLock);
+    published = std::make_shared<const DeviceList>(delivered);
+}
+
+juce::StringArray DeviceRegistry::getDeviceNames(bool isInput) const
+{
+    juce::StringArray names;
+
+    for (const auto& device : delivered)
+    {
+        if (isInput ? device.isInput : device.isOutput)
+        {
+            names.add(device.name);
+        }
+    }
+
+    return names;
+}
+
+const DeviceRegistry::Device* DeviceRegistry::findDevice(const juce::String& typeName,
+                                                         const juce::String& name) const
+{
+    for (const auto& device : delivered)
+    {
+        if (device.typeName == typeName && device.name == name)
+        {
+            return &device;
+        }
+    }
+
+    return nullptr;
+}
+
+DeviceRegistry::Diff DeviceRegistry::compare(const std::vector<Device>& before,
+                                             const std::vector<Device>& after)
+{
+    Diff diff;
+
+    for (const auto& device : after)
+    {
+        auto matches = [&device](const Device& d) { return d.isSameDevice(device); };
+        auto previous = std::find_if(before.begin(), before.end(), matches);
+
+        if (previous == before.end())
+        {
+            diff.added.push_back(device);
+        }
+        else if (*previous != device)
+        {
+            diff.changed.push_back(device);
+        }
+    }
+
+    for (const auto& device : before)
+    {
+        auto matches = [&device](const Device& d) { return d.isSameDevice(device); };
+
+        if (std::none_of(after.begin(), after.end(), matches))
+        {
+            diff.removed.push_back(device);
+        }
+    }
+
+    return diff;
+}
+
+void DeviceRegistry::refresh()
+{
+    rescanRequested = true;
+    notify();
+}
+
+void DeviceRegistry::run()
+{
+    // The manager scanned every type as it started, so the first pass only reads the names
+    scan(false);
+
+    while (!threadShouldExit())
+    {
+        wait(-1);
+
+        // A type's own hot-plug notification means it has already rescanned itself
+        if (!threadShouldExit())
+        {
+            scan(rescanRequested.exchange(false));
+        }
+    }
+}
+
+void DeviceRegistry::scan(bool rescanTypes)
+{
+    DeviceList found;
+    juce::Array<juce::AudioIODeviceType*> types;
+
+    {
+        const juce::ScopedLock sl(deviceLock);
+
+        for (auto* type : deviceManager.getAvailableDeviceTypes())
+        {
+            types.add(type);
+        }
+    }
+
+    for (auto* type : types)
+    {
+        juce::StringArray inputs, outputs;
+
+        {
+            // One type at a time, so a device change never waits for a whole scan
+            const juce::ScopedLock sl(deviceLock);
+
+            if (rescanTypes)
+            {
+                type->scanForDevices();
+            }
+
+            inputs = type->getDeviceNames(true);
+            outputs = type->getDeviceNames(false);
+        }
+
+        auto typeName = type->getTypeName();
+        auto add = [&found, &typeName](const juce::String& name, bool isInput)
+        {
+            auto existing = std::find_if(found.begin(), found.end(), [&](const Device& d)
+                                         { return d.typeName == typeName && d.name == name; });
+
+            if (existing == found.end())
+            {
+                found.push_back({typeName, name});
+                existing = found.end() - 1;
+            }
+
+            (isInput ? existing->isInput : existing->isOutput) = true;
+        };
+
+        for (const auto& name : inputs)
+        {
+            add(name, true);
+        }
+
+        for (const auto& name : outputs)
+        {
+            add(name, false);
+        }
+
+        // Capabilities only need probing the first time a device (or direction) shows up
+        for (auto& device : found)
+        {
+            if (threadShouldExit())
+            {
+                return;
+            }
+
+            if (device.typeName != typeName)
+            {
+                continue;
+            }
+
+            auto key = typeName + "|" + device.name;
+            auto cached = probed.find(key);
+
+            if (cached != probed.end() && cached->second.isInput == device.isInput &&
+                cached->second.isOutput == device.isOutput)
+            {
+                device = cached->second;
+                continue;
+            }
+
+            probe(*type, device);
+            probed[key] = device;
+        }
+    }
+
+    // Forget devices that are gone, so one plugged back in is probed afresh
+    for (auto it = probed.begin(); it != probed.end();)
+    {
+        auto stillThere = std::any_of(found.begin(), found.end(), [&it](const Device& d)
+                                      { return d.typeName + "|" + d.name == it->first; });
+        it = stillThere ? std::next(it) : probed.erase(it);
+    }
+
+    {
+        const juce::ScopedLock sl(publishLock);
+
+        if (published != nullptr && *published == found)
+        {
+            return;
+        }
+
+        published = std::make_shared<const DeviceList>(std::move(found));
+    }
+
+    triggerAsyncUpdate();
+}
+
+void DeviceRegistry::probe(juce::AudioIODeviceType& type, Device& device)
+{
+    const juce::ScopedLock sl(deviceLock);
+
+    // The open device can't always be opened twice, so ask it directly
+    if (auto* current = deviceManager.getCurrentAudioDevice())
+    {
+        auto setup = deviceManager.getAudioDeviceSetup();
+
+        if (current->getTypeName() == device.typeName &&
+            (setup.inputDeviceName == device.name || setup.outputDeviceName == device.name))
+        {
+            device.sampleRates = current->getAvailableSampleRates();
+            device.bufferSizes = current->getAvailableBufferSizes();
+            return;
+        }
+    }
+
+    // Some backends open the device to answer this (ALSA opens the PCM in the device's
+    // constructor), which is why it only happens the first time a device is seen
+    std::unique_ptr<juce::AudioIODevice> instance(
+        type.createDevice(device.isOutput ? device.name : juce::String(),
+                          device.isInput ? device.name : juce::String()));
+
+    if (instance != nullptr)
+    {
+        device.sampleRates = instance->getAvailableSampleRates();
+        device.bufferSizes = instance->getAvailableBufferSizes();
+    }
+}
+
+void DeviceRegistry::handleAsyncUpdate()
+{
+    std::shared_ptr<const DeviceList> latest;
+
+    {
+        const juce::ScopedLock sl(publishLock);
+        latest = published;
+    }
+
+    if (latest == nullptr)
+    {
+        return;
+    }
+
+    // Scans that landed between two updates fold into one diff
+    auto diff = compare(delivered, *latest);
+    delivered = *latest;
+
+    if (!diff.isEmpty())
+    {
+        listeners.call([&diff](Listener& l) { l.deviceListChanged(diff); });
+    }
+}
+
+void DeviceRegistry::audioDeviceListChanged()
+{
+    notify();
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+/**
+ * DeviceRegistry keeps a cached list of every audio device, with the sample
+ * rates and buffer sizes each one supports.
+ *
+ * Enumerating devices can be slow (ALSA and JACK on Linux especially), so it
+ * only happens on a background thread: once at start-up, again whenever a
+ * device type reports a hot-plug, and when refresh() asks for it. Linux
+ * backends don't report hot-plugs, so there /dev/snd is watched with inotify
+ * instead, and a change there triggers the rescan. Devices are only probed
+ * for their capabilities the first time they appear. The message thread
+ * reads the cache for free and is told only what was added, removed or
+ * changed.
+ *
+ * The list can be saved and restored across runs, so a cold start has the
+ * device list straight away and only probes devices it hasn't seen before.
+ *
+ * The device types belong to the device manager, so every call into them is
+ * made under the engine's device lock.
+ */
+class DeviceRegistry : private juce::Thread,
+                       private juce::AsyncUpdater,
+                       private juce::AudioIODeviceType::Listener
+{
+public:
+    struct Device
+    {
+        juce::String typeName;
+        juce::String name;
+        bool isInput = false;
+        bool isOutput = false;
+        juce::Array<double> sampleRates;
+        juce::Array<int> bufferSizes;
+
+        bool isSameDevice(const Device& other) const;
+        bool operator==(const Device& other) const;
+        bool operator!=(const Device& other) const { return !(*this == other); }
+    };
+
+    struct Diff
+    {
+        std::vector<Device> added;
+        std::vector<Device> removed;
+        std::vector<Device> changed; // Same device, new capabilities or direction
+
+        bool isEmpty() const { return added.empty() && removed.empty() && changed.empty(); }
+    };
+
+    class Listener
+    {
+    public:
+        virtual ~Listener() = default;
+
+        // Message thread
+        virtual void deviceListChanged(const Diff& diff) = 0;
+    };
+
+    DeviceRegistry(juce::AudioDeviceManager& deviceManager, juce::CriticalSection& deviceLock);
+    ~DeviceRegistry() override;
+
+    // Message thread, once the manager has created its device types
+    void start();
+    void stop();
+
+    // Any thread: asks every device type to rescan (e.g. when the device settings open)
+    void refresh();
+
+    // Message thread: the cached list; restore before start()
+    std::unique_ptr<juce::XmlElement> createXml() const;
+    void restoreFromXml(const juce::XmlElement& xml);
+
+    // Message thread: the list as of the last change listeners were told about
+    const std::vector<Device>& getDevices() const { return delivered; }
+    juce::StringArray getDeviceNames(bool isInput) const;
+    const Device* findDevice(const juce::String& typeName, const juce::String& name) const;
+
+    void addListener(Listener* listener) { listeners.add(listener); }
+    void removeListener(Listener* listener) { listeners.remove(listener); }
+
+    static Diff compare(const std::vector<Device>& before, const std::vector<Device>& after);
+
+private:
+    using DeviceList = std::vector<Device>;
+
+    void run() override;
+    void scan(bool rescanTypes);
+    void probe(juce::AudioIODeviceType& type, Device& device);
+    void handleAsyncUpdate() override;
+    void audioDeviceListChanged() override;
+
+    juce::AudioDeviceManager& deviceManager;
+    juce::CriticalSection& deviceLock;
+
+    // Scanner thread
+    std::map<juce::String, Device> probed; // By type and name
+    std::atomic<bool> rescanRequested{false};
+
+#if JUCE_LINUX
+    class HotPlugWatcher;
+    std::unique_ptr<HotPlugWatcher> hotPlugWatcher;
+#endif
+
+    // Handed from the scanner to the message thread
+    juce::CriticalSection publishLock;
+    std::shared_ptr<const DeviceList> published;
+
+    // Message thread
+    std::vector<juce::AudioIODeviceType*> watchedTypes;
+    DeviceList delivered;
+    juce::ListenerList<Listener> listeners;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeviceRegistry)
+};
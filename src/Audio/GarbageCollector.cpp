@@ -0,0 +1,60 @@
+#include "GarbageCollector.h"
+
+GarbageCollector::GarbageCollector(int capacity)
+    : juce::Thread("DAIW Garbage Collector"), fifo(capacity), items(static_cast<size_t>(capacity))
+{
+    startThread(juce::Thread::Priority::low);
+}
+
+GarbageCollector::~GarbageCollector()
+{
+    stopThread(2000);
+    collect();
+}
+
+bool GarbageCollector::push(const Item& item) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 + size2 < 1)
+    {
+        return false;
+    }
+
+    items[static_cast<size_t>(size1 > 0 ? start1 : start2)] = item;
+    fifo.finishedWrite(1);
+    return true;
+}
+
+void GarbageCollector::collect()
+{
+    const juce::ScopedLock sl(collectLock);
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+
+    auto destroy = [this](int start, int size)
+    {
+        for (int i = start; i < start + size; ++i)
+        {
+            auto& item = items[static_cast<size_t>(i)];
+            item.destroy(item.object);
+            item = {};
+        }
+    };
+
+    destroy(start1, size1);
+    destroy(start2, size2);
+    fifo.finishedRead(size1 + size2);
+}
+
+void GarbageCollector::run()
+{
+    // The audio thread never signals (that could block it), so poll
+    while (!threadShouldExit())
+    {
+        collect();
+        wait(20);
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <vector>
+
+/**
+ * GarbageCollector deletes objects the audio thread has finished with.
+ *
+ * The audio thread must never free memory, so anything it lets go of (a
+ * replaced execution plan and the nodes only that plan still held) is handed
+ * to retire(), which only writes a pointer into a preallocated lock-free
+ * queue. A low-priority thread wakes every few milliseconds and runs the
+ * deleters. One producer: the audio thread.
+ */
+class GarbageCollector : private juce::Thread
+{
+public:
+    explicit GarbageCollector(int capacity = 1024);
+    ~GarbageCollector() override;
+
+    // Audio thread: queues the object for deletion. Returns false, leaving the
+    // caller owning it, if the queue is full.
+    template <typename ObjectType>
+    bool retire(ObjectType* object) noexcept
+    {
+        return push({object, [](void* o) { delete static_cast<ObjectType*>(o); }});
+    }
+
+    // Deletes everything queued so far on the calling thread
+    void collect();
+
+    int getNumPending() const { return fifo.getNumReady(); }
+
+private:
+    struct Item
+    {
+        void* object = nullptr;
+        void (*destroy)(void*) = nullptr;
+    };
+
+    bool push(const Item& item) noexcept;
+    void run() override;
+
+    juce::AbstractFifo fifo;
+    std::vector<Item> items;
+    juce::CriticalSection collectLock; // The collector thread and explicit collect() calls
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GarbageCollector)
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <atomic>
+
+/**
+ * AudioNode is one unit of work in the mix graph (a track, later buses and plugins).
+ *
+ * process() runs on the audio thread or on one of the real-time pool workers,
+ * possibly at the same time as other nodes, so a node must only touch its own
+ * state and the buffer it is given.
+ *
+ * Mixer parameters are changed through MixGraph, which records the value here
+ * for the message thread and queues it for the audio thread; parameterChanged()
+ * then receives it at the start of a block, before any node runs.
+ *
+ * A node whose processing delays its signal (a plugin with lookahead) reports
+ * it with setLatencySamples(); MixGraph notices and delays the other paths to
+ * match (see LatencyCompensation).
+ */
+class AudioNode
+{
+public:
+    enum class Parameter
+    {
+        gain,
+        pan,
+        mute,
+        solo
+    };
+
+    static constexpr int numParameters = 4;
+
+    virtual ~AudioNode() = default;
+
+    // Message thread (or the audio thread while it is stopped)
+    virtual void prepareToPlay(double sampleRate, int maximumBlockSize) = 0;
+    virtual void releaseResources() {}
+
+    // Real-time: renders or processes numSamples in place
+    virtual void process(juce::AudioBuffer<float>& buffer, int numSamples) noexcept = 0;
+
+    // Audio thread, between blocks: applies a parameter change
+    virtual void parameterChanged(Parameter parameter, float value) noexcept = 0;
+
+    // Any thread: the delay this node's processing adds, in samples
+    int getLatencySamples() const { return latencySamples.load(std::memory_order_relaxed); }
+    void setLatencySamples(int samples)
+    {
+        latencySamples.store(juce::jmax(0, samples), std::memory_order_relaxed);
+    }
+
+    // Message thread: the value last set through MixGraph
+    float getParameter(Parameter parameter) const
+    {
+        return parameters[static_cast<int>(parameter)];
+    }
+
+private:
+    friend class MixGraph;
+
+    float parameters[numParameters] = {1.0f, 0.0f, 0.0f, 0.0f};
+    std::atomic<int> latencySamples{0};
+};
@@ -0,0 +1,55 @@
+#include "Bus.h"
+
+Bus::Bus(const juce::String& busName) : name(busName)
+{
+}
+
+Bus::~Bus() = default;
+
+void Bus::prepareToPlay(double sampleRate, int /*maximumBlockSize*/)
+{
+    level.reset(sampleRate, smoothingSeconds);
+}
+
+void Bus::parameterChanged(Parameter parameter, float value) noexcept
+{
+    if (parameter == Parameter::gain)
+    {
+        targetGain = value;
+    }
+    else if (parameter == Parameter::mute)
+    {
+        muted = value != 0.0f;
+    }
+
+    level.setTargetValue(muted ? 0.0f : targetGain);
+}
+
+void Bus::process(juce::AudioBuffer<float>& buffer, int numSamples) noexcept
+{
+    if (!level.isSmoothing())
+    {
+        auto gain = level.getCurrentValue();
+
+        if (gain != 1.0f)
+        {
+            buffer.applyGain(0, numSamples, gain);
+        }
+
+        return;
+    }
+
+    // Ramping: the same per-sample gain on every channel
+    auto numChannels = buffer.getNumChannels();
+    auto* const* channels = buffer.getArrayOfWritePointers();
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto gain = level.getNextValue();
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            channels[channel][i] *= gain;
+        }
+    }
+}
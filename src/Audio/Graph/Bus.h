@@ -0,0 +1,39 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "AudioNode.h"
+
+/**
+ * Bus processes the sum of everything routed into it (group buses, effect
+ * returns and the master). Gain and mute are set through MixGraph and
+ * smoothed sample by sample.
+ */
+class Bus : public AudioNode
+{
+public:
+    explicit Bus(const juce::String& name);
+    ~Bus() override;
+
+    const juce::String& getName() const { return name; }
+
+    // Message thread: the values last set through MixGraph
+    float getGain() const { return getParameter(Parameter::gain); }
+    bool isMuted() const { return getParameter(Parameter::mute) != 0.0f; }
+
+    // AudioNode
+    void prepareToPlay(double sampleRate, int maximumBlockSize) override;
+    void process(juce::AudioBuffer<float>& buffer, int numSamples) noexcept override;
+    void parameterChanged(Parameter parameter, float value) noexcept override;
+
+    static constexpr double smoothingSeconds = 0.02;
+
+private:
+    const juce::String name;
+
+    // Audio thread state: gain with mute folded in
+    float targetGain = 1.0f;
+    bool muted = false;
+    juce::SmoothedValue<float> level{1.0f};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Bus)
+};
@@ -0,0 +1,84 @@
+#include "CompensationDelay.h"
+
+CompensationDelay::CompensationDelay(int numChannels, int capacity)
+{
+    auto size = juce::nextPowerOfTwo(juce::jmax(1, capacity) + maxBlockSize);
+    buffer.setSize(numChannels, size);
+    buffer.clear();
+    mask = size - 1;
+}
+
+void CompensationDelay::processAdd(const juce::AudioBuffer<float>& source,
+                                   juce::AudioBuffer<float>& destination, int numSamples,
+                                   int delaySamples, float gain) noexcept
+{
+    delaySamples = juce::jlimit(0, getCapacity(), delaySamples);
+
+    for (int offset = 0; offset < numSamples; offset += maxBlockSize)
+    {
+        processChunk(source, destination, offset, juce::jmin(maxBlockSize, numSamples - offset),
+                     delaySamples, gain);
+
+        // Only the first chunk crossfades
+        currentDelay = delaySamples;
+    }
+}
+
+void CompensationDelay::processChunk(const juce::AudioBuffer<float>& source,
+                                     juce::AudioBuffer<float>& destination, int offset,
+                                     int numSamples, int delaySamples, float gain) noexcept
+{
+    auto size = mask + 1;
+    auto numChannels = juce::jmin(buffer.getNumChannels(), source.getNumChannels(),
+                                  destination.getNumChannels());
+
+    // Contiguous runs from position, split where the ring wraps
+    auto forEachRun = [size, numSamples](int position, auto&& function)
+    {
+        auto first = juce::jmin(numSamples, size - position);
+        function(position, 0, first);
+
+        if (first < numSamples)
+        {
+            function(0, first, numSamples - first);
+        }
+    };
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* line = buffer.getWritePointer(channel);
+        const auto* input = source.getReadPointer(channel, offset);
+        auto* output = destination.getWritePointer(channel, offset);
+
+        // Write first, so a delay of zero reads back this very block
+        forEachRun(writePosition, [line, input](int position, int start, int count)
+                   { juce::FloatVectorOperations::copy(line + position, input + start, count); });
+
+        auto readPosition = (writePosition - delaySamples + size) & mask;
+
+        if (delaySamples == currentDelay)
+        {
+            forEachRun(readPosition, [line, output, gain](int position, int start, int count)
+                       {
+                           juce::FloatVectorOperations::addWithMultiply(output + start,
+                                                                        line + position, gain,
+                                                                        count);
+                       });
+            continue;
+        }
+
+        // The delay changed: fade from the old tap to the new one over this chunk
+        auto oldPosition = (writePosition - currentDelay + size) & mask;
+        auto step = 1.0f / static_cast<float>(numSamples);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto fade = static_cast<float>(i + 1) * step;
+            auto oldSample = line[(oldPosition + i) & mask];
+            auto newSample = line[(readPosition + i) & mask];
+            output[i] += gain * (oldSample + fade * (newSample - oldSample));
+        }
+    }
+
+    writePosition = (writePosition + numSamples) & mask;
+}
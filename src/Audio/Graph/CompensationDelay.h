@@ -0,0 +1,43 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * CompensationDelay delays one connection in the mix graph so that it lines
+ * up with the slowest path into the same bus (see LatencyCompensation).
+ *
+ * The buffer is allocated up front with room for getCapacity() samples of
+ * delay. A line outlives the plans that use it, so when a recompiled plan asks
+ * for a different delay the history is still there: the block where the delay
+ * changes crossfades from the old tap to the new one instead of jumping.
+ */
+class CompensationDelay
+{
+public:
+    CompensationDelay(int numChannels, int capacity);
+
+    int getNumChannels() const { return buffer.getNumChannels(); }
+    int getCapacity() const { return mask + 1 - maxBlockSize; }
+
+    // Audio thread: pushes numSamples of source into the line and adds what came in
+    // delaySamples ago to destination, times gain
+    void processAdd(const juce::AudioBuffer<float>& source, juce::AudioBuffer<float>& destination,
+                    int numSamples, int delaySamples, float gain) noexcept;
+
+    // Blocks longer than this are processed in pieces
+    static constexpr int maxBlockSize = 4096;
+
+private:
+    void processChunk(const juce::AudioBuffer<float>& source,
+                      juce::AudioBuffer<float>& destination, int offset, int numSamples,
+                      int delaySamples, float gain) noexcept;
+
+    juce::AudioBuffer<float> buffer;
+    int mask = 0;
+
+    // Audio thread
+    int writePosition = 0;
+    int currentDelay = 0; // A new line starts out as a straight wire
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CompensationDelay)
+};
@@ -0,0 +1,92 @@
+#include "ExecutionPlan.h"
+
+#include <algorithm>
+
+AudioNode* ExecutionPlan::findNode(RoutingGraph::NodeID id) const noexcept
+{
+    auto it = std::lower_bound(nodeIDs.begin(), nodeIDs.end(), id);
+
+    if (it == nodeIDs.end() || *it != id)
+    {
+        return nullptr;
+    }
+
+    return nodes[static_cast<size_t>(it - nodeIDs.begin())].get();
+}
+
+bool ExecutionPlan::process(juce::AudioBuffer<float>& output, int startSample, int numSamples,
+                            RealtimeThreadPool& pool) noexcept
+{
+    if (steps.empty() || masterSlot < 0)
+    {
+        return true;
+    }
+
+    // The slots only hold blockSize samples, and every source renders from the block's one
+    // transport position, so the rest can't be rendered: it is silenced rather than left
+    // holding whatever was there (or repeating the first blockSize samples)
+    jassert(numSamples <= blockSize);
+    auto numRendered = juce::jmin(numSamples, blockSize);
+
+    if (numRendered < numSamples)
+    {
+        output.clear(startSample + numRendered, numSamples - numRendered);
+    }
+
+    bool anySoloed = false;
+    for (auto* track : tracks)
+    {
+        anySoloed = anySoloed || track->isSoloActive();
+    }
+
+    for (auto* track : tracks)
+    {
+        track->setSoloedOut(anySoloed && !track->isSoloActive());
+    }
+
+    currentNumSamples = numRendered;
+    pool.execute(*this, taskGraph);
+
+    const auto& master = (*slots)[static_cast<size_t>(masterSlot)];
+    auto numChannels = juce::jmin(output.getNumChannels(), master.getNumChannels());
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        output.addFrom(channel, startSample, master, channel, 0, numRendered);
+    }
+
+    return numRendered == numSamples;
+}
+
+void ExecutionPlan::runTask(int taskIndex) noexcept
+{
+    const auto& step = steps[static_cast<size_t>(taskIndex)];
+    auto& buffers = *slots;
+    auto& buffer = buffers[static_cast<size_t>(step.outputSlot)];
+
+    if (step.sumsInputs)
+    {
+        // Inputs are summed in a fixed order so the result never depends on scheduling
+        buffer.clear(0, currentNumSamples);
+
+        for (int i = step.firstInput; i < step.firstInput + step.numInputs; ++i)
+        {
+            const auto& input = inputs[static_cast<size_t>(i)];
+            const auto& source = buffers[static_cast<size_t>(input.slot)];
+
+            if (input.delay != nullptr)
+            {
+                input.delay->processAdd(source, buffer, currentNumSamples, input.delaySamples,
+                                        input.gain);
+                continue;
+            }
+
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            {
+                buffer.addFrom(channel, 0, source, channel, 0, currentNumSamples, input.gain);
+            }
+        }
+    }
+
+    step.node->process(buffer, currentNumSamples);
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "Audio/RealtimeThreadPool.h"
+#include "AudioNode.h"
+#include "CompensationDelay.h"
+#include "RoutingGraph.h"
+#include "Track.h"
+
+#include <memory>
+#include <vector>
+
+/**
+ * ExecutionPlan is a routing graph compiled for the audio thread.
+ *
+ * Steps are in topological order. Each step sums its inputs (with their send
+ * levels) into a preassigned buffer slot and runs its node in place on it;
+ * slots are shared between steps whose buffers are never live at the same
+ * time. The task graph carries both the data dependencies and the ordering
+ * needed for slot reuse, so steps can run in parallel on the RealtimeThreadPool.
+ * Inputs that arrive ahead of a bus's slowest input pass through a
+ * CompensationDelay on the way in (see LatencyCompensation).
+ *
+ * A plan is immutable once built. It holds shared ownership of its nodes, so a
+ * node removed from the model lives until the last plan using it is released.
+ * When only latencies change, GraphCompiler::updateLatencies() copies a plan
+ * with new delays; the copy shares the original's slot buffers.
+ */
+class ExecutionPlan : private RealtimeThreadPool::Job
+{
+public:
+    struct Input
+    {
+        int slot = 0;
+        float gain = 1.0f;
+        CompensationDelay* delay = nullptr; // Only where latency compensation needs one
+        int delaySamples = 0;
+        int sourceStep = 0;
+        bool isSend = false;
+    };
+
+    struct Step
+    {
+        AudioNode* node = nullptr;
+        int outputSlot = 0;
+        bool sumsInputs = false; // Buses and master: slot is cleared and inputs summed
+        int firstInput = 0;      // Range into inputs
+        int numInputs = 0;
+        RoutingGraph::NodeID id = RoutingGraph::invalidID;
+        int latency = 0;       // The node's own, as of this plan
+        int outputLatency = 0; // Behind the sources, including the inputs' latency
+    };
+
+    ExecutionPlan() = default;
+    ~ExecutionPlan() override = default;
+
+    int getNumSteps() const { return static_cast<int>(steps.size()); }
+    int getNumSlots() const { return static_cast<int>(slots->size()); }
+    int getBlockSize() const { return blockSize; }
+    int getNumDelays() const { return static_cast<int>(delays.size()); }
+
+    // Samples by which the master output trails the sources
+    int getLatencySamples() const { return latencySamples; }
+
+    // Any node in the model when the plan was built, routed or not (nullptr if absent)
+    AudioNode* findNode(RoutingGraph::NodeID id) const noexcept;
+
+    // Audio thread: runs every step and adds the master output to the buffer region. Returns
+    // false if the region was longer than getBlockSize(); the excess is cleared, not rendered.
+    bool process(juce::AudioBuffer<float>& output, int startSample, int numSamples,
+                 RealtimeThreadPool& pool) noexcept;
+
+private:
+    friend class GraphCompiler;
+
+    void runTask(int taskIndex) noexcept override;
+
+    std::vector<Step> steps;
+    std::vector<Input> inputs;
+    // Shared with plans that only realign latencies (only one plan processes at a time)
+    std::shared_ptr<std::vector<juce::AudioBuffer<float>>> slots;
+    RealtimeThreadPool::TaskGraph taskGraph;
+    int masterSlot = -1;
+    int blockSize = 0;
+    int latencySamples = 0;
+    std::vector<std::shared_ptr<CompensationDelay>> delays;
+
+    std::vector<Track*> tracks; // For solo resolution
+    std::vector<std::shared_ptr<AudioNode>> nodes;
+    std::vector<RoutingGraph::NodeID> nodeIDs; // Ascending, parallel to nodes
+
+    int currentNumSamples = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ExecutionPlan)
+};
@@ -0,0 +1,82 @@
+#include "GraphCommandQueue.h"
+
+GraphCommandQueue::GraphCommandQueue(int capacity)
+    : fifo(capacity), commands(static_cast<size_t>(capacity))
+{
+}
+
+void GraphCommandQueue::post(const GraphCommand& command)
+{
+    // Keep order: nothing new goes into the ring until the backlog has gone
+    flushBacklog();
+
+    if (backlog.empty() && write(command))
+    {
+        return;
+    }
+
+    // A newer value for the same parameter replaces one still waiting, as long as no
+    // plan swap lies between them (the node may not exist on the other side of it)
+    if (command.type == GraphCommand::Type::setParameter)
+    {
+        for (auto it = backlog.rbegin(); it != backlog.rend(); ++it)
+        {
+            if (it->type == GraphCommand::Type::swapPlan)
+            {
+                break;
+            }
+
+            if (it->node == command.node && it->parameter == command.parameter)
+            {
+                it->value = command.value;
+                return;
+            }
+        }
+    }
+
+    backlog.push_back(command);
+}
+
+void GraphCommandQueue::flushBacklog()
+{
+    size_t numWritten = 0;
+
+    while (numWritten < backlog.size() && write(backlog[numWritten]))
+    {
+        ++numWritten;
+    }
+
+    backlog.erase(backlog.begin(), backlog.begin() + static_cast<std::ptrdiff_t>(numWritten));
+}
+
+bool GraphCommandQueue::write(const GraphCommand& command)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 + size2 < 1)
+    {
+        return false;
+    }
+
+    commands[static_cast<size_t>(size1 > 0 ? start1 : start2)] = command;
+    fifo.finishedWrite(1);
+    return true;
+}
+
+std::vector<GraphCommand> GraphCommandQueue::drain()
+{
+    std::vector<GraphCommand> remaining;
+
+    process(
+        [&remaining](const GraphCommand& command)
+        {
+            remaining.push_back(command);
+            return true;
+        },
+        fifo.getTotalSize());
+
+    remaining.insert(remaining.end(), backlog.begin(), backlog.end());
+    backlog.clear();
+    return remaining;
+}
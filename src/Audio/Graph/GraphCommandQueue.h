@@ -0,0 +1,85 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "AudioNode.h"
+#include "RoutingGraph.h"
+
+#include <vector>
+
+class ExecutionPlan;
+
+/**
+ * GraphCommand is one change for the audio thread: a node parameter, or a
+ * newly compiled plan to switch to (whose ownership travels with it).
+ */
+struct GraphCommand
+{
+    enum class Type
+    {
+        setParameter,
+        swapPlan
+    };
+
+    Type type = Type::setParameter;
+    RoutingGraph::NodeID node = RoutingGraph::invalidID;
+    AudioNode::Parameter parameter = AudioNode::Parameter::gain;
+    float value = 0.0f;
+    ExecutionPlan* plan = nullptr;
+};
+
+/**
+ * GraphCommandQueue carries GraphCommands from the message thread to the
+ * audio thread, strictly in order.
+ *
+ * The ring is fixed-size and wait-free on both ends. If the audio thread falls
+ * behind and it fills up, further commands wait in a backlog on the message
+ * thread, where repeated changes to the same parameter are merged, so bursts
+ * of automation can't grow memory without bound or block either side.
+ */
+class GraphCommandQueue
+{
+public:
+    explicit GraphCommandQueue(int capacity = 4096);
+
+    // Message thread
+    void post(const GraphCommand& command);
+    void flushBacklog();
+    bool hasBacklog() const { return !backlog.empty(); }
+
+    // Audio thread: hands queued commands to 'handler' in order, at most maxCommands.
+    // A handler returning false leaves that command (and the rest) for next time.
+    template <typename Handler>
+    int process(Handler&& handler, int maxCommands) noexcept
+    {
+        int numProcessed = 0;
+
+        while (numProcessed < maxCommands)
+        {
+            int start1, size1, start2, size2;
+            fifo.prepareToRead(1, start1, size1, start2, size2);
+
+            if (size1 + size2 < 1
+                || !handler(commands[static_cast<size_t>(size1 > 0 ? start1 : start2)]))
+            {
+                break;
+            }
+
+            fifo.finishedRead(1);
+            ++numProcessed;
+        }
+
+        return numProcessed;
+    }
+
+    // With the audio thread stopped: the remaining commands, in order
+    std::vector<GraphCommand> drain();
+
+private:
+    bool write(const GraphCommand& command);
+
+    juce::AbstractFifo fifo;
+    std::vector<GraphCommand> commands;
+    std::vector<GraphCommand> backlog; // Message thread
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GraphCommandQueue)
+};
@@ -0,0 +1,376 @@
+#include "GraphCompiler.h"
+
+#include <algorithm>
+#include <deque>
+#include <map>
+
+namespace
+{
+struct Edge
+{
+    RoutingGraph::NodeID source;
+    RoutingGraph::NodeID destination;
+    float gain;
+    bool isSend;
+};
+
+void addUnique(std::vector<int>& values, int value)
+{
+    if (std::find(values.begin(), values.end(), value) == values.end())
+    {
+        values.push_back(value);
+    }
+}
+} // namespace
+
+std::unique_ptr<ExecutionPlan> GraphCompiler::compile(const RoutingGraph& graph,
+                                                      const Config& config,
+                                                      LatencyCompensation* compensation)
+{
+    using NodeID = RoutingGraph::NodeID;
+
+    auto plan = std::make_unique<ExecutionPlan>();
+    plan->blockSize = config.blockSize;
+    plan->slots = std::make_shared<std::vector<juce::AudioBuffer<float>>>();
+
+    // Every edge in the model: main outputs carry unity gain, sends their level
+    std::vector<Edge> edges;
+
+    for (auto id : graph.getNodeOrder())
+    {
+        auto* node = graph.getNode(id);
+
+        // Plans keep every node alive (and addressable), including currently unrouted ones
+        plan->nodes.push_back(node->processor);
+        plan->nodeIDs.push_back(id);
+
+        if (node->type == RoutingGraph::NodeType::track)
+        {
+            plan->tracks.push_back(static_cast<Track*>(node->processor.get()));
+        }
+
+        if (node->output != RoutingGraph::invalidID)
+        {
+            edges.push_back({id, node->output, 1.0f, false});
+        }
+
+        for (const auto& send : node->sends)
+        {
+            edges.push_back({id, send.destination, send.level, true});
+        }
+    }
+
+    // 1. Keep only nodes that reach the master (reverse search from it)
+    std::map<NodeID, bool> live{{RoutingGraph::masterID, true}};
+    std::vector<NodeID> pending{RoutingGraph::masterID};
+
+    while (!pending.empty())
+    {
+        auto id = pending.back();
+        pending.pop_back();
+
+        for (const auto& edge : edges)
+        {
+            if (edge.destination == id && !live[edge.source])
+            {
+                live[edge.source] = true;
+                pending.push_back(edge.source);
+            }
+        }
+    }
+
+    edges.erase(std::remove_if(edges.begin(), edges.end(),
+                               [&live](const Edge& edge) { return !live[edge.source]; }),
+                edges.end());
+
+    // 2. Topological order, ties broken by creation order
+    std::map<NodeID, int> inDegree;
+    for (const auto& edge : edges)
+    {
+        ++inDegree[edge.destination];
+    }
+
+    std::deque<NodeID> ready;
+    for (auto id : graph.getNodeOrder())
+    {
+        if (live[id] && inDegree[id] == 0)
+        {
+            ready.push_back(id);
+        }
+    }
+
+    std::vector<NodeID> sorted;
+    std::map<NodeID, int> stepIndex;
+
+    while (!ready.empty())
+    {
+        auto id = ready.front();
+        ready.pop_front();
+
+        stepIndex[id] = static_cast<int>(sorted.size());
+        sorted.push_back(id);
+
+        for (const auto& edge : edges)
+        {
+            if (edge.source == id && --inDegree[edge.destination] == 0)
+            {
+                ready.push_back(edge.destination);
+            }
+        }
+    }
+
+    // The model rejects cycles, so everything live must have been scheduled
+    jassert(static_cast<std::ptrdiff_t>(sorted.size()) ==
+            std::count_if(live.begin(), live.end(), [](const auto& e) { return e.second; }));
+
+    if (static_cast<int>(sorted.size()) > RealtimeThreadPool::maxTasks)
+    {
+        jassertfalse;
+        return plan;
+    }
+
+    // Number of steps reading each step's output
+    std::vector<int> readersRemaining(sorted.size(), 0);
+    for (const auto& edge : edges)
+    {
+        ++readersRemaining[static_cast<size_t>(stepIndex[edge.source])];
+    }
+
+    // 3. Slot assignment by liveness (and 4. latency, which follows the same order)
+    std::vector<int> stepSlots(sorted.size(), -1);
+    std::vector<int> outputLatency(sorted.size(), 0);
+
+    if (compensation != nullptr)
+    {
+        compensation->beginCompile(config.numChannels);
+    }
+
+    std::vector<std::vector<int>> readersOfStep(sorted.size());
+    std::vector<int> freeSlots;
+    std::vector<std::vector<int>> slotLastReaders;
+
+    for (size_t s = 0; s < sorted.size(); ++s)
+    {
+        auto id = sorted[s];
+        auto* node = graph.getNode(id);
+        auto stepNumber = static_cast<int>(s);
+
+        // Inputs in step order, for a deterministic summing order
+        std::vector<Edge> incoming;
+        for (const auto& edge : edges)
+        {
+            if (edge.destination == id)
+            {
+                incoming.push_back(edge);
+            }
+        }
+
+        std::stable_sort(incoming.begin(), incoming.end(),
+                         [&stepIndex](const Edge& a, const Edge& b)
+                         { return stepIndex[a.source] < stepIndex[b.source]; });
+
+        std::vector<int> dependencies;
+        for (const auto& edge : incoming)
+        {
+            addUnique(dependencies, stepIndex[edge.source]);
+        }
+
+        // Allocate the output before releasing the inputs, so a step never sums into a
+        // slot it is still reading from
+        int slot;
+        if (!freeSlots.empty())
+        {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+
+            // Reuse: wait until everything reading the old contents has finished
+            for (auto reader : slotLastReaders[static_cast<size_t>(slot)])
+            {
+                addUnique(dependencies, reader);
+            }
+        }
+        else
+        {
+            slot = static_cast<int>(slotLastReaders.size());
+            slotLastReaders.emplace_back();
+        }
+
+        stepSlots[s] = slot;
+
+        ExecutionPlan::Step step;
+        step.node = node->processor.get();
+        step.outputSlot = slot;
+        step.sumsInputs = node->type != RoutingGraph::NodeType::track;
+        step.firstInput = static_cast<int>(plan->inputs.size());
+        step.numInputs = static_cast<int>(incoming.size());
+        step.id = id;
+
+        // Inputs arrive together, as late as the slowest of them
+        int inputLatency = 0;
+
+        if (compensation != nullptr)
+        {
+            for (const auto& edge : incoming)
+            {
+                auto source = static_cast<size_t>(stepIndex[edge.source]);
+                inputLatency = juce::jmax(inputLatency, outputLatency[source]);
+            }
+
+            step.latency = node->processor->getLatencySamples();
+            compensation->setNodeLatency(id, step.latency);
+            outputLatency[s] = inputLatency + step.latency;
+            step.outputLatency = outputLatency[s];
+        }
+
+        for (const auto& edge : incoming)
+        {
+            auto source = static_cast<size_t>(stepIndex[edge.source]);
+            ExecutionPlan::Input input{stepSlots[source], edge.gain};
+            input.sourceStep = static_cast<int>(source);
+            input.isSend = edge.isSend;
+
+            if (compensation != nullptr)
+            {
+                input.delaySamples = inputLatency - outputLatency[source];
+
+                if (auto delay = compensation->getDelay(edge.source, id, edge.isSend,
+                                                         input.delaySamples))
+                {
+                    input.delay = delay.get();
+                    plan->delays.push_back(std::move(delay));
+                }
+            }
+
+            plan->inputs.push_back(input);
+
+            addUnique(readersOfStep[source], stepNumber);
+
+            if (--readersRemaining[source] == 0)
+            {
+                freeSlots.push_back(stepSlots[source]);
+                slotLastReaders[static_cast<size_t>(stepSlots[source])] = readersOfStep[source];
+            }
+        }
+
+        plan->steps.push_back(step);
+        plan->taskGraph.addTask(dependencies);
+
+        if (id == RoutingGraph::masterID)
+        {
+            plan->masterSlot = slot;
+            plan->latencySamples = outputLatency[s];
+        }
+    }
+
+    if (compensation != nullptr)
+    {
+        compensation->endCompile(plan->latencySamples);
+    }
+
+    plan->taskGraph.finalise();
+
+    plan->slots->resize(slotLastReaders.size());
+    for (auto& buffer : *plan->slots)
+    {
+        buffer.setSize(config.numChannels, config.blockSize);
+        buffer.clear();
+    }
+
+    return plan;
+}
+
+std::unique_ptr<ExecutionPlan> GraphCompiler::updateLatencies(const ExecutionPlan& current,
+                                                              LatencyCompensation& compensation)
+{
+    auto plan = std::make_unique<ExecutionPlan>();
+    plan->steps = current.steps;
+    plan->inputs = current.inputs;
+    plan->slots = current.slots;
+    plan->taskGraph = current.taskGraph;
+    plan->masterSlot = current.masterSlot;
+    plan->blockSize = current.blockSize;
+    plan->latencySamples = current.latencySamples;
+    plan->tracks = current.tracks;
+    plan->nodes = current.nodes;
+    plan->nodeIDs = current.nodeIDs;
+
+    // Lines of the inputs left alone, found by the pointer the inputs hold
+    auto findLine = [&current](const CompensationDelay* delay)
+    {
+        for (const auto& line : current.delays)
+        {
+            if (line.get() == delay)
+            {
+                return line;
+            }
+        }
+
+        return std::shared_ptr<CompensationDelay>();
+    };
+
+    // Steps are in topological order, so a step's sources are final by the time it is reached
+    std::vector<bool> outputMoved(plan->steps.size(), false);
+
+    for (size_t s = 0; s < plan->steps.size(); ++s)
+    {
+        auto& step = plan->steps[s];
+        auto firstInput = plan->inputs.begin() + step.firstInput;
+        auto lastInput = firstInput + step.numInputs;
+
+        auto latency = step.node->getLatencySamples();
+        bool inputsMoved = false;
+
+        for (auto input = firstInput; input != lastInput; ++input)
+        {
+            inputsMoved = inputsMoved || outputMoved[static_cast<size_t>(input->sourceStep)];
+        }
+
+        if (latency == step.latency && !inputsMoved)
+        {
+            for (auto input = firstInput; input != lastInput; ++input)
+            {
+                if (input->delay != nullptr)
+                {
+                    plan->delays.push_back(findLine(input->delay));
+                }
+            }
+
+            continue;
+        }
+
+        int inputLatency = 0;
+        for (auto input = firstInput; input != lastInput; ++input)
+        {
+            const auto& source = plan->steps[static_cast<size_t>(input->sourceStep)];
+            inputLatency = juce::jmax(inputLatency, source.outputLatency);
+        }
+
+        for (auto input = firstInput; input != lastInput; ++input)
+        {
+            const auto& source = plan->steps[static_cast<size_t>(input->sourceStep)];
+            input->delaySamples = inputLatency - source.outputLatency;
+
+            auto delay = compensation.getDelay(source.id, step.id, input->isSend,
+                                               input->delaySamples);
+            input->delay = delay.get();
+
+            if (delay != nullptr)
+            {
+                plan->delays.push_back(std::move(delay));
+            }
+        }
+
+        compensation.setNodeLatency(step.id, latency);
+        outputMoved[s] = inputLatency + latency != step.outputLatency;
+        step.latency = latency;
+        step.outputLatency = inputLatency + latency;
+
+        if (step.id == RoutingGraph::masterID)
+        {
+            plan->latencySamples = step.outputLatency;
+        }
+    }
+
+    compensation.endUpdate(plan->latencySamples);
+    return plan;
+}
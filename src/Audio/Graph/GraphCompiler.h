@@ -0,0 +1,51 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "ExecutionPlan.h"
+#include "LatencyCompensation.h"
+#include "RoutingGraph.h"
+
+#include <memory>
+
+/**
+ * GraphCompiler turns a RoutingGraph into an ExecutionPlan (message thread only).
+ *
+ * 1. Nodes that cannot reach the master are dropped.
+ * 2. The rest are sorted topologically (Kahn's algorithm, ties broken by
+ *    creation order so the same graph always compiles to the same plan).
+ * 3. Buffer slots are assigned by liveness: a step's slot is released once
+ *    its last reader has been scheduled and is reused by a later step. Reuse
+ *    adds an ordering edge from every reader of the old contents to the new
+ *    writer, so the plan stays correct when steps run in parallel.
+ * 4. With a LatencyCompensation, each node's output latency is accumulated
+ *    along the schedule and inputs that would reach a bus early are delayed
+ *    to match its slowest input.
+ *
+ * The number of slots therefore follows the graph's width (the most buffers
+ * live at one point of the schedule), not its node count.
+ *
+ * When nodes only change their latency, updateLatencies() realigns a copy of
+ * the current plan instead: only steps downstream of a changed node get new
+ * output latencies and input delays, and the slot buffers are shared, so
+ * nothing is scheduled or allocated again.
+ */
+class GraphCompiler
+{
+public:
+    struct Config
+    {
+        double sampleRate = 48000.0;
+        int blockSize = 512;
+        int numChannels = 2;
+    };
+
+    static std::unique_ptr<ExecutionPlan> compile(const RoutingGraph& graph, const Config& config,
+                                                  LatencyCompensation* compensation = nullptr);
+
+    // A copy of a plan compiled with this compensation, realigned to its nodes' current latencies
+    static std::unique_ptr<ExecutionPlan> updateLatencies(const ExecutionPlan& current,
+                                                          LatencyCompensation& compensation);
+
+private:
+    GraphCompiler() = delete;
+};
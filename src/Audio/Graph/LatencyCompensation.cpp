@@ -0,0 +1,77 @@
+#include "LatencyCompensation.h"
+
+LatencyCompensation::LatencyCompensation() = default;
+
+LatencyCompensation::~LatencyCompensation() = default;
+
+void LatencyCompensation::beginCompile(int channels)
+{
+    numChannels = channels;
+    latencies.clear();
+
+    for (auto& [key, line] : lines)
+    {
+        line.used = false;
+    }
+}
+
+void LatencyCompensation::endCompile(int latency)
+{
+    totalLatency = latency;
+
+    // Plans already built keep their own references to the lines they use
+    for (auto it = lines.begin(); it != lines.end();)
+    {
+        it = it->second.used ? std::next(it) : lines.erase(it);
+    }
+}
+
+std::shared_ptr<CompensationDelay> LatencyCompensation::getDelay(NodeID source,
+                                                                 NodeID destination,
+                                                                 bool isSend, int delaySamples)
+{
+    auto key = std::make_tuple(source, destination, isSend);
+    auto it = lines.find(key);
+
+    if (it != lines.end() && it->second.delay->getCapacity() >= delaySamples &&
+        it->second.delay->getNumChannels() == numChannels)
+    {
+        // Already at zero: the fade back to the direct signal is done
+        if (delaySamples == 0 && it->second.delaySamples == 0)
+        {
+            return nullptr;
+        }
+
+        it->second.delaySamples = delaySamples;
+        it->second.used = true;
+        return it->second.delay;
+    }
+
+    if (delaySamples == 0)
+    {
+        return nullptr;
+    }
+
+    // Twice what's needed now, so the latency can grow without losing the line's history
+    auto capacity = juce::jmax(minimumCapacity, juce::nextPowerOfTwo(delaySamples * 2));
+    auto& line = lines[key];
+    line.delay = std::make_shared<CompensationDelay>(numChannels, capacity);
+    line.delaySamples = delaySamples;
+    line.used = true;
+    return line.delay;
+}
+
+bool LatencyCompensation::hasLatencyChanged(const RoutingGraph& graph) const
+{
+    for (const auto& [id, latency] : latencies)
+    {
+        auto* node = graph.getNode(id);
+
+        if (node != nullptr && node->processor->getLatencySamples() != latency)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "CompensationDelay.h"
+#include "RoutingGraph.h"
+
+#include <map>
+#include <memory>
+#include <tuple>
+
+/**
+ * LatencyCompensation keeps every path to the master in time when nodes add
+ * latency (plugin lookahead, linear-phase filters). Message thread only.
+ *
+ * While GraphCompiler builds a plan it works out each node's output latency
+ * in topological order: a bus's input arrives as late as its slowest input,
+ * and every faster input is delayed by the difference. Only those connections
+ * get a CompensationDelay; everything else is summed directly.
+ *
+ * Lines are kept here, keyed by connection, and reused by each new plan, so a
+ * latency change moves a line's tap (with a crossfade) instead of starting an
+ * empty one. A line whose delay drops to zero is kept for one more plan to
+ * fade back to the direct signal, then released with the last plan using it.
+ * Lines are sized with headroom so that growing latencies rarely need a new
+ * one.
+ */
+class LatencyCompensation
+{
+public:
+    using NodeID = RoutingGraph::NodeID;
+
+    LatencyCompensation();
+    ~LatencyCompensation();
+
+    // GraphCompiler, around each compile
+    void beginCompile(int numChannels);
+    void endCompile(int totalLatency);
+
+    // GraphCompiler, after realigning a plan's latencies without recompiling it. Lines
+    // that are no longer needed are released by the next compile.
+    void endUpdate(int latency) { totalLatency = latency; }
+
+    // GraphCompiler: records the latency a node reported for this plan
+    void setNodeLatency(NodeID id, int latency) { latencies[id] = latency; }
+
+    // GraphCompiler: the line delaying a connection (a node's main output, or a send, since
+    // both may go to the same bus), or nullptr if it needs none
+    std::shared_ptr<CompensationDelay> getDelay(NodeID source, NodeID destination, bool isSend,
+                                                int delaySamples);
+
+    // True when a node in the last plan now reports a different latency
+    bool hasLatencyChanged(const RoutingGraph& graph) const;
+
+    // Samples by which the master trails the sources, as of the last plan
+    int getTotalLatency() const { return totalLatency; }
+
+    static constexpr int minimumCapacity = 16384;
+
+private:
+    struct Line
+    {
+        std::shared_ptr<CompensationDelay> delay;
+        int delaySamples = 0;
+        bool used = false;
+    };
+
+    std::map<std::tuple<NodeID, NodeID, bool>, Line> lines;
+    std::map<NodeID, int> latencies;
+    int numChannels = 2;
+    int totalLatency = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LatencyCompensation)
+};
@@ -0,0 +1,319 @@
+#include "MixGraph.h"
+
+MixGraph::MixGraph(GarbageCollector& collector) : garbageCollector(collector)
+{
+}
+
+MixGraph::~MixGraph()
+{
+    stopTimer();
+
+    // The audio callback has stopped by now, so every plan can go
+    applyPendingCommands();
+    delete activePlan;
+}
+
+MixGraph::ScopedBatch::ScopedBatch(MixGraph& graph) : owner(graph)
+{
+    ++owner.batchDepth;
+}
+
+MixGraph::ScopedBatch::~ScopedBatch()
+{
+    if (--owner.batchDepth == 0 && owner.batchChanged)
+    {
+        owner.graphChanged();
+    }
+}
+
+MixGraph::NodeID MixGraph::addTrack(const juce::String& name,
+                                    std::unique_ptr<juce::AudioSource> source)
+{
+    auto track = std::make_shared<Track>(name, std::move(source));
+
+    // Prepared before any plan can reach the audio thread
+    if (prepared)
+    {
+        track->prepareToPlay(config.sampleRate, config.blockSize);
+    }
+
+    auto id = routingGraph.addTrack(std::move(track));
+    ++numTracks;
+    graphChanged();
+    return id;
+}
+
+MixGraph::NodeID MixGraph::addBus(const juce::String& name)
+{
+    auto bus = std::make_shared<Bus>(name);
+
+    if (prepared)
+    {
+        bus->prepareToPlay(config.sampleRate, config.blockSize);
+    }
+
+    auto id = routingGraph.addBus(std::move(bus));
+    graphChanged();
+    return id;
+}
+
+void MixGraph::removeNode(NodeID id)
+{
+    auto* node = routingGraph.getNode(id);
+
+    if (node == nullptr || id == RoutingGraph::masterID)
+    {
+        return;
+    }
+
+    if (node->type == RoutingGraph::NodeType::track)
+    {
+        --numTracks;
+    }
+
+    // The node itself is released with the last plan that still uses it
+    routingGraph.removeNode(id);
+    graphChanged();
+}
+
+bool MixGraph::setOutput(NodeID source, NodeID destination)
+{
+    if (!routingGraph.setOutput(source, destination))
+    {
+        return false;
+    }
+
+    graphChanged();
+    return true;
+}
+
+bool MixGraph::setSend(NodeID source, NodeID destination, float level)
+{
+    if (!routingGraph.setSend(source, destination, level))
+    {
+        return false;
+    }
+
+    graphChanged();
+    return true;
+}
+
+void MixGraph::removeSend(NodeID source, NodeID destination)
+{
+    routingGraph.removeSend(source, destination);
+    graphChanged();
+}
+
+void MixGraph::setParameter(NodeID id, AudioNode::Parameter parameter, float value)
+{
+    auto* node = routingGraph.getNode(id);
+
+    if (node == nullptr)
+    {
+        return;
+    }
+
+    // Buses have no pan or solo; recording one would show a control that does nothing
+    auto isTrackOnly = parameter == AudioNode::Parameter::pan ||
+                       parameter == AudioNode::Parameter::solo;
+
+    if (isTrackOnly && node->type != RoutingGraph::NodeType::track)
+    {
+        jassertfalse;
+        return;
+    }
+
+    node->processor->parameters[static_cast<int>(parameter)] = value;
+
+    // Without a device there is no audio thread to race with
+    if (!prepared)
+    {
+        node->processor->parameterChanged(parameter, value);
+        return;
+    }
+
+    GraphCommand command;
+    command.type = GraphCommand::Type::setParameter;
+    command.node = id;
+    command.parameter = parameter;
+    command.value = value;
+    post(command);
+}
+
+Track* MixGraph::getTrack(NodeID id) const
+{
+    auto* node = routingGraph.getNode(id);
+
+    if (node == nullptr || node->type != RoutingGraph::NodeType::track)
+    {
+        return nullptr;
+    }
+
+    return static_cast<Track*>(node->processor.get());
+}
+
+Bus* MixGraph::getBus(NodeID id) const
+{
+    auto* node = routingGraph.getNode(id);
+
+    if (node == nullptr || node->type == RoutingGraph::NodeType::track)
+    {
+        return nullptr;
+    }
+
+    return static_cast<Bus*>(node->processor.get());
+}
+
+void MixGraph::prepareToPlay(double sampleRate, int maximumBlockSize, int numOutputChannels)
+{
+    applyPendingCommands();
+
+    config.sampleRate = sampleRate;
+    config.blockSize = maximumBlockSize;
+    config.numChannels = juce::jmax(1, numOutputChannels);
+    prepared = true;
+
+    for (auto id : routingGraph.getNodeOrder())
+    {
+        routingGraph.getNode(id)->processor->prepareToPlay(sampleRate, maximumBlockSize);
+    }
+
+    publish(GraphCompiler::compile(routingGraph, config, &latencyCompensation));
+    updateTimer();
+}
+
+void MixGraph::releaseResources()
+{
+    // Nothing may be left queued while unprepared: changes then go straight to the nodes
+    applyPendingCommands();
+
+    for (auto id : routingGraph.getNodeOrder())
+    {
+        routingGraph.getNode(id)->processor->releaseResources();
+    }
+
+    prepared = false;
+    updateTimer();
+}
+
+void MixGraph::graphChanged()
+{
+    if (batchDepth > 0)
+    {
+        batchChanged = true;
+        return;
+    }
+
+    batchChanged = false;
+
+    // Plans are sized for the device, so there is nothing to compile until it is known
+    if (prepared)
+    {
+        publish(GraphCompiler::compile(routingGraph, config, &latencyCompensation));
+    }
+}
+
+void MixGraph::publish(std::unique_ptr<ExecutionPlan> plan)
+{
+    GraphCommand command;
+    command.type = GraphCommand::Type::swapPlan;
+    command.plan = plan.release();
+    latestPlan = command.plan;
+    post(command);
+}
+
+void MixGraph::post(const GraphCommand& command)
+{
+    commandQueue.post(command);
+
+    // The audio thread is behind: keep retrying until the backlog has gone through
+    if (commandQueue.hasBacklog())
+    {
+        updateTimer();
+    }
+}
+
+void MixGraph::timerCallback()
+{
+    commandQueue.flushBacklog();
+
+    // Plugins may change their latency at any time. Only the delays need to move, so the
+    // latest plan is realigned rather than the graph recompiled.
+    if (prepared && latestPlan != nullptr && latencyCompensation.hasLatencyChanged(routingGraph))
+    {
+        publish(GraphCompiler::updateLatencies(*latestPlan, latencyCompensation));
+    }
+
+    updateTimer();
+}
+
+void MixGraph::updateTimer()
+{
+    auto interval = commandQueue.hasBacklog() ? backlogRetryMs : prepared ? latencyPollMs : 0;
+
+    if (interval == 0)
+    {
+        stopTimer();
+    }
+    else if (getTimerInterval() != interval)
+    {
+        startTimer(interval);
+    }
+}
+
+bool MixGraph::applyCommand(const GraphCommand& command) noexcept
+{
+    if (command.type == GraphCommand::Type::swapPlan)
+    {
+        // No room to retire the old plan: leave the swap (and what follows) for next block
+        if (activePlan != nullptr && !garbageCollector.retire(activePlan))
+        {
+            return false;
+        }
+
+        activePlan = command.plan;
+        return true;
+    }
+
+    // Plans index every node in the model, so a node can only be missing if it was removed
+    if (activePlan != nullptr)
+    {
+        if (auto* node = activePlan->findNode(command.node))
+        {
+            node->parameterChanged(command.parameter, command.value);
+        }
+    }
+
+    return true;
+}
+
+void MixGraph::applyPendingCommands()
+{
+    // Only called while the audio thread is stopped, so old plans can be deleted here
+    for (const auto& command : commandQueue.drain())
+    {
+        if (command.type == GraphCommand::Type::swapPlan)
+        {
+            delete activePlan;
+            activePlan = command.plan;
+        }
+        else
+        {
+            applyCommand(command);
+        }
+    }
+}
+
+void MixGraph::process(juce::AudioBuffer<float>& output, int startSample, int numSamples,
+                       RealtimeThreadPool& pool) noexcept
+{
+    // Everything posted since the last block, in order, before any node runs
+    commandQueue.process([this](const GraphCommand& command) noexcept
+                         { return applyCommand(command); },
+                         maxCommandsPerBlock);
+
+    if (activePlan != nullptr && !activePlan->process(output, startSample, numSamples, pool))
+    {
+        oversizedBlocks.fetch_add(1, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "Audio/GarbageCollector.h"
+#include "Audio/RealtimeThreadPool.h"
+#include "ExecutionPlan.h"
+#include "GraphCommandQueue.h"
+#include "GraphCompiler.h"
+#include "LatencyCompensation.h"
+#include "RoutingGraph.h"
+
+#include <atomic>
+#include <memory>
+
+/**
+ * MixGraph owns the routing model and the plan the audio thread runs.
+ *
+ * Every edit on the message thread recompiles the RoutingGraph into a new
+ * ExecutionPlan (see GraphCompiler) with all buffers allocated and nodes
+ * prepared. Plans and mixer parameter changes go to the audio thread through
+ * one lock-free command queue, so they land in the order they were made, at a
+ * block boundary, with no lock and no skipped block. Replaced plans are handed
+ * to the GarbageCollector, together with any nodes only they still referenced.
+ *
+ * Plans are latency compensated (see LatencyCompensation). Nodes report their
+ * latency through AudioNode::setLatencySamples(); a change is picked up within
+ * latencyPollMs and a copy of the latest plan published with realigned delays
+ * (see GraphCompiler::updateLatencies), without recompiling the graph.
+ *
+ * Wrap bulk edits (loading a session) in a ScopedBatch to compile once.
+ */
+class MixGraph : private juce::Timer
+{
+public:
+    using NodeID = RoutingGraph::NodeID;
+
+    explicit MixGraph(GarbageCollector& garbageCollector);
+    ~MixGraph() override;
+
+    // Message thread: each edit publishes a new plan
+    NodeID addTrack(const juce::String& name, std::unique_ptr<juce::AudioSource> source = nullptr);
+    NodeID addBus(const juce::String& name);
+    void removeNode(NodeID id);
+    bool setOutput(NodeID source, NodeID destination);
+    bool setSend(NodeID source, NodeID destination, float level);
+    void removeSend(NodeID source, NodeID destination);
+
+    // Message thread: mixer controls, smoothed on the audio thread. Pan and solo are
+    // track controls and are ignored for buses.
+    void setParameter(NodeID id, AudioNode::Parameter parameter, float value);
+    void setGain(NodeID id, float gain) { setParameter(id, AudioNode::Parameter::gain, gain); }
+    void setPan(NodeID id, float pan) { setParameter(id, AudioNode::Parameter::pan, pan); }
+    void setMuted(NodeID id, bool muted)
+    {
+        setParameter(id, AudioNode::Parameter::mute, muted ? 1.0f : 0.0f);
+    }
+    void setSoloed(NodeID id, bool soloed)
+    {
+        setParameter(id, AudioNode::Parameter::solo, soloed ? 1.0f : 0.0f);
+    }
+
+    Track* getTrack(NodeID id) const;
+    Bus* getBus(NodeID id) const;
+    Bus* getMaster() const { return getBus(RoutingGraph::masterID); }
+    NodeID getMasterID() const { return RoutingGraph::masterID; }
+    int getNumTracks() const { return numTracks; }
+    const RoutingGraph& getRoutingGraph() const { return routingGraph; }
+
+    // Samples by which the master trails the sources, as of the last compile
+    int getLatencySamples() const { return latencyCompensation.getTotalLatency(); }
+
+    /** Defers recompiling until the outermost batch ends. */
+    class ScopedBatch
+    {
+    public:
+        explicit ScopedBatch(MixGraph& graph);
+        ~ScopedBatch();
+
+    private:
+        MixGraph& owner;
+        JUCE_DECLARE_NON_COPYABLE(ScopedBatch)
+    };
+
+    // Call while the audio callback is stopped
+    void prepareToPlay(double sampleRate, int maximumBlockSize, int numOutputChannels);
+    void releaseResources();
+
+    // Audio thread: applies queued commands and adds the mix to the buffer region
+    void process(juce::AudioBuffer<float>& output, int startSample, int numSamples,
+                 RealtimeThreadPool& pool) noexcept;
+
+    // Blocks longer than the prepared size, whose excess was silenced (a driver bug)
+    juce::int64 getNumOversizedBlocks() const { return oversizedBlocks.load(); }
+
+    // Upper bound on the work done before a block starts rendering
+    static constexpr int maxCommandsPerBlock = 1024;
+
+    // Tracks pan into stereo, so that is the width of every mix buffer whatever the output's
+    static constexpr int numMixChannels = 2;
+
+    static constexpr int latencyPollMs = 50;
+    static constexpr int backlogRetryMs = 10;
+
+private:
+    void timerCallback() override;
+    void graphChanged();
+    void publish(std::unique_ptr<ExecutionPlan> plan);
+    void post(const GraphCommand& command);
+    bool applyCommand(const GraphCommand& command) noexcept;
+    void applyPendingCommands();
+    void updateTimer();
+
+    RoutingGraph routingGraph;
+    LatencyCompensation latencyCompensation;
+    GraphCompiler::Config config;
+    bool prepared = false;
+    int numTracks = 0;
+    int batchDepth = 0;
+    bool batchChanged = false;
+    const ExecutionPlan* latestPlan = nullptr; // The last published, alive until the next
+
+    // Message thread -> audio thread -> garbage collector
+    GarbageCollector& garbageCollector;
+    GraphCommandQueue commandQueue;
+    ExecutionPlan* activePlan = nullptr; // Audio thread
+    std::atomic<juce::int64> oversizedBlocks{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MixGraph)
+};
@@ -0,0 +1,171 @@
+#include "RoutingGraph.h"
+
+#include <algorithm>
+
+RoutingGraph::RoutingGraph()
+{
+    Node master;
+    master.id = masterID;
+    master.type = NodeType::master;
+    master.processor = std::make_shared<Bus>("Master");
+
+    nodes[masterID] = master;
+    order.push_back(masterID);
+}
+
+RoutingGraph::NodeID RoutingGraph::addNode(NodeType type, std::shared_ptr<AudioNode> processor)
+{
+    Node node;
+    node.id = nextID++;
+    node.type = type;
+    node.processor = std::move(processor);
+    node.output = masterID;
+
+    nodes[node.id] = node;
+    order.push_back(node.id);
+    return node.id;
+}
+
+RoutingGraph::NodeID RoutingGraph::addTrack(std::shared_ptr<Track> track)
+{
+    return addNode(NodeType::track, std::move(track));
+}
+
+RoutingGraph::NodeID RoutingGraph::addBus(std::shared_ptr<Bus> bus)
+{
+    return addNode(NodeType::bus, std::move(bus));
+}
+
+void RoutingGraph::removeNode(NodeID id)
+{
+    if (id == masterID || nodes.erase(id) == 0)
+    {
+        return;
+    }
+
+    order.erase(std::remove(order.begin(), order.end(), id), order.end());
+
+    // Anything routed into the removed node is left unrouted
+    for (auto& entry : nodes)
+    {
+        auto& node = entry.second;
+
+        if (node.output == id)
+        {
+            node.output = invalidID;
+        }
+
+        node.sends.erase(std::remove_if(node.sends.begin(), node.sends.end(),
+                                        [id](const Send& send) { return send.destination == id; }),
+                         node.sends.end());
+    }
+}
+
+const RoutingGraph::Node* RoutingGraph::getNode(NodeID id) const
+{
+    auto found = nodes.find(id);
+    return found != nodes.end() ? &found->second : nullptr;
+}
+
+bool RoutingGraph::isBusOrMaster(NodeID id) const
+{
+    auto* node = getNode(id);
+    return node != nullptr && node->type != NodeType::track;
+}
+
+bool RoutingGraph::feeds(NodeID from, NodeID to) const
+{
+    // Depth-first search along outputs and sends
+    std::vector<NodeID> pending{from};
+    std::vector<NodeID> visited;
+
+    while (!pending.empty())
+    {
+        auto id = pending.back();
+        pending.pop_back();
+
+        if (id == to)
+        {
+            return true;
+        }
+
+        if (std::find(visited.begin(), visited.end(), id) != visited.end())
+        {
+            continue;
+        }
+
+        visited.push_back(id);
+
+        if (auto* node = getNode(id))
+        {
+            if (node->output != invalidID)
+            {
+                pending.push_back(node->output);
+            }
+
+            for (const auto& send : node->sends)
+            {
+                pending.push_back(send.destination);
+            }
+        }
+    }
+
+    return false;
+}
+
+bool RoutingGraph::setOutput(NodeID source, NodeID destination)
+{
+    auto found = nodes.find(source);
+
+    if (found == nodes.end() || source == masterID)
+    {
+        return false;
+    }
+
+    if (destination != invalidID && (!isBusOrMaster(destination) || feeds(destination, source)))
+    {
+        return false;
+    }
+
+    found->second.output = destination;
+    return true;
+}
+
+bool RoutingGraph::setSend(NodeID source, NodeID destination, float level)
+{
+    auto found = nodes.find(source);
+
+    if (found == nodes.end() || source == masterID || !isBusOrMaster(destination) ||
+        feeds(destination, source))
+    {
+        return false;
+    }
+
+    auto& sends = found->second.sends;
+
+    for (auto& send : sends)
+    {
+        if (send.destination == destination)
+        {
+            send.level = level;
+            return true;
+        }
+    }
+
+    sends.push_back({destination, level});
+    return true;
+}
+
+void RoutingGraph::removeSend(NodeID source, NodeID destination)
+{
+    auto found = nodes.find(source);
+
+    if (found != nodes.end())
+    {
+        auto& sends = found->second.sends;
+        sends.erase(std::remove_if(sends.begin(), sends.end(),
+                                   [destination](const Send& send)
+                                   { return send.destination == destination; }),
+                    sends.end());
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "Bus.h"
+#include "Track.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+/**
+ * RoutingGraph is the editable model of tracks, buses and their connections.
+ *
+ * It lives on the message thread only and is never read by the audio thread:
+ * GraphCompiler turns a snapshot of it into an ExecutionPlan. Every node has
+ * one main output (a bus, the master, or nothing) and any number of post-fader
+ * sends to buses. Edits that would create a cycle are rejected.
+ */
+class RoutingGraph
+{
+public:
+    using NodeID = juce::uint32;
+    static constexpr NodeID invalidID = 0;
+    static constexpr NodeID masterID = 1;
+
+    enum class NodeType
+    {
+        track,
+        bus,
+        master
+    };
+
+    struct Send
+    {
+        NodeID destination = invalidID;
+        float level = 1.0f;
+    };
+
+    struct Node
+    {
+        NodeID id = invalidID;
+        NodeType type = NodeType::track;
+        std::shared_ptr<AudioNode> processor;
+        NodeID output = invalidID;
+        std::vector<Send> sends;
+    };
+
+    RoutingGraph();
+
+    NodeID addTrack(std::shared_ptr<Track> track);
+    NodeID addBus(std::shared_ptr<Bus> bus);
+    void removeNode(NodeID id);
+
+    // Return false (and change nothing) if the node is missing or the edit would form a cycle
+    bool setOutput(NodeID source, NodeID destination);
+    bool setSend(NodeID source, NodeID destination, float level);
+    void removeSend(NodeID source, NodeID destination);
+
+    const Node* getNode(NodeID id) const;
+
+    // Nodes in creation order (master first)
+    const std::vector<NodeID>& getNodeOrder() const { return order; }
+
+private:
+    NodeID addNode(NodeType type, std::shared_ptr<AudioNode> processor);
+    bool isBusOrMaster(NodeID id) const;
+    bool feeds(NodeID from, NodeID to) const;
+
+    std::map<NodeID, Node> nodes;
+    std::vector<NodeID> order;
+    NodeID nextID = masterID + 1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RoutingGraph)
+};
@@ -0,0 +1,116 @@
+#include "Track.h"
+
+namespace
+{
+// -3 dB equal-power pan law
+void getPanGains(float pan, float& left, float& right) noexcept
+{
+    auto angle = (pan + 1.0f) * juce::MathConstants<float>::pi * 0.25f;
+    left = std::cos(angle);
+    right = std::sin(angle);
+}
+} // namespace
+
+Track::Track(const juce::String& trackName, std::unique_ptr<juce::AudioSource> audioSource)
+    : name(trackName), source(std::move(audioSource))
+{
+}
+
+Track::~Track() = default;
+
+void Track::prepareToPlay(double sampleRate, int maximumBlockSize)
+{
+    if (source != nullptr)
+    {
+        source->prepareToPlay(maximumBlockSize, sampleRate);
+    }
+
+    // Start at the current settings rather than ramping in from wherever the last run ended
+    gain.reset(sampleRate, smoothingSeconds);
+    pan.reset(sampleRate, smoothingSeconds);
+    audible.reset(sampleRate, smoothingSeconds);
+}
+
+void Track::releaseResources()
+{
+    if (source != nullptr)
+    {
+        source->releaseResources();
+    }
+}
+
+void Track::parameterChanged(Parameter parameter, float value) noexcept
+{
+    switch (parameter)
+    {
+        case Parameter::gain:
+            gain.setTargetValue(value);
+            break;
+        case Parameter::pan:
+            pan.setTargetValue(juce::jlimit(-1.0f, 1.0f, value));
+            break;
+        case Parameter::mute:
+            muted = value != 0.0f;
+            break;
+        case Parameter::solo:
+            soloActive = value != 0.0f;
+            break;
+    }
+}
+
+void Track::process(juce::AudioBuffer<float>& buffer, int numSamples) noexcept
+{
+    if (source != nullptr)
+    {
+        source->getNextAudioBlock(juce::AudioSourceChannelInfo(&buffer, 0, numSamples));
+    }
+    else
+    {
+        buffer.clear(0, numSamples);
+    }
+
+    for (int channel = 2; channel < buffer.getNumChannels(); ++channel)
+    {
+        buffer.clear(channel, 0, numSamples);
+    }
+
+    audible.setTargetValue(muted || soloedOut ? 0.0f : 1.0f);
+    auto* left = buffer.getWritePointer(0);
+    auto* right = buffer.getNumChannels() > 1 ? buffer.getWritePointer(1) : nullptr;
+
+    // Settled: one gain per channel for the whole block
+    if (!gain.isSmoothing() && !pan.isSmoothing() && !audible.isSmoothing())
+    {
+        auto level = gain.getCurrentValue() * audible.getCurrentValue();
+
+        if (right == nullptr)
+        {
+            juce::FloatVectorOperations::multiply(left, level, numSamples);
+            return;
+        }
+
+        float leftGain, rightGain;
+        getPanGains(pan.getCurrentValue(), leftGain, rightGain);
+        juce::FloatVectorOperations::multiply(left, level * leftGain, numSamples);
+        juce::FloatVectorOperations::multiply(right, level * rightGain, numSamples);
+        return;
+    }
+
+    // Ramping: every sample gets its own gain
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto level = gain.getNextValue() * audible.getNextValue();
+        auto panPosition = pan.getNextValue();
+
+        if (right == nullptr)
+        {
+            left[i] *= level;
+            continue;
+        }
+
+        float leftGain, rightGain;
+        getPanGains(panPosition, leftGain, rightGain);
+        left[i] *= level * leftGain;
+        right[i] *= level * rightGain;
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "AudioNode.h"
+
+#include <memory>
+
+/**
+ * Track is a channel strip: an optional audio source followed by gain, pan,
+ * mute and solo.
+ *
+ * Mixer controls are set through MixGraph and reach the track on the audio
+ * thread between blocks; gain, pan and mute are then smoothed sample by
+ * sample so changes never click or zipper, however often they arrive.
+ * Solo is resolved by the mix graph, which tells each track whether another
+ * track's solo silences it.
+ */
+class Track : public AudioNode
+{
+public:
+    explicit Track(const juce::String& name, std::unique_ptr<juce::AudioSource> source = nullptr);
+    ~Track() override;
+
+    const juce::String& getName() const { return name; }
+
+    // Message thread: the values last set through MixGraph
+    float getGain() const { return getParameter(Parameter::gain); }
+    float getPan() const { return getParameter(Parameter::pan); }
+    bool isMuted() const { return getParameter(Parameter::mute) != 0.0f; }
+    bool isSoloed() const { return getParameter(Parameter::solo) != 0.0f; }
+
+    // Audio thread: solo as applied, and whether another track's solo silences this one
+    bool isSoloActive() const noexcept { return soloActive; }
+    void setSoloedOut(bool isSoloedOut) noexcept { soloedOut = isSoloedOut; }
+
+    // AudioNode
+    void prepareToPlay(double sampleRate, int maximumBlockSize) override;
+    void releaseResources() override;
+    void process(juce::AudioBuffer<float>& buffer, int numSamples) noexcept override;
+    void parameterChanged(Parameter parameter, float value) noexcept override;
+
+    static constexpr double smoothingSeconds = 0.02;
+
+private:
+    const juce::String name;
+    std::unique_ptr<juce::AudioSource> source;
+
+    // Audio thread state
+    juce::SmoothedValue<float> gain{1.0f};
+    juce::SmoothedValue<float> pan{0.0f};
+    juce::SmoothedValue<float> audible{1.0f}; // 0 when muted or soloed out
+    bool muted = false;
+    bool soloActive = false;
+    bool soloedOut = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Track)
+};
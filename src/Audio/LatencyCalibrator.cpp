@@ -0,0 +1,201 @@
+#include "LatencyCalibrator.h"
+
+LatencyCalibrator::LatencyCalibrator()
+{
+    // x^15 + x^14 + 1 is primitive, so the register runs through every state but zero
+    constexpr int length = (1 << mlsOrder) - 1;
+    stimulus.resize(length);
+
+    juce::uint32 state = 1;
+
+    for (auto& sample : stimulus)
+    {
+        auto bit = ((state >> 14) ^ (state >> 13)) & 1u;
+        state = ((state << 1) | bit) & static_cast<juce::uint32>(length);
+        sample = (state & 1u) != 0 ? stimulusLevel : -stimulusLevel;
+    }
+}
+
+LatencyCalibrator::~LatencyCalibrator()
+{
+    stopTimer();
+}
+
+juce::Result LatencyCalibrator::start(double rate, int input, int output,
+                                      std::function<void(const Measurement&)> onComplete)
+{
+    if (isMeasuring())
+    {
+        return juce::Result::fail("A measurement is already running");
+    }
+
+    if (rate <= 0.0)
+    {
+        return juce::Result::fail("No audio device is running");
+    }
+
+    sampleRate = rate;
+    inputChannel = input;
+    outputChannel = output;
+    maxLag = static_cast<int>(rate * maxLatencySeconds);
+    completion = std::move(onComplete);
+
+    // Not touched by process() until 'measuring' is set under the lock below
+    recorded.assign(stimulus.size() + static_cast<size_t>(maxLag), 0.0f);
+    position = 0;
+    captured = false;
+
+    {
+        const juce::SpinLock::ScopedLockType sl(lock);
+        measuring = true;
+    }
+
+    startTimerHz(20);
+    return juce::Result::ok();
+}
+
+void LatencyCalibrator::cancel()
+{
+    {
+        const juce::SpinLock::ScopedLockType sl(lock);
+        measuring = false;
+    }
+
+    stopTimer();
+    captured = false;
+    completion = nullptr;
+}
+
+bool LatencyCalibrator::process(juce::AudioBuffer<float>& buffer, int startSample,
+                                int numSamples) noexcept
+{
+    const juce::SpinLock::ScopedTryLockType sl(lock);
+
+    if (!sl.isLocked() || !measuring.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+
+    auto total = static_cast<int>(recorded.size());
+    auto numToRecord = juce::jmin(numSamples, total - position);
+
+    if (inputChannel < buffer.getNumChannels())
+    {
+        std::copy_n(buffer.getReadPointer(inputChannel, startSample), numToRecord,
+                    recorded.data() + position);
+    }
+
+    // Nothing but the stimulus goes out while the loop is being measured
+    buffer.clear(startSample, numSamples);
+
+    auto stimulusLength = static_cast<int>(stimulus.size());
+
+    if (outputChannel < buffer.getNumChannels() && position < stimulusLength)
+    {
+        auto numToPlay = juce::jmin(numSamples, stimulusLength - position);
+        buffer.copyFrom(outputChannel, startSample, stimulus.data() + position, numToPlay);
+    }
+
+    position += numToRecord;
+
+    if (position >= total)
+    {
+        measuring.store(false, std::memory_order_relaxed);
+        captured.store(true, std::memory_order_release);
+    }
+
+    return true;
+}
+
+void LatencyCalibrator::timerCallback()
+{
+    if (!captured.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    stopTimer();
+    captured = false;
+
+    auto measurement = findDelay(stimulus, recorded, maxLag, sampleRate);
+
+    DBG("LatencyCalibrator: " + (measurement.succeeded
+                                     ? juce::String(measurement.roundTripSamples) + " samples"
+                                     : measurement.error));
+
+    if (auto onComplete = std::move(completion))
+    {
+        completion = nullptr;
+        onComplete(measurement);
+    }
+}
+
+LatencyCalibrator::Measurement LatencyCalibrator::findDelay(const std::vector<float>& stimulus,
+                                                            const std::vector<float>& recorded,
+                                                            int maxLag, double sampleRate)
+{
+    Measurement measurement;
+
+    // Linear (not circular) correlation: pad past the longest signal plus the stimulus
+    auto minimumSize = recorded.size() + stimulus.size();
+    int order = 1;
+
+    while ((static_cast<size_t>(1) << order) < minimumSize)
+    {
+        ++order;
+    }
+
+    juce::dsp::FFT fft(order);
+    auto size = static_cast<size_t>(fft.getSize());
+
+    std::vector<float> recordedSpectrum(size * 2, 0.0f);
+    std::vector<float> stimulusSpectrum(size * 2, 0.0f);
+    std::copy(recorded.begin(), recorded.end(), recordedSpectrum.begin());
+    std::copy(stimulus.begin(), stimulus.end(), stimulusSpectrum.begin());
+
+    fft.performRealOnlyForwardTransform(recordedSpectrum.data());
+    fft.performRealOnlyForwardTransform(stimulusSpectrum.data());
+
+    // Recorded times the conjugate of the stimulus: the inverse is their cross-correlation
+    auto* x = reinterpret_cast<std::complex<float>*>(recordedSpectrum.data());
+    auto* y = reinterpret_cast<std::complex<float>*>(stimulusSpectrum.data());
+
+    for (size_t bin = 0; bin < size; ++bin)
+    {
+        x[bin] *= std::conj(y[bin]);
+    }
+
+    fft.performRealOnlyInverseTransform(recordedSpectrum.data());
+
+    // Either polarity counts: some interfaces invert on the way round
+    auto numLags = juce::jmin(static_cast<size_t>(maxLag) + 1, size);
+    double sumOfSquares = 0.0;
+    float peak = 0.0f;
+    int peakLag = 0;
+
+    for (size_t lag = 0; lag < numLags; ++lag)
+    {
+        auto value = std::abs(recordedSpectrum[lag]);
+        sumOfSquares += static_cast<double>(value) * value;
+
+        if (value > peak)
+        {
+            peak = value;
+            peakLag = static_cast<int>(lag);
+        }
+    }
+
+    auto rms = std::sqrt(sumOfSquares / static_cast<double>(numLags));
+    measurement.confidence = rms > 0.0 ? static_cast<float>(peak / rms) : 0.0f;
+
+    if (measurement.confidence < minimumConfidence)
+    {
+        measurement.error = "No loopback signal found (connect an output to an input)";
+        return measurement;
+    }
+
+    measurement.succeeded = true;
+    measurement.roundTripSamples = peakLag;
+    measurement.roundTripMs = peakLag * 1000.0 / sampleRate;
+    return measurement;
+}
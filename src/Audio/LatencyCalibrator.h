@@ -0,0 +1,77 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+/**
+ * LatencyCalibrator measures the true round-trip latency of the audio device.
+ *
+ * It plays a maximum length sequence (MLS) out of one output channel and
+ * records one input channel, which the user loops back to it (a cable, or the
+ * interface's own loopback). Cross-correlating the recording with the sequence
+ * gives a single sharp peak at the round-trip delay, to the sample, including
+ * converter, driver and safety-buffer latency that the buffer size alone
+ * doesn't show.
+ *
+ * While a measurement runs, process() owns the whole block: the stimulus goes
+ * out and nothing else does, so monitoring can't feed back into the loop.
+ * The audio thread only copies into buffers allocated by start(); the
+ * correlation runs afterwards on the message thread.
+ */
+class LatencyCalibrator : private juce::Timer
+{
+public:
+    struct Measurement
+    {
+        bool succeeded = false;
+        int roundTripSamples = 0;
+        double roundTripMs = 0.0;
+        float confidence = 0.0f; // Correlation peak over its RMS (~180 for a clean loop)
+        juce::String error;
+    };
+
+    LatencyCalibrator();
+    ~LatencyCalibrator() override;
+
+    // Message thread: starts a measurement; onComplete is called on the message thread
+    juce::Result start(double sampleRate, int inputChannel, int outputChannel,
+                       std::function<void(const Measurement&)> onComplete);
+    void cancel();
+    bool isMeasuring() const { return measuring.load(); }
+
+    // Audio thread: while measuring, replaces the block with the stimulus and records
+    // the input. Returns false (leaving the buffer alone) when there's nothing to do.
+    bool process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+    // 2^15 - 1 samples: ~0.7 s at 48 kHz, and ~45 dB of correlation gain over noise
+    static constexpr int mlsOrder = 15;
+    static constexpr float stimulusLevel = 0.25f; // -12 dBFS
+    static constexpr double maxLatencySeconds = 0.5;
+    static constexpr float minimumConfidence = 10.0f;
+
+    // Exposed for the analysis: the lag of best alignment of 'stimulus' within 'recorded'
+    static Measurement findDelay(const std::vector<float>& stimulus,
+                                 const std::vector<float>& recorded, int maxLag,
+                                 double sampleRate);
+
+private:
+    void timerCallback() override;
+
+    std::vector<float> stimulus;
+    std::vector<float> recorded;
+    double sampleRate = 48000.0;
+    int inputChannel = 0;
+    int outputChannel = 0;
+    int maxLag = 0;
+    std::function<void(const Measurement&)> completion;
+
+    juce::SpinLock lock; // Held by process(); start() and cancel() only hold it to flip state
+    std::atomic<bool> measuring{false};
+    std::atomic<bool> captured{false};
+    int position = 0; // Audio thread, while measuring
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LatencyCalibrator)
+};
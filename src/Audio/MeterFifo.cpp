@@ -0,0 +1,100 @@
+#include "MeterFifo.h"
+
+//==============================================================================
+// MeterFrame
+//==============================================================================
+
+void MeterFrame::fold(const MeterFrame& other) noexcept
+{
+    if (other.numSamples <= 0)
+    {
+        return;
+    }
+
+    if (numSamples <= 0)
+    {
+        *this = other;
+        return;
+    }
+
+    auto totalSamples = numSamples + other.numSamples;
+
+    for (int channel = 0; channel < maxChannels; ++channel)
+    {
+        peak[channel] = juce::jmax(peak[channel], other.peak[channel]);
+        truePeak[channel] = juce::jmax(truePeak[channel], other.truePeak[channel]);
+
+        // Recombine RMS from the energy of both frames
+        auto energy = rms[channel] * rms[channel] * static_cast<float>(numSamples) +
+                      other.rms[channel] * other.rms[channel] *
+                          static_cast<float>(other.numSamples);
+        rms[channel] = std::sqrt(energy / static_cast<float>(totalSamples));
+    }
+
+    clipped = clipped || other.clipped;
+    numSamples = totalSamples;
+    timestamp = juce::jmax(timestamp, other.timestamp);
+}
+
+//==============================================================================
+// MeterFifo
+//==============================================================================
+
+MeterFifo::MeterFifo(int capacity) : fifo(capacity), frames(static_cast<size_t>(capacity))
+{
+}
+
+void MeterFifo::push(const MeterFrame& frame) noexcept
+{
+    // Flush anything held back while the ring was full first, so frames stay in order
+    if (hasOverflow)
+    {
+        if (!write(overflow))
+        {
+            overflow.fold(frame);
+            return;
+        }
+
+        hasOverflow = false;
+    }
+
+    if (!write(frame))
+    {
+        overflow = frame;
+        hasOverflow = true;
+    }
+}
+
+bool MeterFifo::write(const MeterFrame& frame) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 + size2 < 1)
+    {
+        return false;
+    }
+
+    frames[static_cast<size_t>(size1 > 0 ? start1 : start2)] = frame;
+    fifo.finishedWrite(1);
+    return true;
+}
+
+int MeterFifo::drain(MeterFrame& result) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+
+    for (int i = 0; i < size1; ++i)
+    {
+        result.fold(frames[static_cast<size_t>(start1 + i)]);
+    }
+
+    for (int i = 0; i < size2; ++i)
+    {
+        result.fold(frames[static_cast<size_t>(start2 + i)]);
+    }
+
+    fifo.finishedRead(size1 + size2);
+    return size1 + size2;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+/**
+ * MeterFrame is the level summary of a single audio block for one bus.
+ *
+ * Frames from consecutive blocks can be folded together without losing
+ * anything: peaks keep the maximum, and RMS is recombined from each block's
+ * mean square weighted by its length.
+ */
+struct MeterFrame
+{
+    static constexpr int maxChannels = 2;
+
+    float peak[maxChannels] = {};
+    float rms[maxChannels] = {};
+    float truePeak[maxChannels] = {}; // 4x oversampled inter-sample peak
+    bool clipped = false;
+
+    int numSamples = 0;        // Samples covered by this frame
+    juce::int64 timestamp = 0; // High resolution ticks at the start of the (latest) block
+
+    // Merge another frame into this one
+    void fold(const MeterFrame& other) noexcept;
+};
+
+/**
+ * MeterFifo carries MeterFrames from the audio thread to the UI.
+ *
+ * Single producer (audio thread), single consumer (message thread).
+ * Storage is allocated up front and push() never locks or allocates.
+ *
+ * If the UI falls behind and the ring fills up, new frames are folded into an
+ * overflow frame that is pushed as soon as there is room again, so the UI still
+ * sees every block's peak and energy however slow the message thread is.
+ */
+class MeterFifo
+{
+public:
+    explicit MeterFifo(int capacity = 1024);
+
+    // Audio thread only
+    void push(const MeterFrame& frame) noexcept;
+
+    // Message thread only: folds every pending frame into 'result' and
+    // returns how many frames were drained (0 if nothing new arrived).
+    int drain(MeterFrame& result) noexcept;
+
+private:
+    bool write(const MeterFrame& frame) noexcept;
+
+    juce::AbstractFifo fifo;
+    std::vector<MeterFrame> frames;
+
+    // Producer-side accumulator used while the ring is full
+    MeterFrame overflow;
+    bool hasOverflow = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MeterFifo)
+};
@@ -0,0 +1,42 @@
+#include "BlockClock.h"
+
+#include <cmath>
+
+void BlockClock::prepare(double sampleRate) noexcept
+{
+    nominalSecondsPerSample = 1.0 / sampleRate;
+    secondsPerSample = nominalSecondsPerSample;
+    running = false;
+}
+
+void BlockClock::blockStarted(double callbackTime, int numSamples) noexcept
+{
+    auto error = callbackTime - nextBlockStart;
+
+    if (!running || std::abs(error) > resetThresholdSeconds)
+    {
+        secondsPerSample = nominalSecondsPerSample;
+        blockStart = callbackTime;
+        nextBlockStart = callbackTime + numSamples * secondsPerSample;
+        numCallbacks = 1.0;
+        running = true;
+        return;
+    }
+
+    // Gains of a line fit through every callback since the reset, until they reach those of
+    // the locked loop (damping 0.707)
+    numCallbacks += 1.0;
+    auto k = numCallbacks;
+    auto phaseGain = juce::jmax(2.0 * (2.0 * k - 1.0) / (k * (k + 1.0)),
+                                std::sqrt(2.0) * loopBandwidth);
+    auto rateGain = juce::jmax(6.0 / (k * (k + 1.0)), loopBandwidth * loopBandwidth);
+    auto period = numSamples * secondsPerSample;
+
+    blockStart = nextBlockStart;
+    nextBlockStart += phaseGain * error + period;
+    secondsPerSample += rateGain * error / numSamples;
+
+    // A real device is never this far off; anything more is the loop running away
+    secondsPerSample = juce::jlimit(nominalSecondsPerSample * 0.99,
+                                    nominalSecondsPerSample * 1.01, secondsPerSample);
+}
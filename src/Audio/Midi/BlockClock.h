@@ -0,0 +1,53 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * BlockClock maps wall-clock time onto the audio stream's samples.
+ *
+ * The time an audio callback starts is a poor measure of where its block
+ * sits in time: the OS wakes the callback late by a varying amount, and the
+ * device's clock drifts against the system clock. BlockClock filters the
+ * callback times with a second-order delay-locked loop, tracking both the
+ * start of each block and the real length of a sample.
+ *
+ * After a reset the loop gains follow a least-squares line fit through every
+ * callback so far, so it locks within a few callbacks and keeps tightening;
+ * they bottom out at a fixed loop bandwidth per callback. That averages the
+ * same number of callbacks at any buffer size, which is what it takes for
+ * scheduling jitter to shrink to a fraction of a sample with large buffers
+ * (few callbacks a second) as well as small ones.
+ *
+ * Times are seconds on the Time::getMillisecondCounterHiRes() clock, the one
+ * JUCE timestamps incoming MIDI with. Audio thread only.
+ */
+class BlockClock
+{
+public:
+    void prepare(double sampleRate) noexcept;
+
+    // Called at the start of each block with the time the callback started; a gap of more
+    // than resetThresholdSeconds (an xrun, a stopped device) relocks from scratch
+    void blockStarted(double callbackTime, int numSamples) noexcept;
+
+    // Filtered start of the current block, and seconds per sample as measured
+    double getBlockStartTime() const noexcept { return blockStart; }
+    double getSecondsPerSample() const noexcept { return secondsPerSample; }
+
+    // Position of a time relative to the current block's first sample, in samples
+    double getSamplePosition(double time) const noexcept
+    {
+        return (time - blockStart) / secondsPerSample;
+    }
+
+    static constexpr double loopBandwidth = 1.0e-4; // Radians per callback, once locked
+    static constexpr double resetThresholdSeconds = 0.1;
+
+private:
+    double nominalSecondsPerSample = 1.0 / 44100.0;
+    double secondsPerSample = nominalSecondsPerSample;
+    double blockStart = 0.0;
+    double nextBlockStart = 0.0; // Predicted
+    double numCallbacks = 0.0;   // Since the last reset
+    bool running = false;
+};
@@ -0,0 +1,94 @@
+#include "MidiInputQueue.h"
+
+#include <algorithm>
+
+MidiInputQueue::MidiInputQueue(int capacity)
+    : fifo(capacity), events(static_cast<size_t>(capacity))
+{
+    // Room for a full ring in one block (each event is stored with a 6-byte header)
+    block.ensureSize(static_cast<size_t>(capacity) * (sizeof(Event::bytes) + 6));
+}
+
+MidiInputQueue::~MidiInputQueue() = default;
+
+void MidiInputQueue::prepare(double sampleRate, int maximumBlockSize)
+{
+    clock.prepare(sampleRate);
+    latencySamples = maximumBlockSize + juce::roundToInt(sampleRate * callbackJitterSeconds);
+}
+
+void MidiInputQueue::push(const juce::MidiMessage& message) noexcept
+{
+    auto size = message.getRawDataSize();
+
+    if (size > static_cast<int>(sizeof(Event::bytes)))
+    {
+        return;
+    }
+
+    // Never later than now: a stamp from the future would hold up the whole queue
+    auto now = juce::Time::getMillisecondCounterHiRes() * 0.001;
+    auto timestamp = message.getTimeStamp();
+
+    Event event;
+    event.time = timestamp > 0.0 ? juce::jmin(timestamp, now) : now;
+    event.size = static_cast<juce::uint8>(size);
+    std::copy(message.getRawData(), message.getRawData() + size, event.bytes);
+
+    const juce::SpinLock::ScopedLockType sl(writeLock);
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 + size2 < 1)
+    {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    events[static_cast<size_t>(size1 > 0 ? start1 : start2)] = event;
+    fifo.finishedWrite(1);
+}
+
+void MidiInputQueue::collect(double callbackTime, int numSamples) noexcept
+{
+    block.clear();
+    clock.blockStarted(callbackTime, numSamples);
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+    int numRead = 0;
+
+    // Stops at the first message due after this block; it and the rest stay queued
+    auto take = [this, numSamples, &numRead](int start, int size)
+    {
+        for (int i = start; i < start + size; ++i)
+        {
+            const auto& event = events[static_cast<size_t>(i)];
+            auto offset = juce::roundToInt(clock.getSamplePosition(event.time) + latencySamples);
+
+            if (offset >= numSamples)
+            {
+                return false;
+            }
+
+            // Anything older than a block (the clock just relocked) plays straight away
+            block.addEvent(event.bytes, event.size, juce::jmax(0, offset));
+            ++numRead;
+        }
+
+        return true;
+    };
+
+    if (take(start1, size1))
+    {
+        take(start2, size2);
+    }
+
+    fifo.finishedRead(numRead);
+}
+
+void MidiInputQueue::handleIncomingMidiMessage(juce::MidiInput*, const juce::MidiMessage& message)
+{
+    push(message);
+}
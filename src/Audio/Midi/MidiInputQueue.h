@@ -0,0 +1,75 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "BlockClock.h"
+
+#include <atomic>
+#include <vector>
+
+/**
+ * MidiInputQueue carries live MIDI from the input devices to the audio thread.
+ *
+ * Every message is queued with its timestamp. Devices call in on their own
+ * threads, so producers take a spin lock among themselves; the audio thread
+ * never takes it and reads the ring without locking or allocating.
+ *
+ * Once per block the audio thread collects what is due into a MidiBuffer with
+ * sample offsets. Rather than land everything at the start of the block,
+ * each message is placed where it arrived, a fixed latency later: the
+ * BlockClock maps its timestamp onto the audio stream, and the latency of one
+ * block plus callbackJitterSeconds covers messages that arrive just after a
+ * callback woke up early. Messages keep their spacing to within a fraction of
+ * a sample, whatever the buffer size and however unevenly the callbacks run.
+ *
+ * Only short messages are queued; SysEx from a live input is dropped.
+ */
+class MidiInputQueue : public juce::MidiInputCallback
+{
+public:
+    explicit MidiInputQueue(int capacity = 4096);
+    ~MidiInputQueue() override;
+
+    // Before the audio starts, with the largest block expected
+    void prepare(double sampleRate, int maximumBlockSize);
+
+    // Any thread: queues a message stamped in seconds on the
+    // Time::getMillisecondCounterHiRes() clock (0 means now)
+    void push(const juce::MidiMessage& message) noexcept;
+
+    // Audio thread, once per block with the time its callback started: fills the block's
+    // buffer with every message due in it
+    void collect(double callbackTime, int numSamples) noexcept;
+
+    // Audio thread and pool workers, valid for the block being processed
+    const juce::MidiBuffer& getBlock() const noexcept { return block; }
+
+    int getLatencySamples() const noexcept { return latencySamples; }
+    int getNumDropped() const noexcept { return dropped.load(std::memory_order_relaxed); }
+
+    // How much earlier than usual a callback may start without misplacing messages
+    static constexpr double callbackJitterSeconds = 0.001;
+
+    // MidiInputCallback (device threads)
+    void handleIncomingMidiMessage(juce::MidiInput* source,
+                                   const juce::MidiMessage& message) override;
+
+private:
+    struct Event
+    {
+        double time = 0.0;
+        juce::uint8 bytes[3] = {};
+        juce::uint8 size = 0;
+    };
+
+    juce::SpinLock writeLock; // Producers only
+    juce::AbstractFifo fifo;
+    std::vector<Event> events;
+    std::atomic<int> dropped{0};
+
+    // Audio thread
+    BlockClock clock;
+    juce::MidiBuffer block;
+    int latencySamples = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiInputQueue)
+};
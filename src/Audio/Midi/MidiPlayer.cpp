@@ -0,0 +1,132 @@
+#include "MidiPlayer.h"
+#include "../Session/SessionPublisher.h"
+#include "../Transport.h"
+#include "MidiInputQueue.h"
+
+MidiPlayer::MidiPlayer(SessionPublisher& sessionPublisher, RoutingGraph::NodeID track,
+                       const Transport& playhead, const MidiInputQueue& input)
+    : session(sessionPublisher), trackId(track), transport(playhead), liveInput(input)
+{
+}
+
+MidiPlayer::~MidiPlayer() = default;
+
+void MidiPlayer::setClips(const std::vector<MidiClip>& clips)
+{
+    setSequence(MidiSequence::compile(clips));
+}
+
+void MidiPlayer::setSequence(std::shared_ptr<const MidiSequence> newSequence)
+{
+    const auto& latest = session.getLatest();
+    auto track = latest.copyTrack(trackId);
+    track.midi = std::move(newSequence);
+    session.publish(latest.withTrack(std::move(track)));
+}
+
+void MidiPlayer::renderBlock(juce::MidiBuffer& midi, int numSamples) noexcept
+{
+    midi.clear();
+
+    const auto* track = session.get().findTrack(trackId);
+    const auto* sequence = track != nullptr ? track->midi.get() : nullptr;
+
+    if (!transport.isBlockPlaying() || sequence == nullptr)
+    {
+        releaseAll(midi);
+        nextPosition = -1;
+    }
+    else
+    {
+        const auto& events = *sequence;
+        auto position = transport.getBlockPosition();
+
+        // A seek, a restart or an edit: the only time the cursor is searched for
+        if (position != nextPosition || events.getSerial() != cursorSerial)
+        {
+            releaseAll(midi);
+            cursor = events.findFirstEventAt(position);
+            cursorSerial = events.getSerial();
+        }
+
+        auto end = position + numSamples;
+
+        for (; cursor < events.getNumEvents(); ++cursor)
+        {
+            const auto& event = events.getEvent(cursor);
+
+            if (event.time >= end)
+            {
+                break;
+            }
+
+            auto* data = events.getData(event);
+            trackEvent(data, event.size);
+            midi.addEvent(data, static_cast<int>(event.size),
+                          static_cast<int>(event.time - position));
+        }
+
+        nextPosition = end;
+    }
+
+    if (monitoring.load(std::memory_order_relaxed))
+    {
+        midi.addEvents(liveInput.getBlock(), 0, numSamples, 0);
+    }
+}
+
+void MidiPlayer::trackEvent(const juce::uint8* data, juce::uint32 size) noexcept
+{
+    if (size != 3)
+    {
+        return;
+    }
+
+    auto type = data[0] & 0xf0;
+    auto channel = data[0] & 0x0f;
+    auto note = static_cast<size_t>(channel * 128 + (data[1] & 0x7f));
+
+    if (type == 0x90)
+    {
+        sounding.set(note, data[2] != 0);
+    }
+    else if (type == 0x80)
+    {
+        sounding.reset(note);
+    }
+    else if (type == 0xb0 && data[1] == 64)
+    {
+        auto bit = static_cast<juce::uint16>(1 << channel);
+        sustained = static_cast<juce::uint16>(data[2] >= 64 ? sustained | bit : sustained & ~bit);
+    }
+}
+
+void MidiPlayer::releaseAll(juce::MidiBuffer& midi) noexcept
+{
+    if (sounding.none() && sustained == 0)
+    {
+        return;
+    }
+
+    for (int channel = 0; channel < 16; ++channel)
+    {
+        if ((sustained >> channel) & 1)
+        {
+            const juce::uint8 pedalUp[] = {static_cast<juce::uint8>(0xb0 | channel), 64, 0};
+            midi.addEvent(pedalUp, 3, 0);
+        }
+
+        for (int note = 0; note < 128; ++note)
+        {
+            if (sounding[static_cast<size_t>(channel * 128 + note)])
+            {
+                const juce::uint8 noteOff[] = {static_cast<juce::uint8>(0x80 | channel),
+                                               static_cast<juce::uint8>(note), 0};
+                midi.addEvent(noteOff, 3, 0);
+            }
+        }
+    }
+
+    sounding.reset();
+    sustained = 0;
+}
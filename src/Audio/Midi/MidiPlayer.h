@@ -0,0 +1,67 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../Graph/RoutingGraph.h"
+#include "MidiSequence.h"
+
+#include <atomic>
+#include <bitset>
+#include <memory>
+#include <vector>
+
+class MidiInputQueue;
+class SessionPublisher;
+class Transport;
+
+/**
+ * MidiPlayer renders a track's MIDI, block by block, at the transport position.
+ *
+ * It plays a compiled MidiSequence with a cursor: each block takes the events
+ * from the cursor up to the block's end, with sample offsets taken straight
+ * from their timeline positions, so playback is sample-accurate and costs
+ * nothing per block beyond the events themselves. The cursor is only
+ * relocated (a binary search) when the block doesn't follow on from the last
+ * one: a seek, a restart or a new sequence. Notes and the sustain pedal left
+ * on at that point, or when the transport stops, are released.
+ *
+ * While monitoring, the block's live input (MidiInputQueue) is merged in.
+ * The sequence lives in the session, as ClipPlayer's clips do: edits compile
+ * a new one on the message thread and publish it in a new SessionSnapshot,
+ * and each block plays the track's sequence in the snapshot for that block.
+ */
+class MidiPlayer
+{
+public:
+    MidiPlayer(SessionPublisher& session, RoutingGraph::NodeID trackId, const Transport& transport,
+               const MidiInputQueue& liveInput);
+    ~MidiPlayer();
+
+    // Message thread: each edit publishes a new session version
+    void setClips(const std::vector<MidiClip>& clips);
+    void setSequence(std::shared_ptr<const MidiSequence> newSequence);
+    void setMonitoring(bool shouldMonitor) { monitoring.store(shouldMonitor); }
+
+    // Audio thread and pool workers: replaces midi's contents with this block's events.
+    // Reserve room in midi up front (MidiBuffer::ensureSize) and this never allocates.
+    void renderBlock(juce::MidiBuffer& midi, int numSamples) noexcept;
+
+private:
+    void trackEvent(const juce::uint8* data, juce::uint32 size) noexcept;
+    void releaseAll(juce::MidiBuffer& midi) noexcept;
+
+    SessionPublisher& session;
+    const RoutingGraph::NodeID trackId;
+    const Transport& transport;
+    const MidiInputQueue& liveInput;
+
+    std::atomic<bool> monitoring{false};
+
+    // Audio thread
+    juce::uint64 cursorSerial = 0; // The sequence the cursor points into
+    int cursor = 0;
+    juce::int64 nextPosition = -1; // Where the next block starts if nothing jumps
+    std::bitset<16 * 128> sounding;
+    juce::uint16 sustained = 0; // One bit per channel
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiPlayer)
+};
@@ -0,0 +1,129 @@
+#include "MidiSequence.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cmath>
+
+namespace
+{
+// Order among events at the same position: note-offs, then everything else, then note-ons
+int getPriority(const MidiSequence::Event& event)
+{
+    if (event.size > 4)
+    {
+        return 1;
+    }
+
+    auto type = event.bytes[0] & 0xf0;
+    auto velocity = event.size > 2 ? event.bytes[2] : 0;
+
+    if (type == 0x80 || (type == 0x90 && velocity == 0))
+    {
+        return 0;
+    }
+
+    return type == 0x90 ? 2 : 1;
+}
+
+size_t getNoteIndex(const juce::MidiMessage& message)
+{
+    return static_cast<size_t>((message.getChannel() - 1) * 128 + message.getNoteNumber());
+}
+} // namespace
+
+std::shared_ptr<const MidiSequence> MidiSequence::compile(const std::vector<MidiClip>& clips)
+{
+    static std::atomic<juce::uint64> nextSerial{0};
+
+    std::shared_ptr<MidiSequence> sequence(new MidiSequence());
+    sequence->serial = ++nextSerial;
+
+    for (const auto& clip : clips)
+    {
+        // Notes still sounding, per channel and note number
+        std::bitset<16 * 128> held;
+
+        for (const auto* holder : clip.events)
+        {
+            const auto& message = holder->message;
+            auto time = static_cast<juce::int64>(std::llround(message.getTimeStamp()));
+
+            // Meta events (tempo, names) come from MIDI files and are never sent
+            if (message.isMetaEvent() || time < 0 || time >= clip.length)
+            {
+                continue;
+            }
+
+            if (message.isNoteOn())
+            {
+                held.set(getNoteIndex(message));
+            }
+            else if (message.isNoteOff())
+            {
+                held.reset(getNoteIndex(message));
+            }
+
+            sequence->addEvent(clip.timelineStart + time, message.getRawData(),
+                               message.getRawDataSize());
+        }
+
+        for (size_t i = 0; i < held.size(); ++i)
+        {
+            if (held[i])
+            {
+                auto noteOff = juce::MidiMessage::noteOff(static_cast<int>(i / 128) + 1,
+                                                          static_cast<int>(i % 128));
+                sequence->addEvent(clip.timelineStart + clip.length, noteOff.getRawData(),
+                                   noteOff.getRawDataSize());
+            }
+        }
+    }
+
+    // Clips may overlap, so merge them here rather than on the audio thread
+    std::stable_sort(sequence->events.begin(), sequence->events.end(),
+                     [](const Event& a, const Event& b)
+                     {
+                         if (a.time != b.time)
+                         {
+                             return a.time < b.time;
+                         }
+
+                         return getPriority(a) < getPriority(b);
+                     });
+
+    return sequence;
+}
+
+void MidiSequence::addEvent(juce::int64 time, const juce::uint8* data, int size)
+{
+    Event event;
+    event.time = time;
+    event.size = static_cast<juce::uint32>(size);
+
+    if (size <= 4)
+    {
+        std::copy(data, data + size, event.bytes);
+    }
+    else
+    {
+        event.offset = static_cast<juce::uint32>(longData.size());
+        longData.insert(longData.end(), data, data + size);
+    }
+
+    events.push_back(event);
+}
+
+const juce::uint8* MidiSequence::getData(const Event& event) const noexcept
+{
+    return event.size <= 4 ? event.bytes : longData.data() + event.offset;
+}
+
+int MidiSequence::findFirstEventAt(juce::int64 position) const noexcept
+{
+    auto it = std::lower_bound(events.begin(), events.end(), position,
+                               [](const Event& event, juce::int64 time)
+                               { return event.time < time; });
+
+    return static_cast<int>(std::distance(events.begin(), it));
+}
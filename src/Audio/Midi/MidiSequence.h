@@ -0,0 +1,71 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <memory>
+#include <vector>
+
+/** A MIDI clip on a track, as edited on the message thread. */
+struct MidiClip
+{
+    juce::int64 timelineStart = 0; // Where the clip starts on the timeline
+    juce::int64 length = 0;        // Timeline samples; events at or after the end are cut
+    juce::MidiMessageSequence events; // Timestamps in samples from the clip start
+};
+
+/**
+ * MidiSequence is a track's MIDI clips compiled for playback.
+ *
+ * Every event of every clip is flattened into one array sorted by timeline
+ * position, 16 bytes per event with short messages stored inline, so the
+ * audio thread walks it front to back like a stream (see MidiPlayer). SysEx
+ * bytes live in a side array. Notes still held at a clip's end get a note-off
+ * there, and at equal positions note-offs come before controllers and
+ * controllers before note-ons, so a re-struck note is never cut short.
+ *
+ * A compiled sequence is immutable and shared: edits compile a new one on the
+ * message thread and publish it with the rest of the session (see
+ * SessionSnapshot).
+ */
+class MidiSequence
+{
+public:
+    struct Event
+    {
+        juce::int64 time = 0;  // Timeline samples
+        juce::uint32 size = 0; // Bytes in the message
+
+        union
+        {
+            juce::uint8 bytes[4]{}; // Messages of up to 4 bytes
+            juce::uint32 offset;    // Longer ones: start in the SysEx data
+        };
+    };
+
+    // Message thread
+    static std::shared_ptr<const MidiSequence> compile(const std::vector<MidiClip>& clips);
+
+    int getNumEvents() const noexcept { return static_cast<int>(events.size()); }
+    const Event& getEvent(int index) const noexcept
+    {
+        return events[static_cast<size_t>(index)];
+    }
+    const juce::uint8* getData(const Event& event) const noexcept;
+
+    // Index of the first event at or after position (a binary search, for relocating only)
+    int findFirstEventAt(juce::int64 position) const noexcept;
+
+    // Unique to each compiled sequence, unlike its address, which a later one may reuse
+    juce::uint64 getSerial() const noexcept { return serial; }
+
+private:
+    MidiSequence() = default;
+
+    void addEvent(juce::int64 time, const juce::uint8* data, int size);
+
+    std::vector<Event> events;
+    std::vector<juce::uint8> longData;
+    juce::uint64 serial = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiSequence)
+};
@@ -0,0 +1,155 @@
+#include "OfflineRenderer.h"
+#include "AudioEngine.h"
+
+double OfflineRenderer::Report::getRealtimeFactor() const
+{
+    if (renderSeconds <= 0.0 || sampleRate <= 0.0)
+    {
+        return 0.0;
+    }
+
+    return (static_cast<double>(samplesRendered) / sampleRate) / renderSeconds;
+}
+
+OfflineRenderer::OfflineRenderer(AudioEngine& audioEngine) : engine(audioEngine)
+{
+    formatManager.registerBasicFormats();
+}
+
+OfflineRenderer::~OfflineRenderer() = default;
+
+juce::Result OfflineRenderer::setInputFile(const juce::File& file)
+{
+    reader.reset(formatManager.createReaderFor(file));
+
+    if (reader == nullptr)
+    {
+        return juce::Result::fail("Could not open audio file: " + file.getFullPathName());
+    }
+
+    return juce::Result::ok();
+}
+
+void OfflineRenderer::setSyntheticInput(Signal newSignal)
+{
+    reader.reset();
+    signal = newSignal;
+    phase = 0.0;
+}
+
+void OfflineRenderer::fillSynthetic(juce::AudioBuffer<float>& buffer, int numSamples,
+                                    double sampleRate)
+{
+    if (signal == Signal::silence)
+    {
+        buffer.clear(0, numSamples);
+        return;
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float sample = 0.0f;
+
+        if (signal == Signal::sine)
+        {
+            // 440 Hz at -6 dBFS
+            sample = 0.5f * static_cast<float>(std::sin(phase));
+            phase += juce::MathConstants<double>::twoPi * 440.0 / sampleRate;
+            if (phase >= juce::MathConstants<double>::twoPi)
+            {
+                phase -= juce::MathConstants<double>::twoPi;
+            }
+        }
+        else
+        {
+            sample = (random.nextFloat() * 2.0f - 1.0f) * 0.5f;
+        }
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            buffer.setSample(channel, i, sample);
+        }
+    }
+}
+
+juce::Result OfflineRenderer::render(const Options& options, Report& report)
+{
+    report = Report();
+
+    auto sampleRate = reader != nullptr ? reader->sampleRate : options.sampleRate;
+    auto numChannels = reader != nullptr ? static_cast<int>(reader->numChannels)
+                                         : options.numChannels;
+    auto totalSamples = reader != nullptr
+                            ? reader->lengthInSamples
+                            : static_cast<juce::int64>(options.lengthSeconds * sampleRate);
+
+    if (sampleRate <= 0.0 || options.blockSize <= 0 || numChannels <= 0 || totalSamples <= 0)
+    {
+        return juce::Result::fail("Invalid render options");
+    }
+
+    numChannels = juce::jmin(numChannels, AudioEngine::maxOfflineChannels);
+
+    // Output writer (takes ownership of the stream once created)
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+
+    if (outputFile != juce::File())
+    {
+        outputFile.deleteFile();
+        auto stream = outputFile.createOutputStream();
+
+        if (stream == nullptr)
+        {
+            return juce::Result::fail("Could not write " + outputFile.getFullPathName());
+        }
+
+        juce::WavAudioFormat wavFormat;
+        writer.reset(wavFormat.createWriterFor(stream.get(), sampleRate,
+                                               static_cast<unsigned int>(numChannels), 24, {}, 0));
+
+        if (writer == nullptr)
+        {
+            return juce::Result::fail("Could not create WAV writer");
+        }
+
+        stream.release();
+    }
+
+    juce::AudioBuffer<float> buffer(numChannels, options.blockSize);
+    engine.prepareToPlay(options.blockSize, sampleRate);
+
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    for (juce::int64 position = 0; position < totalSamples; position += options.blockSize)
+    {
+        auto numSamples = static_cast<int>(
+            juce::jmin(static_cast<juce::int64>(options.blockSize), totalSamples - position));
+
+        if (reader != nullptr)
+        {
+            reader->read(&buffer, 0, numSamples, position, true, true);
+        }
+        else
+        {
+            fillSynthetic(buffer, numSamples, sampleRate);
+        }
+
+        juce::AudioSourceChannelInfo info(&buffer, 0, numSamples);
+        engine.getNextAudioBlock(info);
+
+        if (writer != nullptr)
+        {
+            writer->writeFromAudioSampleBuffer(buffer, 0, numSamples);
+        }
+
+        report.samplesRendered += numSamples;
+        ++report.blocksRendered;
+    }
+
+    report.renderSeconds = juce::Time::highResolutionTicksToSeconds(
+        juce::Time::getHighResolutionTicks() - startTicks);
+    report.sampleRate = sampleRate;
+
+    engine.releaseResources();
+    return juce::Result::ok();
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+class AudioEngine;
+
+/**
+ * OfflineRenderer drives an AudioEngine without an audio device.
+ *
+ * Input comes from an audio file or a synthetic signal and is pushed through
+ * the engine's getNextAudioBlock() block by block, as fast as the CPU allows.
+ * The result can be written to a WAV file. Used by the headless target for
+ * rendering, profiling and regression tests on machines with no sound card.
+ */
+class OfflineRenderer
+{
+public:
+    enum class Signal
+    {
+        silence,
+        sine,
+        noise
+    };
+
+    struct Options
+    {
+        double sampleRate = 48000.0; // Ignored for file input (the file's rate is used)
+        int blockSize = 256;
+        int numChannels = 2;         // Ignored for file input
+        double lengthSeconds = 10.0; // Synthetic input only
+    };
+
+    struct Report
+    {
+        juce::int64 samplesRendered = 0;
+        int blocksRendered = 0;
+        double sampleRate = 0.0;
+        double renderSeconds = 0.0;
+
+        // Audio seconds rendered per wall-clock second
+        double getRealtimeFactor() const;
+    };
+
+    explicit OfflineRenderer(AudioEngine& engine);
+    ~OfflineRenderer();
+
+    // Input (a file replaces any synthetic signal and vice versa)
+    juce::Result setInputFile(const juce::File& file);
+    void setSyntheticInput(Signal signal);
+
+    // Optional output; nothing is written if no file is set
+    void setOutputFile(const juce::File& file) { outputFile = file; }
+
+    juce::Result render(const Options& options, Report& report);
+
+private:
+    void fillSynthetic(juce::AudioBuffer<float>& buffer, int numSamples, double sampleRate);
+
+    AudioEngine& engine;
+    juce::AudioFormatManager formatManager;
+    std::unique_ptr<juce::AudioFormatReader> reader;
+
+    Signal signal = Signal::sine;
+    double phase = 0.0;
+    juce::Random random;
+
+    juce::File outputFile;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OfflineRenderer)
+};
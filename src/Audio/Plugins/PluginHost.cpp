@@ -0,0 +1,72 @@
+#include "PluginHost.h"
+
+PluginHost::PluginHost()
+    : sandboxExecutable(getDefaultSandboxExecutable()),
+      scanner(formatManager, knownPlugins, sandboxExecutable)
+{
+    formatManager.addDefaultFormats();
+}
+
+PluginHost::~PluginHost() = default;
+
+void PluginHost::setSandboxExecutable(const juce::File& executable)
+{
+    sandboxExecutable = executable;
+    scanner.setExecutable(executable);
+}
+
+juce::File PluginHost::getDefaultSandboxExecutable()
+{
+    auto sibling = juce::File::getSpecialLocation(juce::File::currentExecutableFile)
+                       .getSiblingFile("DAIW_PluginSandbox");
+
+#ifdef DAIW_PLUGIN_SANDBOX_PATH
+    if (!sibling.existsAsFile())
+    {
+        return juce::File(DAIW_PLUGIN_SANDBOX_PATH);
+    }
+#endif
+
+    return sibling;
+}
+
+std::unique_ptr<PluginSlot> PluginHost::createSlot(const juce::PluginDescription& description,
+                                                   double sampleRate, int maximumBlockSize,
+                                                   int numChannels, juce::String& error)
+{
+    std::unique_ptr<PluginSlot> slot;
+
+    if (isSandboxed())
+    {
+        if (!sandboxExecutable.existsAsFile())
+        {
+            error = "Plugin sandbox not found at " + sandboxExecutable.getFullPathName();
+            return nullptr;
+        }
+
+        slot = std::make_unique<PluginSlot>(
+            std::make_unique<PluginSandbox>(sandboxExecutable, description, numChannels));
+    }
+    else
+    {
+        auto instance = formatManager.createPluginInstance(description, sampleRate,
+                                                           maximumBlockSize, error);
+
+        if (instance == nullptr)
+        {
+            return nullptr;
+        }
+
+        slot = std::make_unique<PluginSlot>(std::move(instance), numChannels);
+    }
+
+    auto result = slot->prepareToPlay(sampleRate, maximumBlockSize);
+
+    if (result.failed())
+    {
+        error = result.getErrorMessage();
+        return nullptr;
+    }
+
+    return slot;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginScanner.h"
+#include "PluginSlot.h"
+
+#include <memory>
+
+/**
+ * PluginHost finds plugins (through a PluginScanner) and loads them into
+ * PluginSlots.
+ *
+ * With sandboxing on, each plugin runs in its own DAIW_PluginSandbox process
+ * (see PluginSandbox), so a plugin that crashes or hangs costs its own slot a
+ * few dry blocks and a restart instead of taking the session down with it. It
+ * is off by default, since every block then pays a round trip to another
+ * process, and unavailable where shared memory isn't (Windows), where plugins
+ * are always hosted in process.
+ */
+class PluginHost
+{
+public:
+    PluginHost();
+    ~PluginHost();
+
+    juce::AudioPluginFormatManager& getFormatManager() { return formatManager; }
+    juce::KnownPluginList& getKnownPlugins() { return knownPlugins; }
+    PluginScanner& getScanner() { return scanner; }
+
+    // Message thread: rescans changed binaries in the background (see PluginScanner)
+    void scanForPlugins() { scanner.startScan(); }
+
+    void setSandboxed(bool shouldSandbox) { sandboxed = shouldSandbox; }
+    bool isSandboxed() const { return sandboxed && SharedMemory::isSupported(); }
+
+    // Also runs the scanner processes. Defaults to getDefaultSandboxExecutable().
+    void setSandboxExecutable(const juce::File& executable);
+    const juce::File& getSandboxExecutable() const { return sandboxExecutable; }
+
+    // Next to the running executable, or failing that where the build put it
+    static juce::File getDefaultSandboxExecutable();
+
+    // Message thread: a prepared slot, or nullptr with the reason in error
+    std::unique_ptr<PluginSlot> createSlot(const juce::PluginDescription& description,
+                                           double sampleRate, int maximumBlockSize,
+                                           int numChannels, juce::String& error);
+
+private:
+    juce::AudioPluginFormatManager formatManager;
+    juce::KnownPluginList knownPlugins;
+
+    bool sandboxed = false;
+    juce::File sandboxExecutable;
+    PluginScanner scanner;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginHost)
+};
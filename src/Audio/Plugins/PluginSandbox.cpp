@@ -0,0 +1,293 @@
+#include "PluginSandbox.h"
+#include "SandboxProtocol.h"
+
+PluginSandbox::PluginSandbox(const juce::File& sandboxExecutable,
+                             const juce::PluginDescription& plugin, int channels)
+    : executable(sandboxExecutable), description(plugin), numChannels(channels)
+{
+}
+
+PluginSandbox::~PluginSandbox()
+{
+    shuttingDown = true;
+    cancelPendingUpdate();
+    terminate();
+}
+
+juce::Result PluginSandbox::prepare(double newSampleRate, int newMaximumBlockSize)
+{
+    terminate();
+    cancelPendingUpdate();
+
+    sampleRate = newSampleRate;
+    maximumBlockSize = newMaximumBlockSize;
+    replyMicrosecondsPerSample = replyTimeout * 1.0e6 / sampleRate;
+    restartTimes.clear();
+
+    channel = SandboxChannel::create(numChannels, maximumBlockSize);
+
+    if (channel == nullptr)
+    {
+        return juce::Result::fail("Couldn't create shared memory for the plugin sandbox");
+    }
+
+    auto result = launch();
+
+    if (result.failed())
+    {
+        return result;
+    }
+
+    if (!loadFinished.wait(loadTimeoutMs))
+    {
+        terminate();
+        return juce::Result::fail(description.name + " took too long to load in its sandbox");
+    }
+
+    if (!running.load())
+    {
+        terminate();
+        const juce::ScopedLock sl(stateLock);
+        return juce::Result::fail(loadError);
+    }
+
+    return juce::Result::ok();
+}
+
+void PluginSandbox::release()
+{
+    cancelPendingUpdate();
+    terminate();
+    channel.reset();
+}
+
+bool PluginSandbox::process(juce::AudioBuffer<float>& buffer, int numSamples,
+                            const juce::MidiBuffer& midi) noexcept
+{
+    // Counted before running is checked, so terminate() either sees this call or this call
+    // sees running cleared (both sequentially consistent)
+    activeCalls.fetch_add(1);
+    auto processed = running.load() && processBlock(buffer, numSamples, midi);
+    activeCalls.fetch_sub(1);
+    return processed;
+}
+
+bool PluginSandbox::processBlock(juce::AudioBuffer<float>& buffer, int numSamples,
+                                 const juce::MidiBuffer& midi) noexcept
+{
+    if (numSamples > maximumBlockSize)
+    {
+        return false;
+    }
+
+    ++sequence;
+
+    // A sandbox that keeps missing isn't waited for again until it is restarted
+    auto timeout = consecutiveMisses < maxWaitedMisses
+                       ? static_cast<int>(numSamples * replyMicrosecondsPerSample)
+                       : 0;
+
+    if (channel->sendBlock(sequence, buffer, numSamples, midi) &&
+        channel->receiveReply(sequence, buffer, numSamples, timeout))
+    {
+        consecutiveMisses = 0;
+        return true;
+    }
+
+    missedBlocks.fetch_add(1, std::memory_order_relaxed);
+
+    if (++consecutiveMisses >= maxMissedBlocks)
+    {
+        // Alive but not keeping up (or hung): treat it as crashed
+        consecutiveMisses = 0;
+        markDown();
+    }
+
+    return false;
+}
+
+void PluginSandbox::setState(const juce::MemoryBlock& state)
+{
+    {
+        const juce::ScopedLock sl(stateLock);
+        savedState = state;
+    }
+
+    if (running.load())
+    {
+        juce::ValueTree message(SandboxProtocol::setState);
+        message.setProperty(SandboxProtocol::state, SandboxProtocol::encodeState(state), nullptr);
+        sendMessageToWorker(SandboxProtocol::toMemory(message));
+    }
+}
+
+juce::MemoryBlock PluginSandbox::getState(int timeoutMs)
+{
+    if (running.load())
+    {
+        stateReceived.reset();
+        juce::ValueTree message(SandboxProtocol::getState);
+
+        if (sendMessageToWorker(SandboxProtocol::toMemory(message)))
+        {
+            stateReceived.wait(timeoutMs);
+        }
+    }
+
+    const juce::ScopedLock sl(stateLock);
+    return savedState;
+}
+
+juce::Result PluginSandbox::launch()
+{
+    loadFinished.reset();
+    {
+        const juce::ScopedLock sl(stateLock);
+        loadError.clear();
+    }
+
+    // No output streams: nothing reads them, and a chatty plugin would fill the pipe and block
+    if (!launchWorkerProcess(executable, SandboxProtocol::commandLineId, pingTimeoutMs, 0))
+    {
+        return juce::Result::fail("Couldn't start " + executable.getFullPathName());
+    }
+
+    juce::ValueTree message(SandboxProtocol::load);
+    message.setProperty(SandboxProtocol::channel, channel->getName(), nullptr);
+    message.setProperty(SandboxProtocol::sampleRate, sampleRate, nullptr);
+    message.setProperty(SandboxProtocol::blockSize, maximumBlockSize, nullptr);
+
+    if (auto xml = description.createXml())
+    {
+        message.setProperty(SandboxProtocol::plugin,
+                            xml->toString(juce::XmlElement::TextFormat().singleLine()), nullptr);
+    }
+
+    {
+        const juce::ScopedLock sl(stateLock);
+
+        if (!savedState.isEmpty())
+        {
+            message.setProperty(SandboxProtocol::state, SandboxProtocol::encodeState(savedState),
+                                nullptr);
+        }
+    }
+
+    if (!sendMessageToWorker(SandboxProtocol::toMemory(message)))
+    {
+        terminate();
+        return juce::Result::fail("Couldn't talk to the plugin sandbox");
+    }
+
+    return juce::Result::ok();
+}
+
+void PluginSandbox::terminate()
+{
+    running = false;
+
+    // A block that got in before that may still be using the channel, for up to one reply
+    // timeout: wait it out, so prepare() and release() can replace the channel safely
+    while (activeCalls.load() > 0)
+    {
+        juce::Thread::yield();
+    }
+
+    // Disconnecting reports a lost connection, which isn't a crash here
+    terminating = true;
+    killWorkerProcess();
+    SandboxProtocol::killProcess(workerProcessId.exchange(0));
+    terminating = false;
+}
+
+void PluginSandbox::markDown()
+{
+    if (running.exchange(false))
+    {
+        triggerAsyncUpdate();
+    }
+}
+
+void PluginSandbox::handleMessageFromWorker(const juce::MemoryBlock& data)
+{
+    auto message = SandboxProtocol::fromMemory(data);
+
+    if (message.hasType(SandboxProtocol::ready))
+    {
+        workerProcessId = static_cast<int>(message[SandboxProtocol::processId]);
+    }
+    else if (message.hasType(SandboxProtocol::loaded))
+    {
+        latency = static_cast<int>(message[SandboxProtocol::latency]);
+        running.store(true, std::memory_order_release);
+        loadFinished.signal();
+    }
+    else if (message.hasType(SandboxProtocol::error))
+    {
+        {
+            const juce::ScopedLock sl(stateLock);
+            loadError = message[SandboxProtocol::message].toString();
+        }
+
+        DBG("Plugin sandbox: " << message[SandboxProtocol::message].toString());
+        loadFinished.signal();
+    }
+    else if (message.hasType(SandboxProtocol::state))
+    {
+        {
+            const juce::ScopedLock sl(stateLock);
+            savedState = SandboxProtocol::decodeState(message[SandboxProtocol::state].toString());
+        }
+
+        stateReceived.signal();
+    }
+}
+
+void PluginSandbox::handleConnectionLost()
+{
+    if (!terminating.load())
+    {
+        DBG("Plugin sandbox for " << description.name << " went away");
+
+        {
+            const juce::ScopedLock sl(stateLock);
+            loadError = description.name + " crashed in its sandbox";
+        }
+
+        // Wakes prepare() if it died while loading
+        loadFinished.signal();
+        markDown();
+    }
+}
+
+void PluginSandbox::handleAsyncUpdate()
+{
+    if (shuttingDown || channel == nullptr || running.load())
+    {
+        return;
+    }
+
+    auto now = juce::Time::getMillisecondCounterHiRes();
+    restartTimes.removeIf([now](double time)
+                          { return now - time > restartWindowSeconds * 1000.0; });
+
+    if (restartTimes.size() >= maxRestarts)
+    {
+        DBG("Plugin sandbox for " << description.name << " keeps failing; leaving it bypassed");
+        terminate();
+        return;
+    }
+
+    restartTimes.add(now);
+    ++numRestarts;
+
+    terminate();
+
+    // The new child picks up from the last known state; running comes back on its reply
+    auto result = launch();
+
+    if (result.failed())
+    {
+        DBG(result.getErrorMessage());
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SandboxChannel.h"
+
+#include <atomic>
+#include <memory>
+
+/**
+ * PluginSandbox runs one plugin instance in a child process.
+ *
+ * The child (DAIW_PluginSandbox) is launched and controlled through JUCE's
+ * coordinator/worker pipe, and loads the plugin itself; each audio block goes
+ * over a SandboxChannel and comes back processed on the same callback. A block
+ * whose reply doesn't arrive within replyTimeout of a block's duration is
+ * passed through dry, so a slow plugin glitches its own track but never stalls
+ * the device. After maxWaitedMisses in a row it stops waiting at all: blocks
+ * are still sent, but only a reply that is already there is taken, so a hung
+ * sandbox (or several in series) costs the callback next to nothing.
+ *
+ * If the child dies, or misses maxMissedBlocks replies in a row, the sandbox
+ * is marked down straight away (process() then returns false and the slot
+ * bypasses it), the child is killed and a new one launched with the last
+ * known plugin state - all without the engine stopping. After maxRestarts
+ * within restartWindowSeconds it stays down until prepare() is called again.
+ */
+class PluginSandbox : private juce::ChildProcessCoordinator, private juce::AsyncUpdater
+{
+public:
+    PluginSandbox(const juce::File& sandboxExecutable, const juce::PluginDescription& plugin,
+                  int numChannels);
+    ~PluginSandbox() override;
+
+    // Message thread: (re)starts the child for this rate and block size; returns once the
+    // plugin has loaded, or failed to, within loadTimeoutMs. Safe while the audio thread is
+    // still calling process(): both wait for a block in flight to finish before touching the
+    // channel, and blocks that start meanwhile are left dry.
+    juce::Result prepare(double sampleRate, int maximumBlockSize);
+    void release();
+
+    // Audio thread: false when the block wasn't processed (the buffer is left dry)
+    bool process(juce::AudioBuffer<float>& buffer, int numSamples,
+                 const juce::MidiBuffer& midi) noexcept;
+
+    bool isRunning() const { return running.load(); }
+    int getLatencySamples() const { return latency.load(); }
+    int getNumRestarts() const { return numRestarts; }
+    juce::int64 getMissedBlocks() const { return missedBlocks.load(); }
+    const juce::PluginDescription& getDescription() const { return description; }
+
+    // Message thread. getState() asks the child for its state, falling back to the last one
+    // it reported (which is also what a restarted child is given) if it doesn't answer.
+    void setState(const juce::MemoryBlock& state);
+    juce::MemoryBlock getState(int timeoutMs = pingTimeoutMs);
+
+    static constexpr int loadTimeoutMs = 10000;
+    static constexpr int pingTimeoutMs = 2000;
+    static constexpr double replyTimeout = 0.75; // Of a block's duration
+    static constexpr int maxWaitedMisses = 2; // Then replies are no longer waited for
+    static constexpr int maxMissedBlocks = 8;
+    static constexpr int maxRestarts = 5;
+    static constexpr double restartWindowSeconds = 60.0;
+
+private:
+    bool processBlock(juce::AudioBuffer<float>& buffer, int numSamples,
+                      const juce::MidiBuffer& midi) noexcept;
+    juce::Result launch();
+    void terminate();
+    void markDown();
+
+    // Coordinator pipe thread
+    void handleMessageFromWorker(const juce::MemoryBlock& message) override;
+    void handleConnectionLost() override;
+
+    // Message thread: restarts a child that went down
+    void handleAsyncUpdate() override;
+
+    const juce::File executable;
+    const juce::PluginDescription description;
+    const int numChannels;
+
+    double sampleRate = 0.0;
+    int maximumBlockSize = 0;
+    std::unique_ptr<SandboxChannel> channel;
+
+    // Message thread
+    int numRestarts = 0;
+    juce::Array<double> restartTimes; // Milliseconds, within the window
+    bool shuttingDown = false;
+
+    std::atomic<bool> running{false};
+    std::atomic<bool> terminating{false};
+    std::atomic<int> latency{0};
+    std::atomic<int> workerProcessId{0};
+    juce::WaitableEvent loadFinished;
+    juce::WaitableEvent stateReceived;
+    juce::CriticalSection stateLock;
+    juce::MemoryBlock savedState;
+    juce::String loadError;
+
+    std::atomic<int> activeCalls{0}; // process() calls in flight
+
+    // Audio thread
+    juce::uint32 sequence = 0;
+    int consecutiveMisses = 0;
+    double replyMicrosecondsPerSample = 0.0;
+    std::atomic<juce::int64> missedBlocks{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginSandbox)
+};
@@ -0,0 +1,177 @@
+#include "PluginSandboxWorker.h"
+#include "SandboxProtocol.h"
+
+namespace
+{
+// How long the processing thread sleeps between checks for a reason to stop
+constexpr int receiveTimeoutMicroseconds = 100000;
+} // namespace
+
+PluginSandboxWorker::PluginSandboxWorker() : juce::Thread("Plugin Sandbox")
+{
+    formatManager.addDefaultFormats();
+}
+
+PluginSandboxWorker::~PluginSandboxWorker()
+{
+    stopThread(1000);
+
+    if (instance != nullptr)
+    {
+        instance->releaseResources();
+    }
+}
+
+void PluginSandboxWorker::handleMessageFromCoordinator(const juce::MemoryBlock& data)
+{
+    // Plugins expect to be created and configured on the message thread
+    auto message = SandboxProtocol::fromMemory(data);
+    juce::MessageManager::callAsync([this, message] { handleMessage(message); });
+}
+
+void PluginSandboxWorker::handleConnectionMade()
+{
+    juce::ValueTree message(SandboxProtocol::ready);
+    message.setProperty(SandboxProtocol::processId, SandboxProtocol::getProcessId(), nullptr);
+    reply(message);
+}
+
+void PluginSandboxWorker::handleConnectionLost()
+{
+    juce::MessageManager::getInstance()->stopDispatchLoop();
+}
+
+void PluginSandboxWorker::handleMessage(const juce::ValueTree& message)
+{
+    if (message.hasType(SandboxProtocol::load))
+    {
+        load(message);
+    }
+    else if (instance == nullptr)
+    {
+        replyWithError("No plugin loaded");
+    }
+    else if (message.hasType(SandboxProtocol::setState))
+    {
+        auto state = SandboxProtocol::decodeState(message[SandboxProtocol::state].toString());
+        const juce::ScopedLock sl(instance->getCallbackLock());
+        instance->setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+    }
+    else if (message.hasType(SandboxProtocol::getState))
+    {
+        juce::MemoryBlock state;
+        instance->getStateInformation(state);
+
+        juce::ValueTree response(SandboxProtocol::state);
+        response.setProperty(SandboxProtocol::state, SandboxProtocol::encodeState(state), nullptr);
+        reply(response);
+    }
+}
+
+void PluginSandboxWorker::load(const juce::ValueTree& message)
+{
+    if (instance != nullptr)
+    {
+        replyWithError("A plugin is already loaded");
+        return;
+    }
+
+    juce::PluginDescription description;
+    auto xml = juce::parseXML(message[SandboxProtocol::plugin].toString());
+
+    if (xml == nullptr || !description.loadFromXml(*xml))
+    {
+        replyWithError("Invalid plugin description");
+        return;
+    }
+
+    channel = SandboxChannel::open(message[SandboxProtocol::channel].toString());
+
+    if (channel == nullptr)
+    {
+        replyWithError("Couldn't open the audio channel");
+        return;
+    }
+
+    auto sampleRate = static_cast<double>(message[SandboxProtocol::sampleRate]);
+    auto blockSize = juce::jmin(static_cast<int>(message[SandboxProtocol::blockSize]),
+                                channel->getMaxBlockSize());
+    juce::String error;
+
+    instance = formatManager.createPluginInstance(description, sampleRate, blockSize, error);
+
+    if (instance == nullptr)
+    {
+        replyWithError(description.name + ": " + error);
+        return;
+    }
+
+    instance->enableAllBuses();
+    instance->prepareToPlay(sampleRate, blockSize);
+
+    if (message.hasProperty(SandboxProtocol::state))
+    {
+        auto state = SandboxProtocol::decodeState(message[SandboxProtocol::state].toString());
+        instance->setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+    }
+
+    // Sidechains and extra outputs get silence in and are dropped on the way out
+    auto numChannels = juce::jmax(channel->getNumChannels(), instance->getTotalNumInputChannels(),
+                                  instance->getTotalNumOutputChannels());
+    buffer.setSize(numChannels, channel->getMaxBlockSize());
+    midi.ensureSize(SandboxChannel::maxMidiEvents * 8);
+
+    channel->discardPendingBlocks();
+
+    if (!startRealtimeThread(juce::Thread::RealtimeOptions().withPriority(9)))
+    {
+        // Real-time scheduling usually needs extra privileges on Linux
+        startThread(juce::Thread::Priority::highest);
+    }
+
+    juce::ValueTree response(SandboxProtocol::loaded);
+    response.setProperty(SandboxProtocol::latency, instance->getLatencySamples(), nullptr);
+    reply(response);
+}
+
+void PluginSandboxWorker::reply(const juce::ValueTree& message)
+{
+    sendMessageToCoordinator(SandboxProtocol::toMemory(message));
+}
+
+void PluginSandboxWorker::replyWithError(const juce::String& error)
+{
+    juce::ValueTree response(SandboxProtocol::error);
+    response.setProperty(SandboxProtocol::message, error, nullptr);
+    reply(response);
+}
+
+void PluginSandboxWorker::run()
+{
+    auto numTransportChannels = channel->getNumChannels();
+
+    while (!threadShouldExit())
+    {
+        juce::uint32 sequence = 0;
+        int numSamples = 0;
+
+        if (!channel->receiveBlock(sequence, buffer, numSamples, midi, receiveTimeoutMicroseconds))
+        {
+            continue;
+        }
+
+        for (int ch = numTransportChannels; ch < buffer.getNumChannels(); ++ch)
+        {
+            buffer.clear(ch, 0, numSamples);
+        }
+
+        {
+            juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(),
+                                           buffer.getNumChannels(), numSamples);
+            const juce::ScopedLock sl(instance->getCallbackLock());
+            instance->processBlock(block, midi);
+        }
+
+        channel->sendReply(sequence, buffer, numSamples);
+    }
+}
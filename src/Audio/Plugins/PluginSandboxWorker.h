@@ -0,0 +1,44 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SandboxChannel.h"
+
+#include <memory>
+
+/**
+ * PluginSandboxWorker is the sandbox process's half of a PluginSandbox.
+ *
+ * It loads the plugin the engine asks for on its message thread, then serves
+ * blocks from the SandboxChannel on a real-time thread until the engine goes
+ * away, at which point the process quits. A crash anywhere in here takes down
+ * only this process.
+ */
+class PluginSandboxWorker : public juce::ChildProcessWorker, private juce::Thread
+{
+public:
+    PluginSandboxWorker();
+    ~PluginSandboxWorker() override;
+
+    void handleMessageFromCoordinator(const juce::MemoryBlock& message) override;
+    void handleConnectionMade() override;
+    void handleConnectionLost() override;
+
+private:
+    // Message thread
+    void handleMessage(const juce::ValueTree& message);
+    void load(const juce::ValueTree& message);
+    void reply(const juce::ValueTree& message);
+    void replyWithError(const juce::String& error);
+
+    // Processing thread
+    void run() override;
+
+    juce::AudioPluginFormatManager formatManager;
+    std::unique_ptr<juce::AudioPluginInstance> instance;
+    std::unique_ptr<SandboxChannel> channel;
+
+    juce::AudioBuffer<float> buffer;
+    juce::MidiBuffer midi;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginSandboxWorker)
+};
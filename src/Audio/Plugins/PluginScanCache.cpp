@@ -0,0 +1,209 @@
+#include "PluginScanCache.h"
+
+namespace
+{
+const juce::Identifier cacheTag{"PLUGINCACHE"};
+const juce::Identifier entryTag{"BINARY"};
+const juce::Identifier versionAttribute{"version"};
+const juce::Identifier identifierAttribute{"identifier"};
+const juce::Identifier sizeAttribute{"size"};
+const juce::Identifier modifiedAttribute{"modified"};
+const juce::Identifier blacklistedAttribute{"blacklisted"};
+} // namespace
+
+PluginScanCache::PluginScanCache(const juce::File& cacheFile) : file(cacheFile)
+{
+}
+
+juce::File PluginScanCache::getDefaultFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("DAIW")
+        .getChildFile("PluginCache.xml");
+}
+
+void PluginScanCache::load()
+{
+    std::map<juce::String, Entry> loaded;
+    auto xml = juce::parseXMLIfTagMatches(file, cacheTag.toString());
+
+    if (xml != nullptr && xml->getIntAttribute(versionAttribute) == formatVersion)
+    {
+        for (auto* element : xml->getChildWithTagNameIterator(entryTag.toString()))
+        {
+            Entry entry;
+            entry.fingerprint.size = element->getStringAttribute(sizeAttribute).getLargeIntValue();
+            entry.fingerprint.modified =
+                element->getStringAttribute(modifiedAttribute).getLargeIntValue();
+            entry.blacklisted = element->getBoolAttribute(blacklistedAttribute);
+
+            for (auto* type : element->getChildIterator())
+            {
+                juce::PluginDescription description;
+
+                if (description.loadFromXml(*type))
+                {
+                    entry.types.add(description);
+                }
+            }
+
+            loaded[element->getStringAttribute(identifierAttribute)] = std::move(entry);
+        }
+    }
+
+    const juce::ScopedLock sl(lock);
+    entries = std::move(loaded);
+}
+
+bool PluginScanCache::save() const
+{
+    juce::XmlElement xml(cacheTag);
+    xml.setAttribute(versionAttribute, formatVersion);
+
+    {
+        const juce::ScopedLock sl(lock);
+
+        for (const auto& [identifier, entry] : entries)
+        {
+            auto* element = xml.createNewChildElement(entryTag);
+            element->setAttribute(identifierAttribute, identifier);
+            element->setAttribute(sizeAttribute, juce::String(entry.fingerprint.size));
+            element->setAttribute(modifiedAttribute, juce::String(entry.fingerprint.modified));
+
+            if (entry.blacklisted)
+            {
+                element->setAttribute(blacklistedAttribute, true);
+            }
+
+            for (const auto& type : entry.types)
+            {
+                element->addChildElement(type.createXml().release());
+            }
+        }
+    }
+
+    file.getParentDirectory().createDirectory();
+    return xml.writeTo(file);
+}
+
+bool PluginScanCache::getCached(const juce::String& identifier,
+                                juce::Array<juce::PluginDescription>& results) const
+{
+    const juce::ScopedLock sl(lock);
+    auto* entry = findCurrent(identifier);
+
+    if (entry == nullptr || entry->blacklisted)
+    {
+        return false;
+    }
+
+    results.addArray(entry->types);
+    return true;
+}
+
+void PluginScanCache::store(const juce::String& identifier,
+                            const juce::Array<juce::PluginDescription>& types)
+{
+    Entry entry;
+    entry.fingerprint = getFingerprint(identifier);
+    entry.types = types;
+
+    const juce::ScopedLock sl(lock);
+    entries[identifier] = std::move(entry);
+}
+
+bool PluginScanCache::isBlacklisted(const juce::String& identifier) const
+{
+    const juce::ScopedLock sl(lock);
+    auto* entry = findCurrent(identifier);
+    return entry != nullptr && entry->blacklisted;
+}
+
+void PluginScanCache::blacklist(const juce::String& identifier)
+{
+    Entry entry;
+    entry.fingerprint = getFingerprint(identifier);
+    entry.blacklisted = true;
+
+    const juce::ScopedLock sl(lock);
+    entries[identifier] = std::move(entry);
+}
+
+juce::StringArray PluginScanCache::getBlacklist() const
+{
+    juce::StringArray identifiers;
+    const juce::ScopedLock sl(lock);
+
+    for (const auto& [identifier, entry] : entries)
+    {
+        if (entry.blacklisted)
+        {
+            identifiers.add(identifier);
+        }
+    }
+
+    return identifiers;
+}
+
+void PluginScanCache::clearBlacklist()
+{
+    const juce::ScopedLock sl(lock);
+
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        it = it->second.blacklisted ? entries.erase(it) : std::next(it);
+    }
+}
+
+void PluginScanCache::retainOnly(const juce::StringArray& identifiers)
+{
+    const juce::ScopedLock sl(lock);
+
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        it = identifiers.contains(it->first) ? std::next(it) : entries.erase(it);
+    }
+}
+
+PluginScanCache::Fingerprint PluginScanCache::getFingerprint(const juce::String& identifier)
+{
+    Fingerprint fingerprint;
+
+    if (!juce::File::isAbsolutePath(identifier))
+    {
+        return fingerprint;
+    }
+
+    juce::File binary(identifier);
+
+    if (binary.isDirectory())
+    {
+        // A bundle: any file in it changing changes the fingerprint
+        for (const auto& entry : juce::RangedDirectoryIterator(binary, true, "*",
+                                                               juce::File::findFiles))
+        {
+            fingerprint.size += entry.getFileSize();
+            fingerprint.modified = juce::jmax(fingerprint.modified,
+                                              entry.getModificationTime().toMilliseconds());
+        }
+    }
+    else
+    {
+        fingerprint.size = binary.getSize();
+        fingerprint.modified = binary.getLastModificationTime().toMilliseconds();
+    }
+
+    return fingerprint;
+}
+
+const PluginScanCache::Entry* PluginScanCache::findCurrent(const juce::String& identifier) const
+{
+    auto it = entries.find(identifier);
+
+    if (it == entries.end() || !(it->second.fingerprint == getFingerprint(identifier)))
+    {
+        return nullptr;
+    }
+
+    return &it->second;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <map>
+
+/**
+ * PluginScanCache remembers what scanning each plugin binary found, so a
+ * launch only rescans binaries that are new or have changed.
+ *
+ * Entries are keyed by the format's plugin identifier (the binary's path for
+ * VST3) and record the binary's size and modification time when it was
+ * scanned; a binary that no longer matches reads as uncached. A bundle's size
+ * and time are taken over the files inside it. Identifiers that aren't files
+ * (Audio Units) are cached until the entry is removed.
+ *
+ * A binary that crashed or hung its scanner is blacklisted the same way: it
+ * is skipped until it changes, or until the blacklist is cleared.
+ *
+ * All methods are thread safe.
+ */
+class PluginScanCache
+{
+public:
+    explicit PluginScanCache(const juce::File& file);
+
+    // In the user's application data folder
+    static juce::File getDefaultFile();
+
+    const juce::File& getFile() const { return file; }
+
+    // Replaces the contents with the file's; an unreadable file leaves the cache empty
+    void load();
+    bool save() const;
+
+    // False when the binary was never scanned, was blacklisted, or has changed since
+    bool getCached(const juce::String& identifier,
+                   juce::Array<juce::PluginDescription>& results) const;
+    void store(const juce::String& identifier, const juce::Array<juce::PluginDescription>& types);
+
+    bool isBlacklisted(const juce::String& identifier) const;
+    void blacklist(const juce::String& identifier);
+    juce::StringArray getBlacklist() const;
+    void clearBlacklist();
+
+    // Forgets binaries that are no longer installed
+    void retainOnly(const juce::StringArray& identifiers);
+
+    static constexpr int formatVersion = 1;
+
+private:
+    struct Fingerprint
+    {
+        juce::int64 size = 0;
+        juce::int64 modified = 0; // Milliseconds since 1970
+
+        bool operator==(const Fingerprint& other) const
+        {
+            return size == other.size && modified == other.modified;
+        }
+    };
+
+    struct Entry
+    {
+        Fingerprint fingerprint;
+        bool blacklisted = false;
+        juce::Array<juce::PluginDescription> types;
+    };
+
+    static Fingerprint getFingerprint(const juce::String& identifier);
+
+    // Caller holds the lock: the entry if it still describes the binary as it is now
+    const Entry* findCurrent(const juce::String& identifier) const;
+
+    const juce::File file;
+    juce::CriticalSection lock;
+    std::map<juce::String, Entry> entries;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginScanCache)
+};
@@ -0,0 +1,62 @@
+#include "PluginScanWorker.h"
+#include "SandboxProtocol.h"
+
+PluginScanWorker::PluginScanWorker()
+{
+    formatManager.addDefaultFormats();
+}
+
+void PluginScanWorker::handleMessageFromCoordinator(const juce::MemoryBlock& data)
+{
+    // Some formats only instantiate plugins on the message thread
+    auto message = SandboxProtocol::fromMemory(data);
+
+    if (message.hasType(SandboxProtocol::scan))
+    {
+        juce::MessageManager::callAsync([this, message] { scan(message); });
+    }
+}
+
+void PluginScanWorker::handleConnectionMade()
+{
+    juce::ValueTree message(SandboxProtocol::ready);
+    message.setProperty(SandboxProtocol::processId, SandboxProtocol::getProcessId(), nullptr);
+    reply(message);
+}
+
+void PluginScanWorker::handleConnectionLost()
+{
+    juce::MessageManager::getInstance()->stopDispatchLoop();
+}
+
+void PluginScanWorker::scan(const juce::ValueTree& message)
+{
+    juce::ValueTree response(SandboxProtocol::scanned);
+    auto formatName = message[SandboxProtocol::format].toString();
+
+    for (auto* format : formatManager.getFormats())
+    {
+        if (format->getName() != formatName)
+        {
+            continue;
+        }
+
+        juce::OwnedArray<juce::PluginDescription> found;
+        format->findAllTypesForFile(found, message[SandboxProtocol::identifier].toString());
+
+        for (auto* description : found)
+        {
+            if (auto xml = description->createXml())
+            {
+                response.appendChild(juce::ValueTree::fromXml(*xml), nullptr);
+            }
+        }
+    }
+
+    reply(response);
+}
+
+void PluginScanWorker::reply(const juce::ValueTree& message)
+{
+    sendMessageToCoordinator(SandboxProtocol::toMemory(message));
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * PluginScanWorker is a scanner process's half of a PluginScanner: it scans
+ * the binaries the engine sends it, one at a time, and reports what it found.
+ * A plugin that crashes while being scanned takes only this process with it.
+ */
+class PluginScanWorker : public juce::ChildProcessWorker
+{
+public:
+    PluginScanWorker();
+
+    void handleMessageFromCoordinator(const juce::MemoryBlock& message) override;
+    void handleConnectionMade() override;
+    void handleConnectionLost() override;
+
+private:
+    // Message thread
+    void scan(const juce::ValueTree& message);
+    void reply(const juce::ValueTree& message);
+
+    juce::AudioPluginFormatManager formatManager;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginScanWorker)
+};
@@ -0,0 +1,301 @@
+#include "PluginScanner.h"
+#include "SandboxProtocol.h"
+
+/** One scanner process and the binary it is working on. */
+class PluginScanner::ScannerProcess : private juce::ChildProcessCoordinator
+{
+public:
+    explicit ScannerProcess(juce::WaitableEvent& resultEvent) : wake(resultEvent) {}
+    ~ScannerProcess() override { stop(); }
+
+    bool isRunning() const { return launched && !crashed.load(); }
+    bool isBusy() const { return busy; }
+    const Job& getJob() const { return job; }
+
+    bool start(const juce::File& executable)
+    {
+        stop();
+        crashed = false;
+        launched = launchWorkerProcess(executable, SandboxProtocol::scannerCommandLineId,
+                                       processPingTimeoutMs, 0);
+        return launched;
+    }
+
+    void stop()
+    {
+        stopping = true;
+        killWorkerProcess();
+        SandboxProtocol::killProcess(processId.exchange(0));
+        stopping = false;
+        launched = false;
+        busy = false;
+    }
+
+    bool scan(const Job& newJob)
+    {
+        job = newJob;
+        finished = false;
+        busy = true;
+        deadline = juce::Time::getMillisecondCounterHiRes() + scanTimeoutMs;
+
+        juce::ValueTree message(SandboxProtocol::scan);
+        message.setProperty(SandboxProtocol::format, job.formatName, nullptr);
+        message.setProperty(SandboxProtocol::identifier, job.identifier, nullptr);
+        return sendMessageToWorker(SandboxProtocol::toMemory(message));
+    }
+
+    // The plugins found, once the scan has finished
+    bool getResults(juce::Array<juce::PluginDescription>& types)
+    {
+        if (!finished.load())
+        {
+            return false;
+        }
+
+        const juce::ScopedLock sl(lock);
+
+        for (const auto& child : reply)
+        {
+            juce::PluginDescription description;
+
+            if (auto xml = child.createXml(); xml != nullptr && description.loadFromXml(*xml))
+            {
+                types.add(description);
+            }
+        }
+
+        busy = false;
+        return true;
+    }
+
+    bool hasFailed() const
+    {
+        return crashed.load() || juce::Time::getMillisecondCounterHiRes() > deadline;
+    }
+
+private:
+    void handleMessageFromWorker(const juce::MemoryBlock& data) override
+    {
+        auto message = SandboxProtocol::fromMemory(data);
+
+        if (message.hasType(SandboxProtocol::ready))
+        {
+            processId = static_cast<int>(message[SandboxProtocol::processId]);
+        }
+        else if (message.hasType(SandboxProtocol::scanned))
+        {
+            {
+                const juce::ScopedLock sl(lock);
+                reply = message;
+            }
+
+            finished = true;
+            wake.signal();
+        }
+    }
+
+    void handleConnectionLost() override
+    {
+        if (!stopping.load())
+        {
+            crashed = true;
+            wake.signal();
+        }
+    }
+
+    juce::WaitableEvent& wake;
+
+    // Scan thread
+    Job job;
+    bool launched = false;
+    bool busy = false;
+    double deadline = 0.0;
+
+    // Set from the pipe thread
+    std::atomic<bool> finished{false};
+    std::atomic<bool> crashed{false};
+    std::atomic<bool> stopping{false};
+    std::atomic<int> processId{0};
+    juce::CriticalSection lock;
+    juce::ValueTree reply;
+};
+
+PluginScanner::PluginScanner(juce::AudioPluginFormatManager& formats,
+                             juce::KnownPluginList& known, const juce::File& scannerExecutable,
+                             const juce::File& cacheFile)
+    : juce::Thread("Plugin Scanner"),
+      formatManager(formats),
+      knownPlugins(known),
+      executable(scannerExecutable),
+      cache(cacheFile)
+{
+}
+
+PluginScanner::~PluginScanner()
+{
+    stopScan();
+    cancelPendingUpdate();
+}
+
+int PluginScanner::getDefaultNumProcesses()
+{
+    // Scanning is mostly waiting on disk and plugin initialisation, not computing
+    return juce::jlimit(2, 8, juce::SystemStats::getNumCpus());
+}
+
+void PluginScanner::startScan(int processes)
+{
+    if (isThreadRunning())
+    {
+        return;
+    }
+
+    numProcesses = juce::jmax(1, processes);
+    progress = 0.0f;
+    startThread(juce::Thread::Priority::low);
+}
+
+void PluginScanner::stopScan()
+{
+    stopThread(scanTimeoutMs);
+}
+
+void PluginScanner::run()
+{
+    cache.load();
+
+    juce::StringArray installed;
+    auto jobs = findUncachedBinaries(installed);
+
+    juce::WaitableEvent wake;
+    juce::OwnedArray<ScannerProcess> processes;
+
+    for (int i = 0; i < juce::jmin(numProcesses, jobs.size()); ++i)
+    {
+        processes.add(new ScannerProcess(wake));
+    }
+
+    int nextJob = 0;
+    int numDone = 0;
+    bool canLaunch = true;
+
+    while (!threadShouldExit())
+    {
+        bool anyBusy = false;
+
+        for (auto* process : processes)
+        {
+            if (process->isBusy())
+            {
+                juce::Array<juce::PluginDescription> types;
+
+                if (process->getResults(types))
+                {
+                    cache.store(process->getJob().identifier, types);
+                    addResults(types);
+                    ++numDone;
+                }
+                else if (process->hasFailed())
+                {
+                    // Crashed or hung on this binary: never again, until it changes
+                    DBG("Blacklisting " << process->getJob().identifier);
+                    cache.blacklist(process->getJob().identifier);
+                    knownPlugins.addToBlacklist(process->getJob().identifier);
+                    cache.save();
+                    process->stop();
+                    ++numDone;
+                }
+            }
+
+            if (!process->isBusy() && nextJob < jobs.size() && canLaunch)
+            {
+                if (!process->isRunning() && !process->start(executable))
+                {
+                    DBG("Couldn't start the plugin scanner " << executable.getFullPathName());
+                    canLaunch = false;
+                }
+                else if (!process->scan(jobs.getReference(nextJob++)))
+                {
+                    // Lost before it could start; it is retried on the next launch
+                    process->stop();
+                    ++numDone;
+                }
+            }
+
+            anyBusy = anyBusy || process->isBusy();
+        }
+
+        if (jobs.size() > 0)
+        {
+            progress = static_cast<float>(numDone) / static_cast<float>(jobs.size());
+        }
+
+        if (!anyBusy && (nextJob >= jobs.size() || !canLaunch))
+        {
+            break;
+        }
+
+        wake.wait(100);
+    }
+
+    processes.clear();
+
+    if (!threadShouldExit() && canLaunch)
+    {
+        cache.retainOnly(installed);
+    }
+
+    cache.save();
+    progress = 1.0f;
+    triggerAsyncUpdate();
+}
+
+juce::Array<PluginScanner::Job> PluginScanner::findUncachedBinaries(juce::StringArray& installed)
+{
+    juce::Array<Job> jobs;
+
+    for (auto* format : formatManager.getFormats())
+    {
+        auto identifiers =
+            format->searchPathsForPlugins(format->getDefaultLocationsToSearch(), true, false);
+
+        for (const auto& identifier : identifiers)
+        {
+            if (threadShouldExit())
+            {
+                return {};
+            }
+
+            installed.add(identifier);
+            juce::Array<juce::PluginDescription> types;
+
+            if (cache.getCached(identifier, types))
+            {
+                addResults(types);
+            }
+            else if (cache.isBlacklisted(identifier))
+            {
+                knownPlugins.addToBlacklist(identifier);
+            }
+            else
+            {
+                jobs.add({format->getName(), identifier});
+            }
+        }
+    }
+
+    return jobs;
+}
+
+void PluginScanner::addResults(const juce::Array<juce::PluginDescription>& types)
+{
+    for (const auto& type : types)
+    {
+        knownPlugins.addType(type);
+    }
+}
+
+void PluginScanner::handleAsyncUpdate()
+{
+    listeners.call([](Listener& listener) { listener.pluginScanFinished(); });
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginScanCache.h"
+
+#include <atomic>
+
+/**
+ * PluginScanner fills a KnownPluginList from every format's default search
+ * paths.
+ *
+ * Binaries the PluginScanCache already knows are added straight from it.
+ * The rest are handed out to a pool of DAIW_PluginSandbox processes in
+ * scanner mode, several at once, so one slow plugin doesn't hold up the
+ * others and a plugin that crashes its scanner (or takes longer than
+ * scanTimeoutMs) costs only that process: the binary is blacklisted, the
+ * process replaced, and the scan carries on.
+ *
+ * Scans run on a background thread; the list broadcasts its own changes as
+ * plugins are found, and listeners hear about the end on the message thread.
+ */
+class PluginScanner : private juce::Thread, private juce::AsyncUpdater
+{
+public:
+    class Listener
+    {
+    public:
+        virtual ~Listener() = default;
+        virtual void pluginScanFinished() = 0;
+    };
+
+    PluginScanner(juce::AudioPluginFormatManager& formatManager,
+                  juce::KnownPluginList& knownPlugins, const juce::File& scannerExecutable,
+                  const juce::File& cacheFile = PluginScanCache::getDefaultFile());
+    ~PluginScanner() override;
+
+    void addListener(Listener* listener) { listeners.add(listener); }
+    void removeListener(Listener* listener) { listeners.remove(listener); }
+
+    // Message thread. No effect while a scan is running.
+    void startScan(int numProcesses = getDefaultNumProcesses());
+    void stopScan();
+
+    bool isScanning() const { return isThreadRunning(); }
+    float getProgress() const { return progress.load(); }
+
+    PluginScanCache& getCache() { return cache; }
+
+    // Message thread, between scans
+    void setExecutable(const juce::File& scannerExecutable) { executable = scannerExecutable; }
+
+    static int getDefaultNumProcesses();
+
+    static constexpr int scanTimeoutMs = 30000;
+    static constexpr int processPingTimeoutMs = 5000;
+
+private:
+    class ScannerProcess;
+
+    struct Job
+    {
+        juce::String formatName;
+        juce::String identifier;
+    };
+
+    void run() override;
+    void handleAsyncUpdate() override;
+
+    // Adds cached plugins to the list and returns the binaries still to scan
+    juce::Array<Job> findUncachedBinaries(juce::StringArray& installed);
+    void addResults(const juce::Array<juce::PluginDescription>& types);
+
+    juce::AudioPluginFormatManager& formatManager;
+    juce::KnownPluginList& knownPlugins;
+    juce::File executable;
+    PluginScanCache cache;
+
+    int numProcesses = 1;
+    std::atomic<float> progress{0.0f};
+    juce::ListenerList<Listener> listeners;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginScanner)
+};
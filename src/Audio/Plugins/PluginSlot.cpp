@@ -0,0 +1,126 @@
+#include "PluginSlot.h"
+
+PluginSlot::PluginSlot(std::unique_ptr<juce::AudioPluginInstance> pluginInstance, int channels)
+    : description(pluginInstance->getPluginDescription()),
+      instance(std::move(pluginInstance)),
+      numChannels(channels)
+{
+}
+
+PluginSlot::PluginSlot(std::unique_ptr<PluginSandbox> pluginSandbox)
+    : description(pluginSandbox->getDescription()),
+      sandbox(std::move(pluginSandbox)),
+      numChannels(0)
+{
+}
+
+PluginSlot::~PluginSlot()
+{
+    releaseResources();
+}
+
+juce::Result PluginSlot::prepareToPlay(double sampleRate, int maximumBlockSize)
+{
+    if (sandbox != nullptr)
+    {
+        return sandbox->prepare(sampleRate, maximumBlockSize);
+    }
+
+    instance->enableAllBuses();
+    instance->prepareToPlay(sampleRate, maximumBlockSize);
+
+    auto pluginChannels = juce::jmax(instance->getTotalNumInputChannels(),
+                                     instance->getTotalNumOutputChannels());
+    scratch.setSize(juce::jmax(numChannels, pluginChannels), maximumBlockSize);
+    return juce::Result::ok();
+}
+
+void PluginSlot::releaseResources()
+{
+    if (sandbox != nullptr)
+    {
+        sandbox->release();
+    }
+    else
+    {
+        instance->releaseResources();
+    }
+}
+
+void PluginSlot::process(juce::AudioBuffer<float>& buffer, int numSamples,
+                         juce::MidiBuffer& midi) noexcept
+{
+    if (bypassed.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    if (sandbox != nullptr)
+    {
+        // A miss or a dead sandbox leaves the block dry
+        sandbox->process(buffer, numSamples, midi);
+        return;
+    }
+
+    auto pluginChannels = juce::jmax(instance->getTotalNumInputChannels(),
+                                     instance->getTotalNumOutputChannels());
+
+    if (pluginChannels <= buffer.getNumChannels())
+    {
+        juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), pluginChannels,
+                                       numSamples);
+        instance->processBlock(block, midi);
+        return;
+    }
+
+    auto trackChannels = buffer.getNumChannels();
+
+    for (int ch = 0; ch < scratch.getNumChannels(); ++ch)
+    {
+        if (ch < trackChannels)
+        {
+            scratch.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+        }
+        else
+        {
+            scratch.clear(ch, 0, numSamples);
+        }
+    }
+
+    juce::AudioBuffer<float> block(scratch.getArrayOfWritePointers(), pluginChannels, numSamples);
+    instance->processBlock(block, midi);
+
+    for (int ch = 0; ch < trackChannels; ++ch)
+    {
+        buffer.copyFrom(ch, 0, scratch, ch, 0, numSamples);
+    }
+}
+
+int PluginSlot::getLatencySamples() const
+{
+    return sandbox != nullptr ? sandbox->getLatencySamples() : instance->getLatencySamples();
+}
+
+juce::MemoryBlock PluginSlot::getState()
+{
+    if (sandbox != nullptr)
+    {
+        return sandbox->getState();
+    }
+
+    juce::MemoryBlock state;
+    instance->getStateInformation(state);
+    return state;
+}
+
+void PluginSlot::setState(const juce::MemoryBlock& state)
+{
+    if (sandbox != nullptr)
+    {
+        sandbox->setState(state);
+    }
+    else
+    {
+        instance->setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+    }
+}
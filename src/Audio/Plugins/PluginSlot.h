@@ -0,0 +1,58 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginSandbox.h"
+
+#include <atomic>
+#include <memory>
+
+/**
+ * PluginSlot is one plugin in a track's insert chain, hosted either in the
+ * engine's own process or in a PluginSandbox. Callers don't need to know
+ * which: a slot whose sandbox is down, or which is bypassed, passes audio
+ * through untouched.
+ */
+class PluginSlot
+{
+public:
+    PluginSlot(std::unique_ptr<juce::AudioPluginInstance> instance, int numChannels);
+    explicit PluginSlot(std::unique_ptr<PluginSandbox> sandbox);
+    ~PluginSlot();
+
+    const juce::PluginDescription& getDescription() const { return description; }
+    bool isSandboxed() const { return sandbox != nullptr; }
+
+    // False while a sandboxed plugin is down (crashed or restarting)
+    bool isRunning() const { return sandbox == nullptr || sandbox->isRunning(); }
+
+    // Message thread. An in-process plugin must not be processing: take the slot out of the
+    // graph (or stop the audio) first. A sandboxed one waits out a block in flight itself.
+    juce::Result prepareToPlay(double sampleRate, int maximumBlockSize);
+    void releaseResources();
+
+    // Real-time: processes numSamples in place
+    void process(juce::AudioBuffer<float>& buffer, int numSamples,
+                 juce::MidiBuffer& midi) noexcept;
+
+    // Any thread
+    void setBypassed(bool shouldBeBypassed) { bypassed = shouldBeBypassed; }
+    bool isBypassed() const { return bypassed.load(); }
+    int getLatencySamples() const;
+
+    // Message thread
+    juce::MemoryBlock getState();
+    void setState(const juce::MemoryBlock& state);
+
+private:
+    const juce::PluginDescription description;
+    std::unique_ptr<juce::AudioPluginInstance> instance;
+    std::unique_ptr<PluginSandbox> sandbox;
+    const int numChannels;
+
+    std::atomic<bool> bypassed{false};
+
+    // For in-process plugins with more channels (sidechains, extra outputs) than the track
+    juce::AudioBuffer<float> scratch;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginSlot)
+};
@@ -0,0 +1,350 @@
+#include "SandboxChannel.h"
+
+#include <cstring>
+
+namespace
+{
+constexpr char channelMagic[8] = {'D', 'A', 'I', 'W', 'S', 'B', 'O', 'X'};
+constexpr juce::uint32 channelVersion = 1;
+constexpr size_t cacheLine = 64;
+
+size_t alignToCacheLine(size_t size)
+{
+    return (size + cacheLine - 1) & ~(cacheLine - 1);
+}
+} // namespace
+
+// Everything below lives in the shared block: plain data and lock-free atomics only
+struct SandboxChannel::Header
+{
+    char magic[8];
+    juce::uint32 version;
+    juce::int32 numChannels;
+    juce::int32 maxBlockSize;
+};
+
+struct SandboxChannel::RingState
+{
+    alignas(64) std::atomic<juce::uint32> written; // Also the word readers sleep on
+    alignas(64) std::atomic<juce::uint32> read;
+};
+
+struct SandboxChannel::SlotHeader
+{
+    juce::uint32 sequence;
+    juce::int32 numSamples;
+    juce::int32 numMidiEvents;
+    juce::int32 reserved;
+};
+
+struct SandboxChannel::MidiEvent
+{
+    juce::int32 samplePosition;
+    juce::uint8 size;
+    juce::uint8 bytes[3];
+};
+
+//==============================================================================
+SandboxChannel::Ring::Ring(RingState* ringState, char* ringSlots, size_t sizeOfSlot)
+    : state(ringState), slots(ringSlots), slotSize(sizeOfSlot)
+{
+}
+
+SandboxChannel::SlotHeader* SandboxChannel::Ring::beginWrite() noexcept
+{
+    auto written = state->written.load(std::memory_order_relaxed);
+
+    if (written - state->read.load(std::memory_order_acquire) >= numSlots)
+    {
+        return nullptr;
+    }
+
+    return reinterpret_cast<SlotHeader*>(slots + (written % numSlots) * slotSize);
+}
+
+void SandboxChannel::Ring::publish() noexcept
+{
+    state->written.fetch_add(1, std::memory_order_release);
+    SharedMemory::wake(state->written);
+}
+
+SandboxChannel::SlotHeader* SandboxChannel::Ring::beginRead(juce::int64 deadlineTicks) noexcept
+{
+    for (;;)
+    {
+        auto written = state->written.load(std::memory_order_acquire);
+        auto read = state->read.load(std::memory_order_relaxed);
+
+        if (written != read)
+        {
+            return reinterpret_cast<SlotHeader*>(slots + (read % numSlots) * slotSize);
+        }
+
+        auto remaining = deadlineTicks - juce::Time::getHighResolutionTicks();
+
+        if (remaining <= 0)
+        {
+            return nullptr;
+        }
+
+        auto micros = juce::Time::highResolutionTicksToSeconds(remaining) * 1.0e6;
+        SharedMemory::wait(state->written, written, juce::jmax(1, static_cast<int>(micros)));
+    }
+}
+
+void SandboxChannel::Ring::release() noexcept
+{
+    state->read.fetch_add(1, std::memory_order_release);
+}
+
+void SandboxChannel::Ring::discardAll() noexcept
+{
+    state->read.store(state->written.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+//==============================================================================
+size_t SandboxChannel::getSlotSize(int channels, int blockSize)
+{
+    return alignToCacheLine(sizeof(SlotHeader) +
+                            static_cast<size_t>(channels * blockSize) * sizeof(float) +
+                            maxMidiEvents * sizeof(MidiEvent));
+}
+
+size_t SandboxChannel::getTotalSize(int channels, int blockSize)
+{
+    return alignToCacheLine(sizeof(Header)) + 2 * sizeof(RingState) +
+           2 * numSlots * getSlotSize(channels, blockSize);
+}
+
+SandboxChannel::SandboxChannel(std::unique_ptr<SharedMemory> block, int channels, int blockSize)
+    : memory(std::move(block)), numChannels(channels), maxBlockSize(blockSize)
+{
+    auto* base = static_cast<char*>(memory->getData());
+    auto* states = reinterpret_cast<RingState*>(base + alignToCacheLine(sizeof(Header)));
+    auto* slots = reinterpret_cast<char*>(states + 2);
+    auto slotSize = getSlotSize(numChannels, maxBlockSize);
+
+    toSandbox = Ring(states, slots, slotSize);
+    toEngine = Ring(states + 1, slots + numSlots * slotSize, slotSize);
+}
+
+std::unique_ptr<SandboxChannel> SandboxChannel::create(int channels, int blockSize)
+{
+    channels = juce::jlimit(1, maxChannels, channels);
+    blockSize = juce::jmax(1, blockSize);
+
+    auto memory = SharedMemory::create(SharedMemory::createUniqueName("daiw-"),
+                                       getTotalSize(channels, blockSize));
+
+    if (memory == nullptr)
+    {
+        return nullptr;
+    }
+
+    // The rings start zeroed (empty); the header tells the sandbox how big everything is
+    auto* header = static_cast<Header*>(memory->getData());
+    std::memcpy(header->magic, channelMagic, sizeof(channelMagic));
+    header->version = channelVersion;
+    header->numChannels = channels;
+    header->maxBlockSize = blockSize;
+
+    return std::unique_ptr<SandboxChannel>(
+        new SandboxChannel(std::move(memory), channels, blockSize));
+}
+
+std::unique_ptr<SandboxChannel> SandboxChannel::open(const juce::String& name)
+{
+    Header header;
+
+    {
+        auto headerOnly = SharedMemory::open(name, sizeof(Header));
+
+        if (headerOnly == nullptr)
+        {
+            return nullptr;
+        }
+
+        std::memcpy(&header, headerOnly->getData(), sizeof(Header));
+    }
+
+    if (std::memcmp(header.magic, channelMagic, sizeof(channelMagic)) != 0 ||
+        header.version != channelVersion || header.numChannels < 1 ||
+        header.numChannels > maxChannels || header.maxBlockSize < 1)
+    {
+        return nullptr;
+    }
+
+    auto memory = SharedMemory::open(name, getTotalSize(header.numChannels, header.maxBlockSize));
+
+    if (memory == nullptr)
+    {
+        return nullptr;
+    }
+
+    return std::unique_ptr<SandboxChannel>(
+        new SandboxChannel(std::move(memory), header.numChannels, header.maxBlockSize));
+}
+
+float* SandboxChannel::getSlotAudio(SlotHeader* slot, int channel) const noexcept
+{
+    auto* audio = reinterpret_cast<float*>(slot + 1);
+    return audio + channel * maxBlockSize;
+}
+
+SandboxChannel::MidiEvent* SandboxChannel::getSlotMidi(SlotHeader* slot) const noexcept
+{
+    return reinterpret_cast<MidiEvent*>(getSlotAudio(slot, numChannels));
+}
+
+//==============================================================================
+bool SandboxChannel::sendBlock(juce::uint32 sequence, const juce::AudioBuffer<float>& audio,
+                               int numSamples, const juce::MidiBuffer& midi) noexcept
+{
+    auto* slot = toSandbox.beginWrite();
+
+    if (slot == nullptr)
+    {
+        return false;
+    }
+
+    numSamples = juce::jmin(numSamples, maxBlockSize);
+    slot->sequence = sequence;
+    slot->numSamples = numSamples;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* destination = getSlotAudio(slot, channel);
+
+        if (channel < audio.getNumChannels())
+        {
+            std::memcpy(destination, audio.getReadPointer(channel),
+                        static_cast<size_t>(numSamples) * sizeof(float));
+        }
+        else
+        {
+            std::memset(destination, 0, static_cast<size_t>(numSamples) * sizeof(float));
+        }
+    }
+
+    auto* events = getSlotMidi(slot);
+    int numEvents = 0;
+
+    for (const auto metadata : midi)
+    {
+        if (numEvents == maxMidiEvents || metadata.samplePosition >= numSamples)
+        {
+            break;
+        }
+
+        if (metadata.numBytes > 3)
+        {
+            continue;
+        }
+
+        auto& event = events[numEvents++];
+        event.samplePosition = metadata.samplePosition;
+        event.size = static_cast<juce::uint8>(metadata.numBytes);
+        std::memcpy(event.bytes, metadata.data, static_cast<size_t>(metadata.numBytes));
+    }
+
+    slot->numMidiEvents = numEvents;
+    toSandbox.publish();
+    return true;
+}
+
+bool SandboxChannel::receiveReply(juce::uint32 sequence, juce::AudioBuffer<float>& audio,
+                                  int numSamples, int timeoutMicroseconds) noexcept
+{
+    auto deadline = juce::Time::getHighResolutionTicks() +
+                    juce::Time::secondsToHighResolutionTicks(timeoutMicroseconds * 1.0e-6);
+
+    while (auto* slot = toEngine.beginRead(deadline))
+    {
+        // Late replies to blocks already given up on
+        if (slot->sequence != sequence)
+        {
+            toEngine.release();
+            continue;
+        }
+
+        auto count = juce::jmin(numSamples, static_cast<int>(slot->numSamples));
+        auto channels = juce::jmin(numChannels, audio.getNumChannels());
+
+        for (int channel = 0; channel < channels; ++channel)
+        {
+            std::memcpy(audio.getWritePointer(channel), getSlotAudio(slot, channel),
+                        static_cast<size_t>(count) * sizeof(float));
+        }
+
+        toEngine.release();
+        return true;
+    }
+
+    return false;
+}
+
+bool SandboxChannel::receiveBlock(juce::uint32& sequence, juce::AudioBuffer<float>& audio,
+                                  int& numSamples, juce::MidiBuffer& midi,
+                                  int timeoutMicroseconds) noexcept
+{
+    auto deadline = juce::Time::getHighResolutionTicks() +
+                    juce::Time::secondsToHighResolutionTicks(timeoutMicroseconds * 1.0e-6);
+    auto* slot = toSandbox.beginRead(deadline);
+
+    if (slot == nullptr)
+    {
+        return false;
+    }
+
+    sequence = slot->sequence;
+    numSamples = juce::jlimit(0, maxBlockSize, static_cast<int>(slot->numSamples));
+
+    for (int channel = 0; channel < juce::jmin(numChannels, audio.getNumChannels()); ++channel)
+    {
+        std::memcpy(audio.getWritePointer(channel), getSlotAudio(slot, channel),
+                    static_cast<size_t>(numSamples) * sizeof(float));
+    }
+
+    midi.clear();
+    auto* events = getSlotMidi(slot);
+    auto numEvents = juce::jlimit(0, maxMidiEvents, static_cast<int>(slot->numMidiEvents));
+
+    for (int i = 0; i < numEvents; ++i)
+    {
+        midi.addEvent(events[i].bytes, juce::jlimit(1, 3, static_cast<int>(events[i].size)),
+                      events[i].samplePosition);
+    }
+
+    toSandbox.release();
+    return true;
+}
+
+bool SandboxChannel::sendReply(juce::uint32 sequence, const juce::AudioBuffer<float>& audio,
+                               int numSamples) noexcept
+{
+    auto* slot = toEngine.beginWrite();
+
+    if (slot == nullptr)
+    {
+        return false;
+    }
+
+    numSamples = juce::jmin(numSamples, maxBlockSize);
+    slot->sequence = sequence;
+    slot->numSamples = numSamples;
+    slot->numMidiEvents = 0;
+
+    for (int channel = 0; channel < juce::jmin(numChannels, audio.getNumChannels()); ++channel)
+    {
+        std::memcpy(getSlotAudio(slot, channel), audio.getReadPointer(channel),
+                    static_cast<size_t>(numSamples) * sizeof(float));
+    }
+
+    toEngine.publish();
+    return true;
+}
+
+void SandboxChannel::discardPendingBlocks() noexcept
+{
+    toSandbox.discardAll();
+}
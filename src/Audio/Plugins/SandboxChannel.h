@@ -0,0 +1,106 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SharedMemory.h"
+
+#include <atomic>
+#include <memory>
+
+/**
+ * SandboxChannel carries audio blocks between the engine and a plugin running
+ * in a sandbox process (see PluginSandbox).
+ *
+ * It is a SharedMemory block holding two single-producer single-consumer
+ * rings of block slots, one each way. A slot carries a sequence number, the
+ * audio of every channel and up to maxMidiEvents short MIDI messages (SysEx
+ * is not carried). Pushing publishes the slot with a release store of the
+ * ring's write count and wakes the other side through that same word, so a
+ * waiting reader resumes straight away and an idle one costs nothing. Neither
+ * side ever locks or allocates.
+ *
+ * The engine creates the channel; the sandbox opens it by name. Replies are
+ * matched to requests by sequence, so a reply that arrives after the engine
+ * gave up on it is simply dropped.
+ */
+class SandboxChannel
+{
+public:
+    static constexpr int numSlots = 4;
+    static constexpr int maxMidiEvents = 256;
+    static constexpr int maxChannels = 32;
+
+    // Engine side: a new, empty channel
+    static std::unique_ptr<SandboxChannel> create(int numChannels, int maxBlockSize);
+
+    // Sandbox side: nullptr if it doesn't exist or wasn't made by this version
+    static std::unique_ptr<SandboxChannel> open(const juce::String& name);
+
+    const juce::String& getName() const { return memory->getName(); }
+    int getNumChannels() const { return numChannels; }
+    int getMaxBlockSize() const { return maxBlockSize; }
+
+    // Engine audio thread. sendBlock() is false when the sandbox is too far behind.
+    bool sendBlock(juce::uint32 sequence, const juce::AudioBuffer<float>& audio, int numSamples,
+                   const juce::MidiBuffer& midi) noexcept;
+
+    // Engine audio thread: waits for the reply to sequence, dropping older ones, and copies
+    // its audio into the buffer. False on timeout (the buffer is left alone).
+    bool receiveReply(juce::uint32 sequence, juce::AudioBuffer<float>& audio, int numSamples,
+                      int timeoutMicroseconds) noexcept;
+
+    // Sandbox processing thread: the next block, copied into audio and midi (audio must hold
+    // getNumChannels() x getMaxBlockSize()). False on timeout.
+    bool receiveBlock(juce::uint32& sequence, juce::AudioBuffer<float>& audio, int& numSamples,
+                      juce::MidiBuffer& midi, int timeoutMicroseconds) noexcept;
+
+    bool sendReply(juce::uint32 sequence, const juce::AudioBuffer<float>& audio,
+                   int numSamples) noexcept;
+
+    // Sandbox, before its first block: forgets requests left over from a previous sandbox
+    void discardPendingBlocks() noexcept;
+
+private:
+    struct Header;
+    struct RingState;
+    struct SlotHeader;
+    struct MidiEvent;
+
+    class Ring
+    {
+    public:
+        Ring() = default;
+        Ring(RingState* state, char* slots, size_t slotSize);
+
+        // Producer: the slot to fill, or nullptr when full; then publish()
+        SlotHeader* beginWrite() noexcept;
+        void publish() noexcept;
+
+        // Consumer: the oldest slot, waiting up to the deadline for one; then release()
+        SlotHeader* beginRead(juce::int64 deadlineTicks) noexcept;
+        void release() noexcept;
+
+        void discardAll() noexcept;
+
+    private:
+        RingState* state = nullptr;
+        char* slots = nullptr;
+        size_t slotSize = 0;
+    };
+
+    SandboxChannel(std::unique_ptr<SharedMemory> memory, int numChannels, int maxBlockSize);
+
+    static size_t getSlotSize(int numChannels, int maxBlockSize);
+    static size_t getTotalSize(int numChannels, int maxBlockSize);
+
+    float* getSlotAudio(SlotHeader* slot, int channel) const noexcept;
+    MidiEvent* getSlotMidi(SlotHeader* slot) const noexcept;
+
+    const std::unique_ptr<SharedMemory> memory;
+    const int numChannels;
+    const int maxBlockSize;
+
+    Ring toSandbox;
+    Ring toEngine;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SandboxChannel)
+};
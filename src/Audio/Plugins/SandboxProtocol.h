@@ -0,0 +1,105 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+ #include <signal.h>
+ #include <unistd.h>
+#endif
+
+/**
+ * Control messages between the engine and its helper processes, sent over
+ * JUCE's coordinator/worker pipe: a PluginSandbox and its PluginSandboxWorker,
+ * or a PluginScanner and its PluginScanWorkers. Audio never goes this way; it
+ * uses the SandboxChannel.
+ *
+ * Each message is a ValueTree whose type names the request or reply:
+ *
+ *   helper -> engine   ready {processId}        (once connected, either mode)
+ *
+ *   engine -> sandbox  load {plugin, channel, sampleRate, blockSize, state}
+ *                      setState {state}
+ *                      getState
+ *   sandbox -> engine  loaded {latency}
+ *                      error {message}
+ *                      state {state}
+ *
+ *   engine -> scanner  scan {format, identifier}
+ *   scanner -> engine  scanned {PLUGIN...}      (one child per plugin found)
+ *
+ * plugin is a PluginDescription as XML, channel the SandboxChannel's name,
+ * state a plugin state block in base 64. processId lets the engine kill a
+ * helper that has stopped answering.
+ */
+namespace SandboxProtocol
+{
+inline const juce::String commandLineId = "daiw-plugin-sandbox";
+inline const juce::String scannerCommandLineId = "daiw-plugin-scanner";
+
+inline const juce::Identifier ready{"ready"};
+
+inline const juce::Identifier load{"load"};
+inline const juce::Identifier setState{"setState"};
+inline const juce::Identifier getState{"getState"};
+inline const juce::Identifier loaded{"loaded"};
+inline const juce::Identifier error{"error"};
+inline const juce::Identifier state{"state"};
+inline const juce::Identifier scan{"scan"};
+inline const juce::Identifier scanned{"scanned"};
+
+inline const juce::Identifier plugin{"plugin"};
+inline const juce::Identifier channel{"channel"};
+inline const juce::Identifier sampleRate{"sampleRate"};
+inline const juce::Identifier blockSize{"blockSize"};
+inline const juce::Identifier latency{"latency"};
+inline const juce::Identifier processId{"processId"};
+inline const juce::Identifier message{"message"};
+inline const juce::Identifier format{"format"};
+inline const juce::Identifier identifier{"identifier"};
+
+inline juce::MemoryBlock toMemory(const juce::ValueTree& tree)
+{
+    juce::MemoryOutputStream stream;
+    tree.writeToStream(stream);
+    return stream.getMemoryBlock();
+}
+
+inline juce::ValueTree fromMemory(const juce::MemoryBlock& block)
+{
+    return juce::ValueTree::readFromData(block.getData(), block.getSize());
+}
+
+inline juce::String encodeState(const juce::MemoryBlock& block)
+{
+    return block.toBase64Encoding();
+}
+
+inline juce::MemoryBlock decodeState(const juce::String& text)
+{
+    juce::MemoryBlock block;
+    block.fromBase64Encoding(text);
+    return block;
+}
+
+inline int getProcessId()
+{
+#if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+    return static_cast<int>(getpid());
+#else
+    return 0;
+#endif
+}
+
+// killWorkerProcess() only asks a helper to quit; one stuck inside a plugin won't answer
+inline void killProcess(int processId)
+{
+#if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+    if (processId > 0)
+    {
+        ::kill(static_cast<pid_t>(processId), SIGKILL);
+    }
+#else
+    juce::ignoreUnused(processId);
+#endif
+}
+} // namespace SandboxProtocol
@@ -0,0 +1,172 @@
+#include "SharedMemory.h"
+
+#include <cerrno>
+#include <chrono>
+#include <thread>
+
+#if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+ #define DAIW_POSIX_SHARED_MEMORY 1
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+#else
+ #define DAIW_POSIX_SHARED_MEMORY 0
+#endif
+
+#if JUCE_LINUX
+ #include <climits>
+ #include <ctime>
+ #include <linux/futex.h>
+ #include <sys/syscall.h>
+#endif
+
+static_assert(sizeof(std::atomic<juce::uint32>) == sizeof(juce::uint32) &&
+                  std::atomic<juce::uint32>::is_always_lock_free,
+              "Shared words must be plain lock-free 32-bit integers");
+
+SharedMemory::SharedMemory(const juce::String& blockName, void* mapped, size_t mappedSize,
+                           bool isOwner)
+    : name(blockName), data(mapped), size(mappedSize), owner(isOwner)
+{
+}
+
+SharedMemory::~SharedMemory()
+{
+#if DAIW_POSIX_SHARED_MEMORY
+    munmap(data, size);
+
+    if (owner)
+    {
+        shm_unlink(name.toRawUTF8());
+    }
+#endif
+}
+
+bool SharedMemory::isSupported()
+{
+    return DAIW_POSIX_SHARED_MEMORY != 0;
+}
+
+juce::String SharedMemory::createUniqueName(const juce::String& prefix)
+{
+    // Short: macOS limits shared memory names to 31 characters
+    return "/" + prefix + juce::String::toHexString(juce::Random::getSystemRandom().nextInt64())
+                              .substring(0, 12);
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::create(const juce::String& name, size_t size)
+{
+#if DAIW_POSIX_SHARED_MEMORY
+    auto fd = shm_open(name.toRawUTF8(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+        close(fd);
+        shm_unlink(name.toRawUTF8());
+        return nullptr;
+    }
+
+    auto* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapped == MAP_FAILED)
+    {
+        shm_unlink(name.toRawUTF8());
+        return nullptr;
+    }
+
+    // New segments read as zero, which is every shared structure's initial state
+    return std::unique_ptr<SharedMemory>(new SharedMemory(name, mapped, size, true));
+#else
+    juce::ignoreUnused(name, size);
+    return nullptr;
+#endif
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::open(const juce::String& name, size_t size)
+{
+#if DAIW_POSIX_SHARED_MEMORY
+    auto fd = shm_open(name.toRawUTF8(), O_RDWR, 0);
+
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+
+    struct stat info;
+
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < size)
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    auto* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapped == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    return std::unique_ptr<SharedMemory>(new SharedMemory(name, mapped, size, false));
+#else
+    juce::ignoreUnused(name, size);
+    return nullptr;
+#endif
+}
+
+bool SharedMemory::wait(std::atomic<juce::uint32>& word, juce::uint32 expected,
+                        int timeoutMicroseconds) noexcept
+{
+#if JUCE_LINUX
+    // Not FUTEX_PRIVATE_FLAG: the other side is another process
+    struct timespec timeout;
+    timeout.tv_sec = timeoutMicroseconds / 1000000;
+    timeout.tv_nsec = static_cast<long>(timeoutMicroseconds % 1000000) * 1000;
+
+    auto result = syscall(SYS_futex, reinterpret_cast<juce::uint32*>(&word), FUTEX_WAIT, expected,
+                          timeoutMicroseconds < 0 ? nullptr : &timeout, nullptr, 0);
+
+    return result == 0 || errno != ETIMEDOUT;
+#else
+    // No portable cross-process futex: spin for the common sub-millisecond case, then poll
+    auto deadline = juce::Time::getHighResolutionTicks() +
+                    juce::Time::secondsToHighResolutionTicks(timeoutMicroseconds * 1.0e-6);
+
+    for (int spins = 0; word.load(std::memory_order_acquire) == expected; ++spins)
+    {
+        if (timeoutMicroseconds >= 0 && juce::Time::getHighResolutionTicks() >= deadline)
+        {
+            return false;
+        }
+
+        if (spins < 2000)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    return true;
+#endif
+}
+
+void SharedMemory::wake(std::atomic<juce::uint32>& word) noexcept
+{
+#if JUCE_LINUX
+    syscall(SYS_futex, reinterpret_cast<juce::uint32*>(&word), FUTEX_WAKE, INT_MAX, nullptr,
+            nullptr, 0);
+#else
+    juce::ignoreUnused(word);
+#endif
+}
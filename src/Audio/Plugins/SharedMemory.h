@@ -0,0 +1,53 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <atomic>
+
+/**
+ * SharedMemory is a named block of memory mapped into more than one process.
+ *
+ * The creator picks the name and owns the block: it is unlinked when the
+ * creator's object goes, while processes that opened it keep their mapping
+ * until they close it. POSIX (shm_open) only; isSupported() is false
+ * elsewhere, and callers fall back to hosting in process.
+ *
+ * wait() and wake() block on a 32-bit word inside a shared block, across
+ * processes: a futex on Linux, a short spin-then-sleep poll elsewhere.
+ */
+class SharedMemory
+{
+public:
+    ~SharedMemory();
+
+    static bool isSupported();
+
+    // nullptr on failure; create() fails if the name is already taken
+    static std::unique_ptr<SharedMemory> create(const juce::String& name, size_t size);
+    static std::unique_ptr<SharedMemory> open(const juce::String& name, size_t size);
+
+    // A fresh name no other process is using
+    static juce::String createUniqueName(const juce::String& prefix);
+
+    void* getData() const { return data; }
+    size_t getSize() const { return size; }
+    const juce::String& getName() const { return name; }
+
+    // Blocks while word == expected, for at most timeoutMicroseconds (< 0: no limit).
+    // False on timeout. Spurious returns are possible; re-check the word.
+    static bool wait(std::atomic<juce::uint32>& word, juce::uint32 expected,
+                     int timeoutMicroseconds) noexcept;
+
+    // Wakes every process waiting on the word
+    static void wake(std::atomic<juce::uint32>& word) noexcept;
+
+private:
+    SharedMemory(const juce::String& name, void* data, size_t size, bool owner);
+
+    const juce::String name;
+    void* const data;
+    const size_t size;
+    const bool owner;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharedMemory)
+};
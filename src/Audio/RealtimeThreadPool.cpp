@@ -0,0 +1,392 @@
+#include "RealtimeThreadPool.h"
+
+#include <thread>
+
+#if JUCE_INTEL
+ #include <emmintrin.h>
+#endif
+
+namespace
+{
+inline void cpuRelax() noexcept
+{
+#if JUCE_INTEL
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+} // namespace
+
+//==============================================================================
+// WorkStealingDeque
+//==============================================================================
+
+WorkStealingDeque::WorkStealingDeque(int capacity)
+    : mask(juce::nextPowerOfTwo(capacity) - 1),
+      tasks(std::make_unique<std::atomic<int>[]>(static_cast<size_t>(mask + 1)))
+{
+}
+
+bool WorkStealingDeque::push(int task) noexcept
+{
+    auto b = bottom.load(std::memory_order_relaxed);
+    auto t = top.load(std::memory_order_acquire);
+
+    if (b - t > mask)
+    {
+        return false;
+    }
+
+    tasks[static_cast<size_t>(b & mask)].store(task, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return true;
+}
+
+int WorkStealingDeque::pop() noexcept
+{
+    auto b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto t = top.load(std::memory_order_relaxed);
+
+    if (t > b)
+    {
+        // Already empty
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return empty;
+    }
+
+    auto task = tasks[static_cast<size_t>(b & mask)].load(std::memory_order_relaxed);
+
+    if (t == b)
+    {
+        // Last item: race any thief for it
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed))
+        {
+            task = empty;
+        }
+
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    return task;
+}
+
+int WorkStealingDeque::steal() noexcept
+{
+    auto t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto b = bottom.load(std::memory_order_acquire);
+
+    if (t >= b)
+    {
+        return empty;
+    }
+
+    auto task = tasks[static_cast<size_t>(t & mask)].load(std::memory_order_relaxed);
+
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                     std::memory_order_relaxed))
+    {
+        return empty;
+    }
+
+    return task;
+}
+
+//==============================================================================
+// TaskGraph
+//==============================================================================
+
+void RealtimeThreadPool::TaskGraph::clear()
+{
+    dependencyCounts.clear();
+    successorOffsets.assign(1, 0);
+    successors.clear();
+    pendingSuccessors.clear();
+}
+
+int RealtimeThreadPool::TaskGraph::addTask(const std::vector<int>& dependencies)
+{
+    auto index = static_cast<int>(dependencyCounts.size());
+    jassert(index < maxTasks);
+
+    dependencyCounts.push_back(static_cast<int>(dependencies.size()));
+    pendingSuccessors.emplace_back();
+
+    for (auto dependency : dependencies)
+    {
+        jassert(dependency >= 0 && dependency < index);
+        pendingSuccessors[static_cast<size_t>(dependency)].push_back(index);
+    }
+
+    return index;
+}
+
+void RealtimeThreadPool::TaskGraph::finalise()
+{
+    successorOffsets.assign(1, 0);
+    successors.clear();
+
+    for (const auto& taskSuccessors : pendingSuccessors)
+    {
+        successors.insert(successors.end(), taskSuccessors.begin(), taskSuccessors.end());
+        successorOffsets.push_back(static_cast<int>(successors.size()));
+    }
+
+    pendingSuccessors.clear();
+}
+
+//==============================================================================
+// Worker
+//==============================================================================
+
+class RealtimeThreadPool::Worker : public juce::Thread
+{
+public:
+    Worker(RealtimeThreadPool& threadPool, int participantIndex)
+        : juce::Thread("DAIW Audio Worker " + juce::String(participantIndex)), pool(threadPool),
+          participant(participantIndex)
+    {
+    }
+
+    void wakeIfSleeping() noexcept
+    {
+        if (sleeping.load())
+        {
+            notify();
+        }
+    }
+
+private:
+    // How long to spin for the next callback before going to sleep
+    static constexpr double spinMs = 0.2;
+
+    void run() override
+    {
+        auto lastGeneration = pool.generation.load();
+
+        while (!threadShouldExit())
+        {
+            if (!waitForNextJob(lastGeneration))
+            {
+                continue;
+            }
+
+            lastGeneration = pool.generation.load();
+
+            pool.activeWorkers.fetch_add(1);
+
+            // The job may have finished between the wake-up and registering as active
+            if (pool.jobRunning.load())
+            {
+                while (pool.remainingTasks.load(std::memory_order_acquire) > 0)
+                {
+                    if (!pool.runOneTask(participant))
+                    {
+                        cpuRelax();
+                    }
+                }
+            }
+
+            pool.activeWorkers.fetch_sub(1);
+        }
+    }
+
+    bool waitForNextJob(juce::uint32 lastGeneration)
+    {
+        auto spinUntil = juce::Time::getMillisecondCounterHiRes() + spinMs;
+
+        while (juce::Time::getMillisecondCounterHiRes() < spinUntil)
+        {
+            if (pool.generation.load() != lastGeneration)
+            {
+                return true;
+            }
+
+            cpuRelax();
+        }
+
+        sleeping.store(true);
+
+        // Re-check after announcing the sleep so a job published meanwhile isn't missed
+        if (pool.generation.load() == lastGeneration)
+        {
+            wait(100);
+        }
+
+        sleeping.store(false);
+        return pool.generation.load() != lastGeneration;
+    }
+
+    RealtimeThreadPool& pool;
+    const int participant;
+    std::atomic<bool> sleeping{false};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Worker)
+};
+
+//==============================================================================
+// RealtimeThreadPool
+//==============================================================================
+
+RealtimeThreadPool::RealtimeThreadPool(int numWorkers)
+    : pendingDependencies(std::make_unique<std::atomic<int>[]>(maxTasks))
+{
+    numWorkers = juce::jmax(0, numWorkers);
+
+    for (int i = 0; i <= numWorkers; ++i)
+    {
+        deques.push_back(std::make_unique<WorkStealingDeque>(maxTasks));
+    }
+
+    for (int i = 1; i <= numWorkers; ++i)
+    {
+        workers.push_back(std::make_unique<Worker>(*this, i));
+    }
+}
+
+RealtimeThreadPool::~RealtimeThreadPool()
+{
+    stopWorkers();
+}
+
+int RealtimeThreadPool::getDefaultNumWorkers()
+{
+    return juce::jmax(0, juce::SystemStats::getNumPhysicalCpus() - 1);
+}
+
+void RealtimeThreadPool::prepare(double sampleRate, int blockSize)
+{
+    auto periodMs = sampleRate > 0.0 ? 1000.0 * blockSize / sampleRate : 0.0;
+
+    if (periodMs == preparedPeriodMs && (workers.empty() || workers.front()->isThreadRunning()))
+    {
+        return;
+    }
+
+    stopWorkers();
+    preparedPeriodMs = periodMs;
+
+    for (auto& worker : workers)
+    {
+        auto options = juce::Thread::RealtimeOptions().withPriority(9);
+        if (periodMs > 0.0)
+        {
+            options = options.withPeriodMs(periodMs);
+        }
+
+        if (!worker->startRealtimeThread(options))
+        {
+            // Real-time scheduling usually needs extra privileges on Linux
+            worker->startThread(juce::Thread::Priority::highest);
+        }
+    }
+}
+
+void RealtimeThreadPool::stopWorkers()
+{
+    for (auto& worker : workers)
+    {
+        worker->signalThreadShouldExit();
+        worker->notify();
+    }
+
+    for (auto& worker : workers)
+    {
+        worker->stopThread(1000);
+    }
+}
+
+bool RealtimeThreadPool::runOneTask(int participant) noexcept
+{
+    auto numParticipants = static_cast<int>(deques.size());
+    auto task = deques[static_cast<size_t>(participant)]->pop();
+
+    for (int i = 1; task == WorkStealingDeque::empty && i < numParticipants; ++i)
+    {
+        task = deques[static_cast<size_t>((participant + i) % numParticipants)]->steal();
+    }
+
+    if (task == WorkStealingDeque::empty)
+    {
+        return false;
+    }
+
+    currentJob->runTask(task);
+
+    const auto& graph = *currentGraph;
+    auto& ownDeque = *deques[static_cast<size_t>(participant)];
+
+    for (int i = graph.successorOffsets[static_cast<size_t>(task)];
+         i < graph.successorOffsets[static_cast<size_t>(task) + 1]; ++i)
+    {
+        auto successor = graph.successors[static_cast<size_t>(i)];
+
+        if (pendingDependencies[static_cast<size_t>(successor)].fetch_sub(
+                1, std::memory_order_acq_rel) == 1)
+        {
+            ownDeque.push(successor);
+        }
+    }
+
+    // Last, so remainingTasks only reaches zero once every successor has been queued
+    remainingTasks.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+}
+
+void RealtimeThreadPool::execute(Job& job, const TaskGraph& graph) noexcept
+{
+    auto numTasks = graph.getNumTasks();
+    jassert(numTasks <= maxTasks);
+    jassert(static_cast<int>(graph.successorOffsets.size()) == numTasks + 1);
+
+    if (numTasks == 0)
+    {
+        return;
+    }
+
+    currentJob = &job;
+    currentGraph = &graph;
+
+    auto& ownDeque = *deques.front();
+
+    for (int i = 0; i < numTasks; ++i)
+    {
+        auto dependencies = graph.dependencyCounts[static_cast<size_t>(i)];
+        pendingDependencies[static_cast<size_t>(i)].store(dependencies, std::memory_order_relaxed);
+
+        if (dependencies == 0)
+        {
+            ownDeque.push(i);
+        }
+    }
+
+    remainingTasks.store(numTasks);
+    jobRunning.store(true);
+    generation.fetch_add(1);
+
+    for (auto& worker : workers)
+    {
+        worker->wakeIfSleeping();
+    }
+
+    while (remainingTasks.load(std::memory_order_acquire) > 0)
+    {
+        if (!runOneTask(0))
+        {
+            cpuRelax();
+        }
+    }
+
+    // Don't return (and let the caller change the graph) while a worker is still inside it
+    jobRunning.store(false);
+
+    while (activeWorkers.load() > 0)
+    {
+        cpuRelax();
+    }
+}
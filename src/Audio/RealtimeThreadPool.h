@@ -0,0 +1,118 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * WorkStealingDeque is a fixed-capacity Chase-Lev deque of task indices.
+ *
+ * The owning thread pushes and pops at the bottom; any other thread may steal
+ * from the top. Nothing locks or allocates after construction.
+ */
+class WorkStealingDeque
+{
+public:
+    static constexpr int empty = -1;
+
+    explicit WorkStealingDeque(int capacity);
+
+    // Owner thread only. push() returns false if the deque is full.
+    bool push(int task) noexcept;
+    int pop() noexcept;
+
+    // Any thread. Returns empty if there was nothing to take or another thread won the race.
+    int steal() noexcept;
+
+private:
+    const juce::int64 mask;
+    std::unique_ptr<std::atomic<int>[]> tasks;
+    alignas(64) std::atomic<juce::int64> top{0};
+    alignas(64) std::atomic<juce::int64> bottom{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WorkStealingDeque)
+};
+
+/**
+ * RealtimeThreadPool runs a graph of tasks within one audio callback.
+ *
+ * The caller (the audio thread) publishes a TaskGraph and works on it itself
+ * alongside a set of real-time worker threads. Each participant keeps its own
+ * WorkStealingDeque: a finished task decrements the dependency counters of its
+ * successors, and any that reach zero are pushed onto the finishing thread's
+ * deque, so dependent work stays on a warm cache unless an idle thread steals it.
+ * execute() returns once every task has run and no worker still touches the graph.
+ *
+ * Workers spin briefly between callbacks and then sleep; waking them is the only
+ * operation on the audio thread that may enter the OS.
+ */
+class RealtimeThreadPool
+{
+public:
+    static constexpr int maxTasks = 4096;
+
+    /** Task dependencies in compressed form: task i's successors are
+        successors[successorOffsets[i] .. successorOffsets[i + 1]). */
+    struct TaskGraph
+    {
+        std::vector<int> dependencyCounts;
+        std::vector<int> successorOffsets{0};
+        std::vector<int> successors;
+
+        int getNumTasks() const { return static_cast<int>(dependencyCounts.size()); }
+
+        // Builds the graph task by task (dependencies must refer to earlier tasks),
+        // then finalise() packs the successor lists. Not real-time safe.
+        void clear();
+        int addTask(const std::vector<int>& dependencies);
+        void finalise();
+
+    private:
+        std::vector<std::vector<int>> pendingSuccessors;
+    };
+
+    /** The work itself; runTask() is called once per task from any participating thread. */
+    class Job
+    {
+    public:
+        virtual ~Job() = default;
+        virtual void runTask(int taskIndex) noexcept = 0;
+    };
+
+    explicit RealtimeThreadPool(int numWorkers = getDefaultNumWorkers());
+    ~RealtimeThreadPool();
+
+    // One worker per physical core besides the audio thread's
+    static int getDefaultNumWorkers();
+    int getNumWorkers() const { return static_cast<int>(workers.size()); }
+
+    // Starts the workers, using the buffer period as their real-time scheduling hint.
+    // Call while the audio callback is stopped.
+    void prepare(double sampleRate, int blockSize);
+    void stopWorkers();
+
+    // Audio thread only
+    void execute(Job& job, const TaskGraph& graph) noexcept;
+
+private:
+    class Worker;
+
+    bool runOneTask(int participant) noexcept;
+
+    std::vector<std::unique_ptr<WorkStealingDeque>> deques; // [0] is the audio thread's
+    std::unique_ptr<std::atomic<int>[]> pendingDependencies;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    Job* currentJob = nullptr;
+    const TaskGraph* currentGraph = nullptr;
+
+    std::atomic<juce::uint32> generation{0};
+    std::atomic<bool> jobRunning{false};
+    std::atomic<int> remainingTasks{0};
+    std::atomic<int> activeWorkers{0};
+
+    double preparedPeriodMs = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RealtimeThreadPool)
+};
@@ -0,0 +1,452 @@
+#include "Recorder.h"
+#include "../Waveform/PeakCache.h"
+
+juce::var Recorder::Stats::toVar() const
+{
+    auto* object = new juce::DynamicObject();
+    object->setProperty("recording", recording);
+    object->setProperty("numChannels", numChannels);
+    object->setProperty("samplesCaptured", samplesCaptured);
+    object->setProperty("samplesWritten", samplesWritten);
+    object->setProperty("droppedSamples", droppedSamples);
+    object->setProperty("overflows", overflows);
+    object->setProperty("writeErrors", writeErrors);
+    object->setProperty("bufferFill", bufferFill);
+    object->setProperty("peakBufferFill", peakBufferFill);
+    object->setProperty("maxWriteMs", maxWriteMs);
+    return juce::var(object);
+}
+
+Recorder::Recorder() : juce::Thread("DAIW Recorder") {}
+
+Recorder::~Recorder()
+{
+    stop();
+}
+
+void Recorder::prepare(double newSampleRate)
+{
+    // A running take keeps the rate its files were created with
+    if (!isRecording())
+    {
+        sampleRate = newSampleRate;
+    }
+}
+
+juce::Result Recorder::start(const juce::File& directory, const juce::String& takeName,
+                             const juce::BigInteger& armedInputs, const Options& takeOptions)
+{
+    if (isRecording())
+    {
+        return juce::Result::fail("Already recording");
+    }
+
+    std::vector<int> channels;
+
+    for (int channel = armedInputs.findNextSetBit(0); channel >= 0;
+         channel = armedInputs.findNextSetBit(channel + 1))
+    {
+        channels.push_back(channel);
+    }
+
+    if (channels.empty())
+    {
+        return juce::Result::fail("No inputs armed");
+    }
+
+    auto result = directory.createDirectory();
+
+    if (result.failed())
+    {
+        return result;
+    }
+
+    options = takeOptions;
+    files.clear();
+    writers.clear();
+    peaks.clear();
+
+    juce::WavAudioFormat wavFormat;
+
+    for (auto channel : channels)
+    {
+        auto file = directory.getNonexistentChildFile(
+            takeName + "_In" + juce::String(channel + 1), ".wav", false);
+
+        // Large stream buffer: the writer hands it a whole chunk at a time
+        auto stream = std::make_unique<juce::FileOutputStream>(file, 1 << 18);
+        std::unique_ptr<juce::AudioFormatWriter> writer;
+
+        if (stream->openedOk())
+        {
+            writer.reset(wavFormat.createWriterFor(stream.get(), sampleRate, 1,
+                                                   options.bitsPerSample, {}, 0));
+        }
+
+        if (writer == nullptr)
+        {
+            writers.clear();
+            peaks.clear();
+            return juce::Result::fail("Could not create " + file.getFullPathName());
+        }
+
+        stream.release();
+        writers.push_back(std::move(writer));
+        files.add(file);
+        peaks.push_back(std::make_shared<PeakPyramid>(1, sampleRate));
+    }
+
+    capacity = juce::jmax(chunkSize * 2, static_cast<int>(options.bufferSeconds * sampleRate));
+    ring.setSize(static_cast<int>(channels.size()), capacity);
+    silence.setSize(1, chunkSize);
+    silence.clear();
+    channelPointers.resize(channels.size());
+
+    samplesDrained = 0;
+    lastHeaderUpdate = juce::Time::getMillisecondCounterHiRes();
+    samplesCaptured = 0;
+    samplesWritten = 0;
+    droppedSamples = 0;
+    overflows = 0;
+    writeErrors = 0;
+    ready = 0;
+    peakReady = 0;
+    maxWriteMs = 0.0;
+    gapFifo.reset();
+
+    // Not touched by capture() until 'recording' is set under the lock below
+    armedChannels = std::move(channels);
+    fifo = std::make_unique<juce::AbstractFifo>(capacity + 1);
+    samplesQueued = 0;
+    hasPendingGap = false;
+    samplesToSkip = juce::jmax(0, options.latencyCompensation);
+
+    startThread(juce::Thread::Priority::high);
+
+    {
+        const juce::SpinLock::ScopedLockType sl(lock);
+        recording = true;
+    }
+
+    DBG("Recorder: Recording " + juce::String(static_cast<int>(writers.size())) + " inputs");
+    return juce::Result::ok();
+}
+
+void Recorder::stop()
+{
+    if (!isRecording())
+    {
+        return;
+    }
+
+    {
+        // Once this is held no capture() is in flight, and none will start
+        const juce::SpinLock::ScopedLockType sl(lock);
+        recording = false;
+    }
+
+    // The writer drains everything captured before it exits
+    stopThread(-1);
+
+    // A gap that never made it into the queue is the end of the take
+    if (hasPendingGap)
+    {
+        writeSilence(pendingGap.numSamples);
+        hasPendingGap = false;
+    }
+
+    // Deleting the writers writes the final headers
+    writers.clear();
+
+    // The files are final now, so their peak caches can be stamped with them
+    for (size_t i = 0; i < peaks.size(); ++i)
+    {
+        peaks[i]->finish();
+        auto cacheResult = PeakCache::write(*peaks[i], files[static_cast<int>(i)]);
+
+        if (cacheResult.failed())
+        {
+            DBG("Recorder: " + cacheResult.getErrorMessage());
+        }
+    }
+
+    fifo.reset();
+    ring.setSize(0, 0);
+    silence.setSize(0, 0);
+    armedChannels.clear();
+
+    DBG("Recorder: Stopped after " + juce::String(samplesWritten.load()) + " samples");
+}
+
+void Recorder::capture(const juce::AudioBuffer<float>& input, int startSample,
+                       int numSamples) noexcept
+{
+    const juce::SpinLock::ScopedTryLockType sl(lock);
+
+    if (!sl.isLocked() || !recording.load(std::memory_order_relaxed) || numSamples <= 0)
+    {
+        return;
+    }
+
+    // Audio from before the take started, still on its way round the loop
+    if (samplesToSkip > 0)
+    {
+        auto numToSkip = juce::jmin(samplesToSkip, numSamples);
+        samplesToSkip -= numToSkip;
+        startSample += numToSkip;
+        numSamples -= numToSkip;
+
+        if (numSamples == 0)
+        {
+            return;
+        }
+    }
+
+    samplesCaptured.fetch_add(numSamples, std::memory_order_relaxed);
+
+    // A gap still waiting for the queue comes before any new audio, so keep dropping
+    if (hasPendingGap)
+    {
+        if (!pushGap(pendingGap))
+        {
+            pendingGap.numSamples += numSamples;
+            samplesQueued += numSamples;
+            droppedSamples.fetch_add(numSamples, std::memory_order_relaxed);
+            return;
+        }
+
+        hasPendingGap = false;
+    }
+
+    if (fifo->getFreeSpace() < numSamples)
+    {
+        // Disk has fallen too far behind: drop the block and leave a gap of the same length
+        Gap gap{samplesQueued, numSamples};
+
+        if (!pushGap(gap))
+        {
+            pendingGap = gap;
+            hasPendingGap = true;
+        }
+
+        samplesQueued += numSamples;
+        droppedSamples.fetch_add(numSamples, std::memory_order_relaxed);
+        overflows.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    int start1, size1, start2, size2;
+    fifo->prepareToWrite(numSamples, start1, size1, start2, size2);
+
+    for (size_t i = 0; i < armedChannels.size(); ++i)
+    {
+        auto destChannel = static_cast<int>(i);
+        auto sourceChannel = armedChannels[i];
+
+        // Armed inputs the device doesn't have record silence
+        if (sourceChannel >= input.getNumChannels())
+        {
+            ring.clear(destChannel, start1, size1);
+            ring.clear(destChannel, start2, size2);
+            continue;
+        }
+
+        ring.copyFrom(destChannel, start1, input, sourceChannel, startSample, size1);
+
+        if (size2 > 0)
+        {
+            ring.copyFrom(destChannel, start2, input, sourceChannel, startSample + size1, size2);
+        }
+    }
+
+    fifo->finishedWrite(size1 + size2);
+    samplesQueued += numSamples;
+
+    auto numReady = fifo->getNumReady();
+    ready.store(numReady, std::memory_order_relaxed);
+
+    if (numReady > peakReady.load(std::memory_order_relaxed))
+    {
+        peakReady.store(numReady, std::memory_order_relaxed);
+    }
+}
+
+std::shared_ptr<const PeakPyramid> Recorder::getPeaks(int fileIndex) const
+{
+    if (fileIndex < 0 || fileIndex >= static_cast<int>(peaks.size()))
+    {
+        return nullptr;
+    }
+
+    return peaks[static_cast<size_t>(fileIndex)];
+}
+
+bool Recorder::pushGap(const Gap& gap) noexcept
+{
+    int start1, size1, start2, size2;
+    gapFifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 + size2 < 1)
+    {
+        return false;
+    }
+
+    gaps[size1 > 0 ? start1 : start2] = gap;
+    gapFifo.finishedWrite(1);
+    return true;
+}
+
+void Recorder::run()
+{
+    for (;;)
+    {
+        // Checked before draining so the final pass sees every captured block
+        auto exiting = threadShouldExit();
+
+        while (writeChunk(exiting))
+        {
+        }
+
+        if (exiting)
+        {
+            break;
+        }
+
+        auto now = juce::Time::getMillisecondCounterHiRes();
+
+        if (now - lastHeaderUpdate >= options.headerUpdateSeconds * 1000.0)
+        {
+            flushHeaders();
+            lastHeaderUpdate = now;
+        }
+
+        // The audio thread never signals (that could block it), so poll
+        wait(10);
+    }
+}
+
+bool Recorder::writeChunk(bool flushRemainder)
+{
+    // Audio first, then gaps: any gap before the audio seen here is then visible too
+    auto numReady = fifo->getNumReady();
+
+    int gapStart1, gapSize1, gapStart2, gapSize2;
+    gapFifo.prepareToRead(1, gapStart1, gapSize1, gapStart2, gapSize2);
+    const Gap* gap = gapSize1 + gapSize2 > 0 ? &gaps[gapSize1 > 0 ? gapStart1 : gapStart2]
+                                              : nullptr;
+
+    if (gap != nullptr && gap->position == samplesDrained)
+    {
+        writeSilence(gap->numSamples);
+        samplesDrained += gap->numSamples;
+        gapFifo.finishedRead(1);
+        return true;
+    }
+
+    auto numToWrite = juce::jmin(numReady, chunkSize);
+    auto reachesGap = false;
+
+    if (gap != nullptr && samplesDrained + numToWrite >= gap->position)
+    {
+        numToWrite = static_cast<int>(gap->position - samplesDrained);
+        reachesGap = true;
+    }
+
+    // Whole chunks only, unless the audio runs up to a gap or the take is ending
+    if (numToWrite <= 0 || (numToWrite < chunkSize && !reachesGap && !flushRemainder))
+    {
+        return false;
+    }
+
+    int start1, size1, start2, size2;
+    fifo->prepareToRead(numToWrite, start1, size1, start2, size2);
+
+    auto startTime = juce::Time::getMillisecondCounterHiRes();
+    writeRing(start1, size1);
+    writeRing(start2, size2);
+    auto elapsed = juce::Time::getMillisecondCounterHiRes() - startTime;
+
+    if (elapsed > maxWriteMs.load(std::memory_order_relaxed))
+    {
+        maxWriteMs.store(elapsed, std::memory_order_relaxed);
+    }
+
+    fifo->finishedRead(size1 + size2);
+    samplesDrained += numToWrite;
+    ready.store(fifo->getNumReady(), std::memory_order_relaxed);
+    return true;
+}
+
+void Recorder::writeRing(int ringStart, int numSamples)
+{
+    if (numSamples <= 0)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < writers.size(); ++i)
+    {
+        channelPointers[i] = ring.getReadPointer(static_cast<int>(i), ringStart);
+
+        if (!writers[i]->writeFromFloatArrays(&channelPointers[i], 1, numSamples))
+        {
+            writeErrors.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        peaks[i]->addSamples(&channelPointers[i], numSamples);
+    }
+
+    samplesWritten.fetch_add(numSamples, std::memory_order_relaxed);
+}
+
+void Recorder::writeSilence(int numSamples)
+{
+    const float* zeros = silence.getReadPointer(0);
+
+    for (int remaining = numSamples; remaining > 0; remaining -= chunkSize)
+    {
+        auto count = juce::jmin(remaining, chunkSize);
+
+        for (size_t i = 0; i < writers.size(); ++i)
+        {
+            if (!writers[i]->writeFromFloatArrays(&zeros, 1, count))
+            {
+                writeErrors.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            peaks[i]->addSamples(&zeros, count);
+        }
+
+        samplesWritten.fetch_add(count, std::memory_order_relaxed);
+    }
+}
+
+void Recorder::flushHeaders()
+{
+    // WAV writers rewrite their header with the current length, then flush the stream
+    for (auto& writer : writers)
+    {
+        writer->flush();
+    }
+}
+
+Recorder::Stats Recorder::getStats() const
+{
+    Stats stats;
+    stats.recording = isRecording();
+    stats.numChannels = files.size();
+    stats.samplesCaptured = samplesCaptured.load();
+    stats.samplesWritten = samplesWritten.load();
+    stats.droppedSamples = droppedSamples.load();
+    stats.overflows = overflows.load();
+    stats.writeErrors = writeErrors.load();
+    stats.maxWriteMs = maxWriteMs.load();
+
+    if (capacity > 0)
+    {
+        stats.bufferFill = static_cast<double>(ready.load()) / capacity;
+        stats.peakBufferFill = static_cast<double>(peakReady.load()) / capacity;
+    }
+
+    return stats;
+}
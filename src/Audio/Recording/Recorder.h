@@ -0,0 +1,141 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../Waveform/PeakPyramid.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * Recorder writes armed inputs to disk without file I/O on the audio thread.
+ *
+ * capture() copies the armed channels of each block into a ring allocated when
+ * the take starts, and a writer thread drains it in large chunks to one mono
+ * WAV file per input. Headers are rewritten every couple of seconds so a crash
+ * leaves readable files missing at most that much audio; takes past 4 GB
+ * switch to RF64.
+ *
+ * Input arrives a device round trip after the output it was played along
+ * to, so the first latencyCompensation samples of a take are dropped and the
+ * files line up with the timeline the performer heard.
+ *
+ * If the disk stalls long enough for the ring to fill, whole blocks are
+ * dropped and counted, and the writer puts the same length of silence in
+ * their place so every file stays in sync with the timeline.
+ *
+ * The writer also feeds each file's waveform peaks as it writes, so a take
+ * can be drawn while it records and its peak cache is saved when it stops,
+ * without reading the audio back.
+ */
+class Recorder : private juce::Thread
+{
+public:
+    struct Options
+    {
+        int bitsPerSample = 24;
+        double bufferSeconds = 2.0;       // Ring length, the longest disk stall ridden out
+        double headerUpdateSeconds = 2.0; // Most audio a crash can lose
+        int latencyCompensation = 0;      // Round trip in samples, trimmed from the take start
+    };
+
+    struct Stats
+    {
+        bool recording = false;
+        int numChannels = 0;
+        juce::int64 samplesCaptured = 0; // Per channel, including dropped blocks
+        juce::int64 samplesWritten = 0;  // Per channel, including silence for dropped blocks
+        juce::int64 droppedSamples = 0;
+        juce::int64 overflows = 0;       // Blocks dropped because the ring was full
+        juce::int64 writeErrors = 0;
+        double bufferFill = 0.0;         // Fraction of the ring in use
+        double peakBufferFill = 0.0;
+        double maxWriteMs = 0.0;         // Slowest chunk write
+
+        juce::var toVar() const;
+    };
+
+    Recorder();
+    ~Recorder() override;
+
+    // Message thread
+    void prepare(double sampleRate);
+    juce::Result start(const juce::File& directory, const juce::String& takeName,
+                       const juce::BigInteger& armedInputs, const Options& options);
+
+    // Waits for the writer to drain the ring and finalises the files
+    void stop();
+
+    bool isRecording() const { return recording.load(); }
+    juce::Array<juce::File> getRecordedFiles() const { return files; }
+
+    // Peaks of each recorded file, growing while the take runs (nullptr if out of range)
+    std::shared_ptr<const PeakPyramid> getPeaks(int fileIndex) const;
+
+    // Audio thread: the inputs are the buffer's first channels
+    void capture(const juce::AudioBuffer<float>& input, int startSample,
+                 int numSamples) noexcept;
+
+    // Message thread
+    Stats getStats() const;
+
+    static constexpr int chunkSize = 16384; // Samples per channel per write
+    static constexpr int maxGaps = 256;
+
+private:
+    // A run of dropped samples, at this many samples into the take
+    struct Gap
+    {
+        juce::int64 position = 0;
+        int numSamples = 0;
+    };
+
+    void run() override;
+    bool pushGap(const Gap& gap) noexcept;
+    bool writeChunk(bool flushRemainder);
+    void writeRing(int ringStart, int numSamples);
+    void writeSilence(int numSamples);
+    void flushHeaders();
+
+    double sampleRate = 48000.0;
+    Options options;
+    juce::Array<juce::File> files;
+    std::vector<std::shared_ptr<PeakPyramid>> peaks; // Fed by the writer thread
+
+    // Take state: allocated in start() and released in stop()
+    juce::SpinLock lock; // Held by capture(); start() and stop() only hold it to flip state
+    std::atomic<bool> recording{false};
+    std::vector<int> armedChannels;
+    std::unique_ptr<juce::AbstractFifo> fifo;
+    juce::AudioBuffer<float> ring;
+
+    // Dropped-block positions, from the audio thread to the writer
+    juce::AbstractFifo gapFifo{maxGaps};
+    Gap gaps[maxGaps];
+
+    // Writer thread only
+    std::vector<std::unique_ptr<juce::AudioFormatWriter>> writers;
+    juce::AudioBuffer<float> silence;
+    std::vector<const float*> channelPointers;
+    juce::int64 samplesDrained = 0;
+    double lastHeaderUpdate = 0.0;
+
+    // Audio thread only
+    juce::int64 samplesQueued = 0; // Captured into the ring or recorded as a gap
+    Gap pendingGap;                // Held back while the gap queue is full
+    bool hasPendingGap = false;
+    int samplesToSkip = 0;         // Latency compensation still to trim
+
+    // Metrics
+    std::atomic<juce::int64> samplesCaptured{0};
+    std::atomic<juce::int64> samplesWritten{0};
+    std::atomic<juce::int64> droppedSamples{0};
+    std::atomic<juce::int64> overflows{0};
+    std::atomic<juce::int64> writeErrors{0};
+    int capacity = 0;
+    std::atomic<int> ready{0};
+    std::atomic<int> peakReady{0};
+    std::atomic<double> maxWriteMs{0.0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Recorder)
+};
@@ -0,0 +1,36 @@
+#include "SessionPublisher.h"
+
+SessionPublisher::SessionPublisher(GarbageCollector& collector)
+    : garbageCollector(collector), current(new SessionSnapshot())
+{
+}
+
+SessionPublisher::~SessionPublisher()
+{
+    // The audio callback has stopped by now
+    delete pending.exchange(nullptr);
+    delete current;
+}
+
+juce::uint64 SessionPublisher::publish(SessionSnapshot next)
+{
+    auto version = latest.version + 1;
+    latest = std::move(next);
+    latest.version = version;
+
+    // Still pending means the audio thread never saw it
+    delete pending.exchange(new SessionSnapshot(latest), std::memory_order_acq_rel);
+    return version;
+}
+
+const SessionSnapshot& SessionPublisher::acquire() noexcept
+{
+    // No room to retire the old version: keep reading it and try again next block
+    if (pending.load(std::memory_order_acquire) != nullptr && garbageCollector.retire(current))
+    {
+        // Only this thread empties the slot, so it still holds a version (maybe a newer one)
+        current = pending.exchange(nullptr, std::memory_order_acq_rel);
+    }
+
+    return *current;
+}
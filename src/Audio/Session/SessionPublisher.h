@@ -0,0 +1,53 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "Audio/GarbageCollector.h"
+#include "SessionSnapshot.h"
+
+#include <atomic>
+
+/**
+ * SessionPublisher hands SessionSnapshots from the message thread to the
+ * audio thread, read-copy-update style.
+ *
+ * publish() puts a private copy of the new version in a single pending slot
+ * with an atomic exchange. If the audio thread hadn't picked up the version
+ * already there, nothing else can be reading it and it is deleted on the
+ * spot, so a burst of edits costs the audio thread nothing. At the start of
+ * each block the audio thread takes whatever is pending with another
+ * exchange and retires the version it was reading to the GarbageCollector:
+ * block boundaries are the only point where no reader (the audio thread or a
+ * pool worker) can still hold it, and its memory, along with any tracks only
+ * it shared, is freed on the collector's thread.
+ *
+ * Neither side ever waits for the other, however large the edit.
+ */
+class SessionPublisher
+{
+public:
+    explicit SessionPublisher(GarbageCollector& garbageCollector);
+    ~SessionPublisher();
+
+    // Message thread: the last version published, to make the next one from
+    const SessionSnapshot& getLatest() const { return latest; }
+
+    // Message thread: publishes a new version and returns its version number
+    juce::uint64 publish(SessionSnapshot next);
+
+    // Audio thread, at the start of each block: moves on to the newest version
+    const SessionSnapshot& acquire() noexcept;
+
+    // Audio thread and pool workers, valid for the block being processed
+    const SessionSnapshot& get() const noexcept { return *current; }
+
+private:
+    GarbageCollector& garbageCollector;
+
+    // Message thread
+    SessionSnapshot latest;
+
+    std::atomic<SessionSnapshot*> pending{nullptr}; // Published, not yet picked up
+    SessionSnapshot* current = nullptr;             // Audio thread
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SessionPublisher)
+};
@@ -0,0 +1,89 @@
+#include "SessionSnapshot.h"
+
+#include <algorithm>
+
+SessionSnapshot::SessionSnapshot()
+    : tracks(std::make_shared<TrackList>()),
+      markers(std::make_shared<std::vector<Marker>>())
+{
+}
+
+const TrackSnapshot* SessionSnapshot::findTrack(NodeID id) const noexcept
+{
+    for (const auto& track : *tracks)
+    {
+        if (track->id == id)
+        {
+            return track.get();
+        }
+    }
+
+    return nullptr;
+}
+
+TrackSnapshot SessionSnapshot::copyTrack(NodeID id) const
+{
+    if (const auto* track = findTrack(id))
+    {
+        return *track;
+    }
+
+    TrackSnapshot track;
+    track.id = id;
+    return track;
+}
+
+SessionSnapshot SessionSnapshot::withTempo(double bpm) const
+{
+    auto copy = *this;
+    copy.tempo = bpm;
+    return copy;
+}
+
+SessionSnapshot SessionSnapshot::withTimeSignature(int newNumerator, int newDenominator) const
+{
+    auto copy = *this;
+    copy.numerator = newNumerator;
+    copy.denominator = newDenominator;
+    return copy;
+}
+
+SessionSnapshot SessionSnapshot::withTrack(TrackSnapshot track) const
+{
+    auto shared = std::make_shared<TrackSnapshot>(std::move(track));
+    auto newTracks = *tracks;
+    auto it = std::find_if(newTracks.begin(), newTracks.end(),
+                           [&shared](const auto& t) { return t->id == shared->id; });
+
+    if (it != newTracks.end())
+    {
+        *it = std::move(shared);
+    }
+    else
+    {
+        newTracks.push_back(std::move(shared));
+    }
+
+    auto copy = *this;
+    copy.tracks = std::make_shared<TrackList>(std::move(newTracks));
+    return copy;
+}
+
+SessionSnapshot SessionSnapshot::withoutTrack(NodeID id) const
+{
+    auto newTracks = *tracks;
+    newTracks.erase(std::remove_if(newTracks.begin(), newTracks.end(),
+                                   [id](const auto& t) { return t->id == id; }),
+                    newTracks.end());
+
+    auto copy = *this;
+    copy.tracks = std::make_shared<TrackList>(std::move(newTracks));
+    return copy;
+}
+
+SessionSnapshot SessionSnapshot::withMarkers(std::vector<Marker> newMarkers) const
+{
+    auto copy = *this;
+    copy.markers = std::make_shared<std::vector<Marker>>(std::move(newMarkers));
+    return copy;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "Audio/Graph/RoutingGraph.h"
+#include "Audio/Midi/MidiSequence.h"
+#include "Audio/Streaming/ClipStream.h"
+
+#include <memory>
+#include <vector>
+
+/** A named position on the timeline. */
+struct Marker
+{
+    juce::int64 position = 0; // Timeline samples
+    juce::String name;
+};
+
+/** One track's content, as the audio side sees it. Never changed once shared. */
+struct TrackSnapshot
+{
+    RoutingGraph::NodeID id = RoutingGraph::invalidID; // The track's node in the MixGraph
+    juce::String name;
+    std::vector<std::shared_ptr<ClipStream>> audioClips; // Fed from disk by the DiskStreamer
+    std::shared_ptr<const MidiSequence> midi;            // nullptr when the track has no MIDI
+};
+
+/**
+ * SessionSnapshot is one version of the session, as read by the audio thread.
+ *
+ * It is immutable. An edit on the message thread makes an edited copy with
+ * one of the with...() functions, and the copy shares everything the edit
+ * didn't touch with the version it came from: changing one track copies the
+ * list of track pointers but none of the other tracks, and a tempo change
+ * copies nothing but the root. A big edit (a session load, a batch of AI
+ * commands) chains as many with...() calls as it likes and is published once
+ * through SessionPublisher.
+ *
+ * Readers only ever follow pointers: nothing on the audio thread copies a
+ * snapshot or touches a reference count. ClipPlayer and MidiPlayer render
+ * each track's clips and MIDI straight from the snapshot for the block.
+ */
+class SessionSnapshot
+{
+public:
+    using NodeID = RoutingGraph::NodeID;
+    using TrackList = std::vector<std::shared_ptr<const TrackSnapshot>>;
+
+    // An empty session: no tracks, 120 bpm in 4/4
+    SessionSnapshot();
+
+    // Any thread holding the snapshot
+    juce::uint64 getVersion() const noexcept { return version; } // 0 until published
+    double getTempo() const noexcept { return tempo; }
+    int getTimeSignatureNumerator() const noexcept { return numerator; }
+    int getTimeSignatureDenominator() const noexcept { return denominator; }
+    const TrackList& getTracks() const noexcept { return *tracks; }
+    const TrackSnapshot* findTrack(NodeID id) const noexcept;
+    const std::vector<Marker>& getMarkers() const noexcept { return *markers; }
+
+    // Message thread: the track to edit (its content, or an empty track with that id)
+    TrackSnapshot copyTrack(NodeID id) const;
+
+    // Message thread: edited copies
+    SessionSnapshot withTempo(double bpm) const;
+    SessionSnapshot withTimeSignature(int newNumerator, int newDenominator) const;
+    SessionSnapshot withTrack(TrackSnapshot track) const; // Adds, or replaces the same id
+    SessionSnapshot withoutTrack(NodeID id) const;
+    SessionSnapshot withMarkers(std::vector<Marker> newMarkers) const;
+
+private:
+    friend class SessionPublisher;
+
+    juce::uint64 version = 0;
+    double tempo = 120.0;
+    int numerator = 4;
+    int denominator = 4;
+    std::shared_ptr<const TrackList> tracks;
+    std::shared_ptr<const std::vector<Marker>> markers;
+
+    JUCE_LEAK_DETECTOR(SessionSnapshot)
+};
@@ -0,0 +1,76 @@
+#include "StartupTrace.h"
+
+namespace
+{
+// Initialised with the rest of the engine's statics, before main() runs
+const double launchTime = juce::Time::getMillisecondCounterHiRes();
+} // namespace
+
+double StartupTrace::getLaunchTime()
+{
+    return launchTime;
+}
+
+StartupTrace::~StartupTrace()
+{
+    stopTimer();
+}
+
+void StartupTrace::mark(const juce::String& stageName)
+{
+    stages.push_back({stageName, juce::Time::getMillisecondCounterHiRes() - launchTime});
+}
+
+void StartupTrace::reportOnFirstCallback()
+{
+    startTimer(5);
+}
+
+void StartupTrace::audioCallbackStarted() noexcept
+{
+    if (firstCallback.load(std::memory_order_relaxed) < 0.0)
+    {
+        firstCallback.store(juce::Time::getMillisecondCounterHiRes() - launchTime,
+                            std::memory_order_relaxed);
+    }
+}
+
+double StartupTrace::getMsToFirstCallback() const
+{
+    return firstCallback.load(std::memory_order_relaxed);
+}
+
+juce::String StartupTrace::getReport() const
+{
+    auto report = juce::String("Startup:");
+    auto previous = 0.0;
+
+    // Each stage with its own duration, so the slow step stands out
+    for (const auto& stage : stages)
+    {
+        report << " " << stage.name << " +" << juce::String(stage.msSinceLaunch - previous, 1)
+               << " ms,";
+        previous = stage.msSinceLaunch;
+    }
+
+    auto total = getMsToFirstCallback();
+
+    if (total < 0.0)
+    {
+        return report + " no audio callback yet";
+    }
+
+    return report + " first callback +" + juce::String(total - previous, 1) + " ms (" +
+           juce::String(total, 1) + " ms since launch)";
+}
+
+void StartupTrace::timerCallback()
+{
+    if (getMsToFirstCallback() < 0.0)
+    {
+        return;
+    }
+
+    stopTimer();
+    juce::Logger::writeToLog(getReport());
+}
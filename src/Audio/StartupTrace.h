@@ -0,0 +1,52 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <atomic>
+#include <vector>
+
+/**
+ * StartupTrace times a cold start, from launch to the first audio callback.
+ *
+ * "Launch" is when the engine's code is loaded (static initialisation, before
+ * main), so the trace covers the app's own start-up as well as the engine's.
+ * The message thread marks each stage as it finishes; the audio thread only
+ * stores the time of its first callback, and a timer on the message thread
+ * notices it and writes the report to the log.
+ */
+class StartupTrace : private juce::Timer
+{
+public:
+    struct Stage
+    {
+        juce::String name;
+        double msSinceLaunch = 0.0;
+    };
+
+    StartupTrace() = default;
+    ~StartupTrace() override;
+
+    // Message thread
+    void mark(const juce::String& stageName);
+
+    // Waits (on the message thread) for the first callback, then logs the report
+    void reportOnFirstCallback();
+
+    // Audio thread
+    void audioCallbackStarted() noexcept;
+
+    // Message thread: -1 until the first callback has run
+    double getMsToFirstCallback() const;
+    const std::vector<Stage>& getStages() const { return stages; }
+    juce::String getReport() const;
+
+    static double getLaunchTime();
+
+private:
+    void timerCallback() override;
+
+    std::vector<Stage> stages;
+    std::atomic<double> firstCallback{-1.0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StartupTrace)
+};
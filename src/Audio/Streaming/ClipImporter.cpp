@@ -0,0 +1,90 @@
+#include "ClipImporter.h"
+
+ClipImporter::ClipImporter()
+{
+    formatManager.registerBasicFormats();
+}
+
+juce::Result ClipImporter::convert(const juce::File& source, const juce::File& destination,
+                                   double sampleRate, PolyphaseResampler::Quality quality)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(source));
+
+    if (reader == nullptr)
+    {
+        return juce::Result::fail("Could not read " + source.getFullPathName());
+    }
+
+    // Uncompressed files at the right rate are already what the streamer wants
+    auto isUncompressed = reader->getFormatName() == juce::WavAudioFormat().getFormatName() ||
+                          reader->getFormatName() == juce::AiffAudioFormat().getFormatName();
+
+    if (reader->sampleRate == sampleRate && isUncompressed)
+    {
+        return source.copyFileTo(destination)
+                   ? juce::Result::ok()
+                   : juce::Result::fail("Could not write " + destination.getFullPathName());
+    }
+
+    destination.deleteFile();
+    auto stream = destination.createOutputStream();
+
+    if (stream == nullptr)
+    {
+        return juce::Result::fail("Could not write " + destination.getFullPathName());
+    }
+
+    auto numChannels = static_cast<int>(reader->numChannels);
+    juce::WavAudioFormat wavFormat;
+    std::unique_ptr<juce::AudioFormatWriter> writer(wavFormat.createWriterFor(
+        stream.get(), sampleRate, static_cast<unsigned int>(numChannels), 32, {}, 0));
+
+    if (writer == nullptr)
+    {
+        return juce::Result::fail("Could not create WAV writer");
+    }
+
+    stream.release();
+
+    // Compressed files at the right rate only need decoding
+    if (reader->sampleRate == sampleRate)
+    {
+        return writer->writeFromAudioReader(*reader, 0, -1)
+                   ? juce::Result::ok()
+                   : juce::Result::fail("Could not write " + destination.getFullPathName());
+    }
+
+    PolyphaseResampler resampler;
+    resampler.prepare(numChannels, reader->sampleRate, sampleRate, quality, chunkSize);
+
+    juce::AudioBuffer<float> input(numChannels, resampler.getMaxInputSamples());
+    juce::AudioBuffer<float> output(numChannels, chunkSize);
+
+    auto totalSamples = static_cast<juce::int64>(
+        static_cast<double>(reader->lengthInSamples) * sampleRate / reader->sampleRate);
+    juce::int64 readPosition = 0;
+
+    for (juce::int64 position = 0; position < totalSamples; position += chunkSize)
+    {
+        auto numOutput = static_cast<int>(
+            juce::jmin(static_cast<juce::int64>(chunkSize), totalSamples - position));
+        auto numInput = resampler.getInputNeeded(numOutput);
+
+        // The filter reads a little past the end; the reader pads that with silence
+        if (numInput > 0)
+        {
+            reader->read(input.getArrayOfWritePointers(), numChannels, readPosition, numInput);
+            readPosition += numInput;
+        }
+
+        resampler.process(input.getArrayOfReadPointers(), numInput,
+                          output.getArrayOfWritePointers(), numOutput);
+
+        if (!writer->writeFromAudioSampleBuffer(output, 0, numOutput))
+        {
+            return juce::Result::fail("Could not write " + destination.getFullPathName());
+        }
+    }
+
+    return juce::Result::ok();
+}
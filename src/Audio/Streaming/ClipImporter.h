@@ -0,0 +1,32 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../DSP/PolyphaseResampler.h"
+
+/**
+ * ClipImporter brings an audio file into a session at the session's rate.
+ *
+ * WAV and AIFF files already at that rate are copied as they are; compressed
+ * ones (FLAC, Ogg, MP3) are decoded. Others are converted with the high
+ * quality resampler a chunk at a time. Both are written as 32-bit float WAV,
+ * so the result has the same length in time and nothing is clipped.
+ * Converting is optional: DiskStreamer also plays mismatched files by
+ * resampling them as it streams; importing trades disk space for the CPU.
+ */
+class ClipImporter
+{
+public:
+    ClipImporter();
+
+    // Blocks until done; run it off the message thread for long files
+    juce::Result convert(const juce::File& source, const juce::File& destination,
+                         double sampleRate,
+                         PolyphaseResampler::Quality quality = PolyphaseResampler::Quality::high);
+
+    static constexpr int chunkSize = 65536; // Output samples per channel per step
+
+private:
+    juce::AudioFormatManager formatManager;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ClipImporter)
+};
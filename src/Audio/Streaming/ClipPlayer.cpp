@@ -0,0 +1,72 @@
+#include "ClipPlayer.h"
+#include "../Session/SessionPublisher.h"
+#include "../Transport.h"
+#include "DiskStreamer.h"
+
+ClipPlayer::ClipPlayer(DiskStreamer& streamer, SessionPublisher& sessionPublisher,
+                       RoutingGraph::NodeID track, const Transport& playhead)
+    : diskStreamer(streamer), session(sessionPublisher), trackId(track), transport(playhead)
+{
+}
+
+ClipPlayer::~ClipPlayer() = default;
+
+juce::Result ClipPlayer::addClip(const AudioClip& clip)
+{
+    auto stream = diskStreamer.createStream(clip);
+
+    if (stream == nullptr)
+    {
+        return juce::Result::fail("Could not stream audio file: " + clip.file.getFullPathName());
+    }
+
+    const auto& latest = session.getLatest();
+    auto track = latest.copyTrack(trackId);
+    track.audioClips.push_back(std::move(stream));
+    session.publish(latest.withTrack(std::move(track)));
+    return juce::Result::ok();
+}
+
+void ClipPlayer::clearClips()
+{
+    // Streams only the replaced versions held are released as those versions are retired
+    const auto& latest = session.getLatest();
+    auto track = latest.copyTrack(trackId);
+    track.audioClips.clear();
+    session.publish(latest.withTrack(std::move(track)));
+}
+
+int ClipPlayer::getNumClips() const
+{
+    const auto* track = session.getLatest().findTrack(trackId);
+    return track != nullptr ? static_cast<int>(track->audioClips.size()) : 0;
+}
+
+void ClipPlayer::prepareToPlay(int, double) {}
+
+void ClipPlayer::releaseResources() {}
+
+void ClipPlayer::getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill)
+{
+    bufferToFill.clearActiveBufferRegion();
+
+    if (!transport.isBlockPlaying())
+    {
+        return;
+    }
+
+    const auto* track = session.get().findTrack(trackId);
+
+    if (track == nullptr)
+    {
+        return;
+    }
+
+    auto position = transport.getBlockPosition();
+
+    for (const auto& stream : track->audioClips)
+    {
+        stream->read(*bufferToFill.buffer, bufferToFill.startSample, position,
+                     bufferToFill.numSamples);
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../Graph/RoutingGraph.h"
+#include "ClipStream.h"
+
+class DiskStreamer;
+class SessionPublisher;
+class Transport;
+
+/**
+ * ClipPlayer plays a track's clips from disk at the transport position.
+ *
+ * Used as a Track's source. Each clip is a ClipStream fed by the DiskStreamer;
+ * rendering only copies samples already in the clips' rings, so it is safe on
+ * the audio thread and on pool workers. The clips themselves live in the
+ * session: edits publish a new SessionSnapshot, and each block renders the
+ * track's clips as they are in the snapshot for that block, so the player
+ * takes no locks and holds no list of its own.
+ */
+class ClipPlayer : public juce::AudioSource
+{
+public:
+    ClipPlayer(DiskStreamer& streamer, SessionPublisher& session, RoutingGraph::NodeID trackId,
+               const Transport& transport);
+    ~ClipPlayer() override;
+
+    // Message thread: each edit publishes a new session version
+    juce::Result addClip(const AudioClip& clip);
+    void clearClips();
+    int getNumClips() const;
+
+    // AudioSource interface
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo& bufferToFill) override;
+
+private:
+    DiskStreamer& diskStreamer;
+    SessionPublisher& session;
+    const RoutingGraph::NodeID trackId;
+    const Transport& transport;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ClipPlayer)
+};
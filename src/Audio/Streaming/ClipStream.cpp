@@ -0,0 +1,272 @@
+#include "ClipStream.h"
+
+#include <cmath>
+
+namespace
+{
+constexpr int maxStreamChannels = 8;
+}
+
+ClipStream::ClipStream(const AudioClip& audioClip,
+                       std::unique_ptr<juce::AudioFormatReader> formatReader, bool isMemoryMapped,
+                       double timelineRate, PolyphaseResampler::Quality quality)
+    : clip(audioClip), reader(std::move(formatReader)), memoryMapped(isMemoryMapped),
+      numChannels(juce::jlimit(1, maxStreamChannels, static_cast<int>(reader->numChannels))),
+      sourceRatio(reader->sampleRate > 0.0 && timelineRate > 0.0
+                      ? reader->sampleRate / timelineRate
+                      : 1.0)
+{
+    jassert(clip.length > 0);
+
+    if (sourceRatio != 1.0)
+    {
+        resampler = std::make_unique<PolyphaseResampler>();
+        resampler->prepare(numChannels, reader->sampleRate, timelineRate, quality,
+                           resampleBlockSize);
+        sourceBuffer.setSize(numChannels, resampler->getMaxInputSamples());
+    }
+}
+
+ClipStream::~ClipStream() = default;
+
+void ClipStream::read(juce::AudioBuffer<float>& buffer, int startSample, juce::int64 position,
+                      int numSamples) noexcept
+{
+    auto start = juce::jmax(position, clip.timelineStart);
+    auto end = juce::jmin(position + numSamples, getTimelineEnd());
+
+    if (start >= end)
+    {
+        return;
+    }
+
+    const juce::SpinLock::ScopedTryLockType sl(lock);
+
+    if (!sl.isLocked() || fifo == nullptr)
+    {
+        underruns.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (start != readPosition)
+    {
+        // The playhead moved on (e.g. a partial block last time): drop what it skipped
+        auto skip = start - readPosition;
+
+        if (skip < 0 || skip > fifo->getNumReady())
+        {
+            underruns.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        fifo->finishedRead(static_cast<int>(skip));
+        readPosition = start;
+    }
+
+    auto needed = static_cast<int>(end - start);
+    auto numToRead = juce::jmin(needed, fifo->getNumReady());
+
+    if (numToRead < needed)
+    {
+        underruns.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (numToRead <= 0)
+    {
+        return;
+    }
+
+    auto destStart = startSample + static_cast<int>(start - position);
+    const auto scope = fifo->read(numToRead);
+
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        // Mono clips play on every channel
+        auto sourceChannel = juce::jmin(channel, numChannels - 1);
+
+        if (scope.blockSize1 > 0)
+        {
+            buffer.addFrom(channel, destStart, ring, sourceChannel, scope.startIndex1,
+                           scope.blockSize1);
+        }
+
+        if (scope.blockSize2 > 0)
+        {
+            buffer.addFrom(channel, destStart + scope.blockSize1, ring, sourceChannel,
+                           scope.startIndex2, scope.blockSize2);
+        }
+    }
+
+    readPosition += numToRead;
+}
+
+void ClipStream::activate(juce::int64 startPosition, juce::int64 lookahead)
+{
+    // Allocated outside the lock; the audio thread isn't reading this clip yet
+    auto capacity = static_cast<int>(lookahead) + 1;
+    auto newFifo = std::make_unique<juce::AbstractFifo>(capacity);
+    juce::AudioBuffer<float> newRing(numChannels, capacity);
+
+    {
+        const juce::SpinLock::ScopedLockType sl(lock);
+        fifo = std::move(newFifo);
+        std::swap(ring, newRing);
+        readPosition = startPosition;
+    }
+
+    writePosition = startPosition;
+    sourceReadPosition = getSourcePosition(startPosition);
+
+    if (resampler != nullptr)
+    {
+        resampler->reset();
+    }
+
+    active.store(true);
+}
+
+void ClipStream::deactivate()
+{
+    std::unique_ptr<juce::AbstractFifo> oldFifo;
+    juce::AudioBuffer<float> oldRing;
+
+    {
+        const juce::SpinLock::ScopedLockType sl(lock);
+        std::swap(fifo, oldFifo);
+        std::swap(ring, oldRing);
+    }
+
+    active.store(false);
+}
+
+void ClipStream::reposition(juce::int64 startPosition)
+{
+    const juce::SpinLock::ScopedLockType sl(lock);
+    fifo->reset();
+    readPosition = startPosition;
+    writePosition = startPosition;
+    sourceReadPosition = getSourcePosition(startPosition);
+
+    if (resampler != nullptr)
+    {
+        resampler->reset();
+    }
+}
+
+juce::int64 ClipStream::getSourcePosition(juce::int64 timelinePosition) const
+{
+    auto offset = static_cast<double>(timelinePosition - clip.timelineStart) * sourceRatio;
+    return clip.sourceOffset + static_cast<juce::int64>(std::llround(offset));
+}
+
+void ClipStream::readResampled(int ringStart, int count)
+{
+    float* sources[maxStreamChannels] = {};
+    float* destinations[maxStreamChannels] = {};
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        sources[channel] = sourceBuffer.getWritePointer(channel);
+    }
+
+    while (count > 0)
+    {
+        auto numOutput = juce::jmin(count, resampleBlockSize);
+        auto numInput = resampler->getInputNeeded(numOutput);
+
+        // Reads past the end of the file come back as silence
+        if (numInput > 0)
+        {
+            reader->read(sources, numChannels, sourceReadPosition, numInput);
+            sourceReadPosition += numInput;
+        }
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            destinations[channel] = ring.getWritePointer(channel, ringStart);
+        }
+
+        resampler->process(sources, numInput, destinations, numOutput);
+        ringStart += numOutput;
+        count -= numOutput;
+    }
+}
+
+bool ClipStream::service(juce::int64 playhead, juce::uint32 seekGeneration,
+                         juce::int64 lookahead, int chunkSize)
+{
+    auto windowEnd = playhead + lookahead;
+    auto inWindow = clip.timelineStart < windowEnd && getTimelineEnd() > playhead;
+
+    if (!inWindow)
+    {
+        if (fifo != nullptr)
+        {
+            deactivate();
+        }
+
+        lastSeekGeneration = seekGeneration;
+        return false;
+    }
+
+    auto startPosition = juce::jmax(playhead, clip.timelineStart);
+
+    if (fifo == nullptr)
+    {
+        activate(startPosition, lookahead);
+    }
+    else if (seekGeneration != lastSeekGeneration || writePosition < playhead)
+    {
+        // Seek, or the ring fell behind the playhead: start again from the playhead
+        reposition(startPosition);
+    }
+
+    lastSeekGeneration = seekGeneration;
+
+    auto fillEnd = juce::jmin(windowEnd, getTimelineEnd());
+    auto numToWrite = static_cast<int>(
+        juce::jmin(static_cast<juce::int64>(fifo->getFreeSpace()), fillEnd - writePosition));
+    numToWrite = juce::jmin(numToWrite, chunkSize);
+
+    if (numToWrite <= 0)
+    {
+        return false;
+    }
+
+    const auto scope = fifo->write(numToWrite);
+
+    if (resampler != nullptr)
+    {
+        readResampled(scope.startIndex1, scope.blockSize1);
+        readResampled(scope.startIndex2, scope.blockSize2);
+        writePosition += numToWrite;
+        return numToWrite == chunkSize;
+    }
+
+    // Straight from the file (or its mapped pages) into the ring, no intermediate copy
+    auto sourcePosition = clip.sourceOffset + (writePosition - clip.timelineStart);
+    float* destinations[maxStreamChannels] = {};
+
+    auto readBlock = [&](int ringStart, int count, juce::int64 fileStart)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            destinations[channel] = ring.getWritePointer(channel, ringStart);
+        }
+
+        reader->read(destinations, numChannels, fileStart, count);
+    };
+
+    if (scope.blockSize1 > 0)
+    {
+        readBlock(scope.startIndex1, scope.blockSize1, sourcePosition);
+    }
+
+    if (scope.blockSize2 > 0)
+    {
+        readBlock(scope.startIndex2, scope.blockSize2, sourcePosition + scope.blockSize1);
+    }
+
+    writePosition += numToWrite;
+    return numToWrite == chunkSize;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../DSP/PolyphaseResampler.h"
+
+#include <atomic>
+#include <memory>
+
+/**
+ * AudioClip is a region of an audio file placed on the timeline (in samples).
+ */
+struct AudioClip
+{
+    juce::File file;
+    juce::int64 timelineStart = 0; // Where the clip starts on the timeline
+    juce::int64 sourceOffset = 0;  // First sample used from the file, at the file's rate
+    juce::int64 length = 0;        // Timeline samples; 0 means "to the end of the file"
+};
+
+/**
+ * ClipStream streams one clip from disk through a lock-free ring buffer.
+ *
+ * The I/O thread (DiskStreamer) calls service() with the playhead: once the
+ * clip comes within the look-ahead window it allocates a ring and keeps it
+ * filled ahead of the playhead, repositions after seeks, and frees the ring
+ * again when the clip is behind the playhead. The audio thread only ever
+ * copies samples that are already in the ring; anything missing is played as
+ * silence and counted as an underrun.
+ *
+ * Ring allocation and repositioning swap state under a spin lock that the
+ * audio thread only try-locks, so the audio thread never waits for the disk.
+ *
+ * A file at another sample rate than the timeline is converted on the I/O
+ * thread as it fills the ring (see PolyphaseResampler), so the ring and the
+ * audio thread always work at the timeline rate.
+ */
+class ClipStream
+{
+public:
+    ClipStream(const AudioClip& clip, std::unique_ptr<juce::AudioFormatReader> reader,
+               bool isMemoryMapped, double timelineRate,
+               PolyphaseResampler::Quality quality = PolyphaseResampler::Quality::standard);
+    ~ClipStream();
+
+    const AudioClip& getClip() const { return clip; }
+    juce::int64 getTimelineEnd() const { return clip.timelineStart + clip.length; }
+    int getNumChannels() const { return numChannels; }
+    bool isMemoryMapped() const { return memoryMapped; }
+    bool isResampled() const { return resampler != nullptr; }
+
+    // Audio thread: adds the clip's audio for timeline [position, position + numSamples)
+    // into the buffer at startSample. Regions outside the clip are left untouched.
+    void read(juce::AudioBuffer<float>& buffer, int startSample, juce::int64 position,
+              int numSamples) noexcept;
+
+    // I/O thread: returns true if the ring still has room to fill within the window
+    bool service(juce::int64 playhead, juce::uint32 seekGeneration, juce::int64 lookahead,
+                 int chunkSize);
+
+    bool isActive() const { return active.load(); }
+    juce::int64 getUnderruns() const { return underruns.load(); }
+
+    static constexpr int resampleBlockSize = 4096; // Output samples per conversion step
+
+private:
+    void activate(juce::int64 startPosition, juce::int64 lookahead);
+    void deactivate();
+    void reposition(juce::int64 startPosition);
+
+    // File position of a timeline position inside the clip
+    juce::int64 getSourcePosition(juce::int64 timelinePosition) const;
+
+    // I/O thread: converts count timeline samples into the ring at ringStart
+    void readResampled(int ringStart, int count);
+
+    const AudioClip clip;
+    const std::unique_ptr<juce::AudioFormatReader> reader;
+    const bool memoryMapped;
+    const int numChannels;
+    const double sourceRatio; // File samples per timeline sample
+
+    // Ring state, swapped by the I/O thread under the lock
+    juce::SpinLock lock;
+    std::unique_ptr<juce::AbstractFifo> fifo;
+    juce::AudioBuffer<float> ring;
+    juce::int64 readPosition = 0; // Timeline position of the next sample in the ring
+
+    // I/O thread only
+    juce::int64 writePosition = 0; // Timeline position of the next sample to load
+    juce::uint32 lastSeekGeneration = 0;
+
+    // I/O thread only, and only when the file's rate differs from the timeline's
+    std::unique_ptr<PolyphaseResampler> resampler;
+    juce::AudioBuffer<float> sourceBuffer;
+    juce::int64 sourceReadPosition = 0; // Next file sample to feed the resampler
+
+    std::atomic<bool> active{false};
+    std::atomic<juce::int64> underruns{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ClipStream)
+};
@@ -0,0 +1,173 @@
+#include "DiskStreamer.h"
+#include "../Transport.h"
+
+DiskStreamer::DiskStreamer(Transport& playhead) : juce::Thread("DAIW Disk I/O"), transport(playhead)
+{
+    formatManager.registerBasicFormats();
+}
+
+DiskStreamer::~DiskStreamer()
+{
+    stop();
+}
+
+void DiskStreamer::prepare(double sampleRate)
+{
+    lookahead.store(static_cast<juce::int64>(sampleRate * lookaheadSeconds));
+    timelineRate.store(sampleRate);
+}
+
+void DiskStreamer::start()
+{
+    startThread(juce::Thread::Priority::high);
+}
+
+void DiskStreamer::stop()
+{
+    stopThread(2000);
+}
+
+std::shared_ptr<ClipStream> DiskStreamer::createStream(const AudioClip& clip)
+{
+    auto* format = formatManager.findFormatForFileExtension(clip.file.getFileExtension());
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    auto isMemoryMapped = false;
+
+    // Uncompressed formats are mapped; the I/O thread then faults pages in as it converts
+    if (format != nullptr)
+    {
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(
+            format->createMemoryMappedReader(clip.file));
+
+        if (mapped != nullptr && mapped->mapEntireFile())
+        {
+            reader = std::move(mapped);
+            isMemoryMapped = true;
+        }
+    }
+
+    if (reader == nullptr)
+    {
+        reader.reset(formatManager.createReaderFor(clip.file));
+    }
+
+    if (reader == nullptr)
+    {
+        DBG("DiskStreamer: Could not open " + clip.file.getFullPathName());
+        return nullptr;
+    }
+
+    // What is left of the file after the offset, in timeline samples
+    auto rate = timelineRate.load();
+    auto available = reader->lengthInSamples - clip.sourceOffset;
+
+    if (reader->sampleRate > 0.0 && reader->sampleRate != rate)
+    {
+        available = static_cast<juce::int64>(static_cast<double>(available) * rate /
+                                             reader->sampleRate);
+    }
+
+    auto resolved = clip;
+    resolved.length = clip.length > 0 ? juce::jmin(clip.length, available) : available;
+
+    if (resolved.length <= 0)
+    {
+        return nullptr;
+    }
+
+    auto stream = std::make_shared<ClipStream>(resolved, std::move(reader), isMemoryMapped, rate,
+                                               resamplerQuality.load());
+
+    {
+        const juce::ScopedLock sl(lock);
+        streams.push_back(stream);
+    }
+
+    notify();
+    return stream;
+}
+
+void DiskStreamer::serviceStreams()
+{
+    while (servicePass())
+    {
+    }
+}
+
+bool DiskStreamer::servicePass()
+{
+    // Serialises the I/O thread and serviceStreams(); the list lock is only held to copy it
+    const juce::ScopedLock serviceScope(serviceLock);
+
+    {
+        const juce::ScopedLock sl(lock);
+
+        // Drop clips nobody plays any more
+        for (auto it = streams.begin(); it != streams.end();)
+        {
+            if (it->use_count() == 1)
+            {
+                retiredUnderruns += (*it)->getUnderruns();
+                it = streams.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        servicing = streams;
+    }
+
+    // Generation first: a new generation guarantees the position after the seek
+    auto generation = transport.getSeekGeneration();
+    auto playhead = transport.getPosition();
+    auto window = lookahead.load();
+    auto moreToDo = false;
+
+    for (auto& stream : servicing)
+    {
+        moreToDo = stream->service(playhead, generation, window, chunkSize) || moreToDo;
+    }
+
+    servicing.clear();
+    return moreToDo;
+}
+
+void DiskStreamer::run()
+{
+    while (!threadShouldExit())
+    {
+        if (!servicePass())
+        {
+            // Everything is topped up; the playhead moves ~5 ms worth before the next look
+            wait(5);
+        }
+    }
+}
+
+juce::int64 DiskStreamer::getUnderrunCount() const
+{
+    const juce::ScopedLock sl(lock);
+    auto total = retiredUnderruns.load();
+
+    for (const auto& stream : streams)
+    {
+        total += stream->getUnderruns();
+    }
+
+    return total;
+}
+
+int DiskStreamer::getNumActiveStreams() const
+{
+    const juce::ScopedLock sl(lock);
+    int numActive = 0;
+
+    for (const auto& stream : streams)
+    {
+        numActive += stream->isActive() ? 1 : 0;
+    }
+
+    return numActive;
+}
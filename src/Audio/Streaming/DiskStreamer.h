@@ -0,0 +1,80 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "ClipStream.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class Transport;
+
+/**
+ * DiskStreamer runs the background I/O thread that feeds every ClipStream.
+ *
+ * Each pass it reads the transport's playhead and tops up the ring of every
+ * clip inside the look-ahead window, one chunk per clip at a time so no clip
+ * starves while another reads a long stretch. Uncompressed WAV and AIFF files
+ * are memory mapped, so the I/O thread converts straight from the mapped pages
+ * into the ring; other formats go through a regular reader. Files at another
+ * rate than the one prepared are resampled on the way into the ring.
+ *
+ * Streams are shared with the session snapshots that hold them (see
+ * ClipPlayer) and are dropped here once nothing else holds them. In offline
+ * mode the thread isn't started and the engine calls serviceStreams() before
+ * each block instead, so renders never underrun.
+ */
+class DiskStreamer : private juce::Thread
+{
+public:
+    explicit DiskStreamer(Transport& transport);
+    ~DiskStreamer() override;
+
+    // Look-ahead is sized from the sample rate, which is also the rate streams created
+    // from now on play at (call while audio is stopped)
+    void prepare(double sampleRate);
+
+    // For streams created from now on (standard by default; offline renders use high)
+    void setResamplerQuality(PolyphaseResampler::Quality quality) { resamplerQuality = quality; }
+
+    // Background I/O thread
+    void start();
+    void stop();
+
+    // Message thread: opens the clip's file; nullptr if it can't be read.
+    // A clip length of 0 plays to the end of the file.
+    std::shared_ptr<ClipStream> createStream(const AudioClip& clip);
+
+    // Fills every stream up to the look-ahead window before returning
+    void serviceStreams();
+
+    // Any thread: blocks where a clip had no data ready, across all streams so far
+    juce::int64 getUnderrunCount() const;
+    int getNumActiveStreams() const;
+
+    static constexpr double lookaheadSeconds = 2.0;
+    static constexpr int chunkSize = 16384;
+
+private:
+    void run() override;
+
+    // Returns true if any stream still has room to fill
+    bool servicePass();
+
+    Transport& transport;
+    juce::AudioFormatManager formatManager;
+
+    juce::CriticalSection lock; // Guards the stream list
+    std::vector<std::shared_ptr<ClipStream>> streams;
+
+    juce::CriticalSection serviceLock;
+    std::vector<std::shared_ptr<ClipStream>> servicing; // Copy used for one pass
+
+    std::atomic<juce::int64> lookahead{static_cast<juce::int64>(48000 * lookaheadSeconds)};
+    std::atomic<double> timelineRate{48000.0};
+    std::atomic<PolyphaseResampler::Quality> resamplerQuality{
+        PolyphaseResampler::Quality::standard};
+    std::atomic<juce::int64> retiredUnderruns{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DiskStreamer)
+};
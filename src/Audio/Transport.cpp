@@ -0,0 +1,28 @@
+#include "Transport.h"
+
+Transport::Transport() = default;
+
+void Transport::advance(int numSamples) noexcept
+{
+    auto seek = pendingSeek.exchange(-1);
+
+    if (seek >= 0)
+    {
+        nextPosition = seek;
+    }
+
+    blockPlaying = playing.load();
+    blockPosition = nextPosition;
+    position.store(blockPosition, std::memory_order_release);
+
+    // Published after the position so a reader seeing the new generation sees the new position
+    if (seek >= 0)
+    {
+        seekGeneration.fetch_add(1, std::memory_order_release);
+    }
+
+    if (blockPlaying)
+    {
+        nextPosition += numSamples;
+    }
+}
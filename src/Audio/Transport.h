@@ -0,0 +1,56 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <atomic>
+
+/**
+ * Transport holds the playhead.
+ *
+ * The message thread requests play, stop and seeks; the audio thread applies
+ * them at the start of each block in advance(), so every node processing that
+ * block (on any pool thread) sees the same position. Each applied seek bumps a
+ * generation counter that background readers such as DiskStreamer use to
+ * notice discontinuities.
+ */
+class Transport
+{
+public:
+    Transport();
+
+    // Message thread
+    void play() { playing.store(true); }
+    void stop() { playing.store(false); }
+    void setPosition(juce::int64 samplePosition)
+    {
+        pendingSeek.store(juce::jmax(static_cast<juce::int64>(0), samplePosition));
+    }
+
+    // Any thread: start of the most recent block, and how many seeks have been applied
+    bool isPlaying() const { return playing.load(); }
+    juce::int64 getPosition() const { return position.load(std::memory_order_acquire); }
+    juce::uint32 getSeekGeneration() const
+    {
+        return seekGeneration.load(std::memory_order_acquire);
+    }
+
+    // Audio thread: applies pending requests and moves to the next block
+    void advance(int numSamples) noexcept;
+
+    // Audio thread and pool workers, valid for the block being processed
+    juce::int64 getBlockPosition() const noexcept { return blockPosition; }
+    bool isBlockPlaying() const noexcept { return blockPlaying; }
+
+private:
+    std::atomic<bool> playing{false};
+    std::atomic<juce::int64> pendingSeek{-1};
+    std::atomic<juce::int64> position{0};
+    std::atomic<juce::uint32> seekGeneration{0};
+
+    // Audio thread only
+    juce::int64 nextPosition = 0;
+    juce::int64 blockPosition = 0;
+    bool blockPlaying = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Transport)
+};
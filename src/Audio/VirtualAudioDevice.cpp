@@ -0,0 +1,297 @@
+#include "VirtualAudioDevice.h"
+
+//==============================================================================
+// VirtualAudioIODeviceType
+//==============================================================================
+
+const juce::String VirtualAudioIODeviceType::typeName = "Virtual";
+const juce::String VirtualAudioIODeviceType::deviceName = "DAIW Virtual Device";
+
+VirtualAudioIODeviceType::Options VirtualAudioIODeviceType::Options::fromEnvironment()
+{
+    Options result;
+    result.jitterMs = juce::SystemStats::getEnvironmentVariable("DAIW_VIRTUAL_JITTER_MS", "0")
+                          .getDoubleValue();
+    result.xrunProbability =
+        juce::SystemStats::getEnvironmentVariable("DAIW_VIRTUAL_XRUN_PROBABILITY", "0")
+            .getDoubleValue();
+    result.loopback =
+        juce::SystemStats::getEnvironmentVariable("DAIW_VIRTUAL_LOOPBACK", "1").getIntValue() != 0;
+    return result;
+}
+
+VirtualAudioIODeviceType::VirtualAudioIODeviceType() : VirtualAudioIODeviceType(Options())
+{
+}
+
+VirtualAudioIODeviceType::VirtualAudioIODeviceType(const Options& deviceOptions)
+    : juce::AudioIODeviceType(typeName), options(deviceOptions)
+{
+}
+
+juce::StringArray VirtualAudioIODeviceType::getDeviceNames(bool /*wantInputNames*/) const
+{
+    return {deviceName};
+}
+
+int VirtualAudioIODeviceType::getDefaultDeviceIndex(bool /*forInput*/) const
+{
+    return 0;
+}
+
+int VirtualAudioIODeviceType::getIndexOfDevice(juce::AudioIODevice* device, bool /*asInput*/) const
+{
+    return dynamic_cast<VirtualAudioIODevice*>(device) != nullptr ? 0 : -1;
+}
+
+juce::AudioIODevice* VirtualAudioIODeviceType::createDevice(const juce::String& outputDeviceName,
+                                                            const juce::String& inputDeviceName)
+{
+    if (outputDeviceName == deviceName || inputDeviceName == deviceName)
+    {
+        return new VirtualAudioIODevice(deviceName, options);
+    }
+
+    return nullptr;
+}
+
+//==============================================================================
+// VirtualAudioIODevice
+//==============================================================================
+
+VirtualAudioIODevice::VirtualAudioIODevice(const juce::String& name,
+                                           const VirtualAudioIODeviceType::Options& deviceOptions)
+    : juce::AudioIODevice(name, VirtualAudioIODeviceType::typeName),
+      juce::Thread("DAIW Virtual Audio"), options(deviceOptions)
+{
+}
+
+VirtualAudioIODevice::~VirtualAudioIODevice()
+{
+    close();
+}
+
+juce::StringArray VirtualAudioIODevice::getOutputChannelNames()
+{
+    juce::StringArray names;
+    for (int i = 0; i < options.numOutputChannels; ++i)
+    {
+        names.add("Virtual Out " + juce::String(i + 1));
+    }
+    return names;
+}
+
+juce::StringArray VirtualAudioIODevice::getInputChannelNames()
+{
+    juce::StringArray names;
+    for (int i = 0; i < options.numInputChannels; ++i)
+    {
+        names.add("Virtual In " + juce::String(i + 1));
+    }
+    return names;
+}
+
+juce::String VirtualAudioIODevice::open(const juce::BigInteger& inputChannels,
+                                        const juce::BigInteger& outputChannels, double sampleRate,
+                                        int bufferSizeSamples)
+{
+    close();
+    lastError.clear();
+
+    if (!options.sampleRates.contains(sampleRate))
+    {
+        sampleRate = options.sampleRates.contains(48000.0) ? 48000.0
+                                                           : options.sampleRates.getFirst();
+    }
+
+    if (!options.bufferSizes.contains(bufferSizeSamples))
+    {
+        bufferSizeSamples = options.defaultBufferSize;
+    }
+
+    currentSampleRate = sampleRate;
+    currentBufferSize = bufferSizeSamples;
+
+    // Only channels the device actually has can be active
+    auto limitChannels = [](juce::BigInteger channels, int numAvailable)
+    {
+        auto numBits = channels.getHighestBit() + 1 - numAvailable;
+        if (numBits > 0)
+        {
+            channels.setRange(numAvailable, numBits, false);
+        }
+        return channels;
+    };
+
+    activeInputChannels = limitChannels(inputChannels, options.numInputChannels);
+    activeOutputChannels = limitChannels(outputChannels, options.numOutputChannels);
+
+    auto numInputs = activeInputChannels.countNumberOfSetBits();
+    auto numOutputs = activeOutputChannels.countNumberOfSetBits();
+
+    // Everything the callback thread touches is allocated here
+    inputBuffer.setSize(juce::jmax(1, numInputs), currentBufferSize);
+    outputBuffer.setSize(juce::jmax(1, numOutputs), currentBufferSize);
+    inputBuffer.clear();
+    outputBuffer.clear();
+
+    inputPointers.clearQuick();
+    for (int i = 0; i < numInputs; ++i)
+    {
+        inputPointers.add(inputBuffer.getReadPointer(i));
+    }
+
+    outputPointers.clearQuick();
+    for (int i = 0; i < numOutputs; ++i)
+    {
+        outputPointers.add(outputBuffer.getWritePointer(i));
+    }
+
+    deviceOpen = true;
+    return {};
+}
+
+void VirtualAudioIODevice::close()
+{
+    stop();
+    deviceOpen = false;
+}
+
+void VirtualAudioIODevice::start(juce::AudioIODeviceCallback* callback)
+{
+    if (!deviceOpen || callback == nullptr)
+    {
+        return;
+    }
+
+    stop();
+    callback->audioDeviceAboutToStart(this);
+
+    {
+        const juce::ScopedLock sl(callbackLock);
+        currentCallback = callback;
+    }
+
+    auto periodMs = 1000.0 * currentBufferSize / currentSampleRate;
+
+    if (!startRealtimeThread(juce::Thread::RealtimeOptions().withPeriodMs(periodMs)))
+    {
+        // Real-time scheduling usually needs extra privileges on Linux
+        startThread(juce::Thread::Priority::highest);
+    }
+}
+
+void VirtualAudioIODevice::stop()
+{
+    stopThread(2000);
+
+    juce::AudioIODeviceCallback* lastCallback = nullptr;
+
+    {
+        const juce::ScopedLock sl(callbackLock);
+        std::swap(lastCallback, currentCallback);
+    }
+
+    if (lastCallback != nullptr)
+    {
+        lastCallback->audioDeviceStopped();
+    }
+}
+
+void VirtualAudioIODevice::waitUntil(juce::int64 targetTicks)
+{
+    auto ticksPerMs = static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()) / 1000.0;
+
+    for (;;)
+    {
+        auto remainingMs =
+            static_cast<double>(targetTicks - juce::Time::getHighResolutionTicks()) / ticksPerMs;
+
+        if (remainingMs <= 0.0 || threadShouldExit())
+        {
+            return;
+        }
+
+        // Sleep for the bulk of the wait, then yield for the last millisecond
+        if (remainingMs > 1.5)
+        {
+            wait(remainingMs - 1.0);
+        }
+        else
+        {
+            juce::Thread::yield();
+        }
+    }
+}
+
+void VirtualAudioIODevice::processBlock()
+{
+    auto numInputs = inputPointers.size();
+    auto numOutputs = outputPointers.size();
+
+    // Loopback: last block's output becomes this block's input
+    for (int i = 0; i < numInputs; ++i)
+    {
+        if (options.loopback && i < numOutputs)
+        {
+            inputBuffer.copyFrom(i, 0, outputBuffer, i, 0, currentBufferSize);
+        }
+        else
+        {
+            inputBuffer.clear(i, 0, currentBufferSize);
+        }
+    }
+
+    outputBuffer.clear();
+
+    const juce::ScopedLock sl(callbackLock);
+
+    if (currentCallback != nullptr)
+    {
+        currentCallback->audioDeviceIOCallbackWithContext(
+            inputPointers.getRawDataPointer(), numInputs, outputPointers.getRawDataPointer(),
+            numOutputs, currentBufferSize, {});
+    }
+}
+
+void VirtualAudioIODevice::run()
+{
+    const auto ticksPerSecond = static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+    const auto periodTicks =
+        static_cast<juce::int64>(ticksPerSecond * currentBufferSize / currentSampleRate);
+    const auto maxJitterTicks = static_cast<juce::int64>(ticksPerSecond * options.jitterMs / 1000.0);
+
+    auto nextDeadline = juce::Time::getHighResolutionTicks() + periodTicks;
+
+    while (!threadShouldExit())
+    {
+        auto jitter = maxJitterTicks > 0
+                          ? static_cast<juce::int64>(random.nextDouble() * maxJitterTicks)
+                          : 0;
+        waitUntil(nextDeadline + jitter);
+
+        if (threadShouldExit())
+        {
+            break;
+        }
+
+        // Simulated xrun: the whole period is dropped, as if the driver missed it
+        if (options.xrunProbability > 0.0 && random.nextDouble() < options.xrunProbability)
+        {
+            ++xruns;
+            nextDeadline += periodTicks;
+            continue;
+        }
+
+        processBlock();
+        nextDeadline += periodTicks;
+
+        // Genuinely fell behind by more than a period: resync rather than burst
+        auto now = juce::Time::getHighResolutionTicks();
+        if (now > nextDeadline + periodTicks)
+        {
+            ++xruns;
+            nextDeadline = now + periodTicks;
+        }
+    }
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+ * VirtualAudioIODeviceType is an audio device type with no hardware behind it.
+ *
+ * Its single device runs a real-time thread that calls back once per buffer
+ * period like a real driver, with optional wake-up jitter and simulated xruns,
+ * and can loop its output back to its input one block later. It lets the full
+ * AudioDeviceManager path run in containers and on headless Linux boxes.
+ *
+ * Options can also come from the environment:
+ *   DAIW_VIRTUAL_JITTER_MS        maximum random wake-up delay per callback
+ *   DAIW_VIRTUAL_XRUN_PROBABILITY chance (0-1) of dropping each period
+ *   DAIW_VIRTUAL_LOOPBACK         0 to disable output -> input loopback
+ */
+class VirtualAudioIODeviceType : public juce::AudioIODeviceType
+{
+public:
+    struct Options
+    {
+        juce::Array<double> sampleRates{44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0};
+        juce::Array<int> bufferSizes{16, 32, 64, 128, 256, 512, 1024, 2048, 4096};
+        int defaultBufferSize = 256;
+        int numInputChannels = 2;
+        int numOutputChannels = 2;
+
+        double jitterMs = 0.0;        // Maximum random delay added to each wake-up
+        double xrunProbability = 0.0; // Chance of skipping a whole period
+        bool loopback = true;         // Output is fed back to the input one block later
+
+        static Options fromEnvironment();
+    };
+
+    static const juce::String typeName;
+    static const juce::String deviceName;
+
+    VirtualAudioIODeviceType();
+    explicit VirtualAudioIODeviceType(const Options& options);
+
+    void scanForDevices() override {}
+    juce::StringArray getDeviceNames(bool wantInputNames = false) const override;
+    int getDefaultDeviceIndex(bool forInput) const override;
+    int getIndexOfDevice(juce::AudioIODevice* device, bool asInput) const override;
+    bool hasSeparateInputsAndOutputs() const override { return false; }
+    juce::AudioIODevice* createDevice(const juce::String& outputDeviceName,
+                                      const juce::String& inputDeviceName) override;
+
+private:
+    const Options options;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VirtualAudioIODeviceType)
+};
+
+/**
+ * VirtualAudioIODevice is the device created by VirtualAudioIODeviceType.
+ */
+class VirtualAudioIODevice : public juce::AudioIODevice, private juce::Thread
+{
+public:
+    VirtualAudioIODevice(const juce::String& name, const VirtualAudioIODeviceType::Options& options);
+    ~VirtualAudioIODevice() override;
+
+    juce::StringArray getOutputChannelNames() override;
+    juce::StringArray getInputChannelNames() override;
+    juce::Array<double> getAvailableSampleRates() override { return options.sampleRates; }
+    juce::Array<int> getAvailableBufferSizes() override { return options.bufferSizes; }
+    int getDefaultBufferSize() override { return options.defaultBufferSize; }
+
+    juce::String open(const juce::BigInteger& inputChannels, const juce::BigInteger& outputChannels,
+                      double sampleRate, int bufferSizeSamples) override;
+    void close() override;
+    bool isOpen() override { return deviceOpen; }
+
+    void start(juce::AudioIODeviceCallback* callback) override;
+    void stop() override;
+    bool isPlaying() override { return currentCallback != nullptr; }
+
+    juce::String getLastError() override { return lastError; }
+    int getCurrentBufferSizeSamples() override { return currentBufferSize; }
+    double getCurrentSampleRate() override { return currentSampleRate; }
+    int getCurrentBitDepth() override { return 32; }
+
+    juce::BigInteger getActiveOutputChannels() const override { return activeOutputChannels; }
+    juce::BigInteger getActiveInputChannels() const override { return activeInputChannels; }
+
+    // Loopback delivers output back to the input one block later
+    int getOutputLatencyInSamples() override { return options.loopback ? currentBufferSize : 0; }
+    int getInputLatencyInSamples() override { return 0; }
+
+    int getXRunCount() const noexcept override { return xruns.load(); }
+
+private:
+    void run() override;
+    void waitUntil(juce::int64 targetTicks);
+    void processBlock();
+
+    const VirtualAudioIODeviceType::Options options;
+
+    bool deviceOpen = false;
+    juce::String lastError;
+    double currentSampleRate = 0.0;
+    int currentBufferSize = 0;
+    juce::BigInteger activeInputChannels;
+    juce::BigInteger activeOutputChannels;
+
+    // Preallocated in open()
+    juce::AudioBuffer<float> inputBuffer;
+    juce::AudioBuffer<float> outputBuffer;
+    juce::Array<const float*> inputPointers;
+    juce::Array<float*> outputPointers;
+
+    juce::CriticalSection callbackLock;
+    juce::AudioIODeviceCallback* currentCallback = nullptr;
+
+    juce::Random random;
+    std::atomic<int> xruns{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VirtualAudioIODevice)
+};
@@ -0,0 +1,178 @@
+#include "PeakCache.h"
+
+#include <cstring>
+
+namespace
+{
+constexpr char cacheMagic[8] = {'D', 'A', 'I', 'W', 'P', 'E', 'A', 'K'};
+} // namespace
+
+PeakCache::PeakCache(std::unique_ptr<juce::MemoryMappedFile> file,
+                     const PeakPyramid::View& levels, double rate)
+    : mappedFile(std::move(file)), view(levels), sampleRate(rate)
+{
+}
+
+juce::File PeakCache::getCacheFile(const juce::File& sourceFile)
+{
+    return sourceFile.getSiblingFile(sourceFile.getFileName() + ".peaks");
+}
+
+juce::File PeakCache::getFallbackCacheFile(const juce::File& sourceFile)
+{
+    // Named after the whole path, so same-named files in different folders don't collide
+    auto hash = juce::String::toHexString(sourceFile.getFullPathName().hashCode64());
+
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("DAIW")
+        .getChildFile("Peaks")
+        .getChildFile(hash + "-" + sourceFile.getFileName() + ".peaks");
+}
+
+std::unique_ptr<PeakCache> PeakCache::open(const juce::File& sourceFile)
+{
+    if (auto cache = openFile(getCacheFile(sourceFile), sourceFile))
+    {
+        return cache;
+    }
+
+    return openFile(getFallbackCacheFile(sourceFile), sourceFile);
+}
+
+std::unique_ptr<PeakCache> PeakCache::openFile(const juce::File& cacheFile,
+                                               const juce::File& sourceFile)
+{
+    if (!sourceFile.existsAsFile() ||
+        cacheFile.getSize() < static_cast<juce::int64>(sizeof(Header)))
+    {
+        return nullptr;
+    }
+
+    auto mapped = std::make_unique<juce::MemoryMappedFile>(cacheFile,
+                                                           juce::MemoryMappedFile::readOnly);
+
+    if (mapped->getData() == nullptr || mapped->getSize() < sizeof(Header))
+    {
+        return nullptr;
+    }
+
+    Header header;
+    std::memcpy(&header, mapped->getData(), sizeof(Header));
+
+    if (std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 ||
+        header.version != formatVersion ||
+        header.baseShift != static_cast<juce::uint32>(PeakPyramid::baseShift) ||
+        header.numChannels == 0 || header.numLevels == 0 ||
+        header.numLevels > static_cast<juce::uint32>(PeakPyramid::maxLevels))
+    {
+        return nullptr;
+    }
+
+    // Stale: the audio was rewritten after the cache was made
+    if (header.sourceSize != sourceFile.getSize() ||
+        header.sourceModified != sourceFile.getLastModificationTime().toMilliseconds())
+    {
+        return nullptr;
+    }
+
+    PeakPyramid::View levels;
+    levels.numChannels = static_cast<int>(header.numChannels);
+    levels.numSamples = header.numSamples;
+    levels.numLevels = static_cast<int>(header.numLevels);
+
+    auto* data = static_cast<const char*>(mapped->getData());
+    auto offset = sizeof(Header);
+
+    for (int level = 0; level < levels.numLevels; ++level)
+    {
+        auto size = header.levelSizes[level];
+        auto bytes = static_cast<size_t>(size) * header.numChannels * sizeof(PeakPyramid::Entry);
+
+        if (size < 0 || offset + bytes > mapped->getSize())
+        {
+            return nullptr;
+        }
+
+        levels.levels[level] = reinterpret_cast<const PeakPyramid::Entry*>(data + offset);
+        levels.levelSizes[level] = size;
+        offset += bytes;
+    }
+
+    return std::unique_ptr<PeakCache>(new PeakCache(std::move(mapped), levels, header.sampleRate));
+}
+
+juce::Result PeakCache::write(const PeakPyramid& pyramid, const juce::File& sourceFile)
+{
+    auto levels = pyramid.getView();
+
+    Header header{};
+    std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+    header.version = formatVersion;
+    header.numChannels = static_cast<juce::uint32>(levels.numChannels);
+    header.baseShift = static_cast<juce::uint32>(PeakPyramid::baseShift);
+    header.numLevels = static_cast<juce::uint32>(levels.numLevels);
+    header.numSamples = levels.numSamples;
+    header.sampleRate = pyramid.getSampleRate();
+    header.sourceSize = sourceFile.getSize();
+    header.sourceModified = sourceFile.getLastModificationTime().toMilliseconds();
+
+    for (int level = 0; level < levels.numLevels; ++level)
+    {
+        header.levelSizes[level] = levels.levelSizes[level];
+    }
+
+    auto result = writeFile(getCacheFile(sourceFile), header, levels);
+
+    // A read-only folder (a sample library, a mounted share): keep the cache ourselves
+    if (result.failed())
+    {
+        auto fallback = getFallbackCacheFile(sourceFile);
+
+        if (fallback.getParentDirectory().createDirectory().wasOk() &&
+            writeFile(fallback, header, levels).wasOk())
+        {
+            return juce::Result::ok();
+        }
+    }
+
+    return result;
+}
+
+juce::Result PeakCache::writeFile(const juce::File& cacheFile, const Header& header,
+                                  const PeakPyramid::View& levels)
+{
+    // A reader never sees a half-written cache: it is moved into place once complete
+    juce::TemporaryFile temporary(cacheFile);
+
+    {
+        juce::FileOutputStream stream(temporary.getFile());
+
+        if (!stream.openedOk())
+        {
+            return juce::Result::fail("Could not create " + temporary.getFile().getFullPathName());
+        }
+
+        stream.write(&header, sizeof(Header));
+
+        for (int level = 0; level < levels.numLevels; ++level)
+        {
+            stream.write(levels.levels[level], static_cast<size_t>(levels.levelSizes[level]) *
+                                                   static_cast<size_t>(levels.numChannels) *
+                                                   sizeof(PeakPyramid::Entry));
+        }
+
+        stream.flush();
+
+        if (stream.getStatus().failed())
+        {
+            return stream.getStatus();
+        }
+    }
+
+    if (!temporary.overwriteTargetFileWithTemporary())
+    {
+        return juce::Result::fail("Could not write " + cacheFile.getFullPathName());
+    }
+
+    return juce::Result::ok();
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PeakPyramid.h"
+
+#include <memory>
+
+/**
+ * PeakCache reads a finished peak pyramid from its sidecar file.
+ *
+ * The cache sits next to the audio ("take.wav" -> "take.wav.peaks") or, when
+ * the audio's folder can't be written to, in a per-user cache folder. It is
+ * memory mapped, so opening one costs nothing however long the audio is and
+ * only the pages a view touches are ever read. The header records the audio
+ * file's size and modification time; a cache whose audio has changed since is
+ * treated as missing. Files are written in native byte order.
+ */
+class PeakCache
+{
+public:
+    static juce::File getCacheFile(const juce::File& sourceFile);
+    static juce::File getFallbackCacheFile(const juce::File& sourceFile); // Per-user folder
+
+    // nullptr when there is no cache, it is damaged, or the audio changed since
+    static std::unique_ptr<PeakCache> open(const juce::File& sourceFile);
+
+    // Saves a finished pyramid as sourceFile's cache (via a temporary file), in the
+    // per-user folder if the one next to the audio can't be written
+    static juce::Result write(const PeakPyramid& pyramid, const juce::File& sourceFile);
+
+    // Any thread (see PeakPyramid::View::getColumns)
+    bool getColumns(int channel, juce::int64 startSample, juce::int64 endSample,
+                    int numColumns, PeakPyramid::Column* results) const
+    {
+        return view.getColumns(channel, startSample, endSample, numColumns, results);
+    }
+
+    int getNumChannels() const { return view.numChannels; }
+    juce::int64 getNumSamples() const { return view.numSamples; }
+    double getSampleRate() const { return sampleRate; }
+
+    static constexpr juce::uint32 formatVersion = 1;
+
+private:
+    struct Header
+    {
+        char magic[8];
+        juce::uint32 version;
+        juce::uint32 numChannels;
+        juce::uint32 baseShift;
+        juce::uint32 numLevels;
+        juce::int64 numSamples;
+        double sampleRate;
+        juce::int64 sourceSize;
+        juce::int64 sourceModified; // Milliseconds since 1970
+        juce::int64 levelSizes[PeakPyramid::maxLevels]; // Entries per channel
+    };
+
+    PeakCache(std::unique_ptr<juce::MemoryMappedFile> file, const PeakPyramid::View& levels,
+              double rate);
+
+    static std::unique_ptr<PeakCache> openFile(const juce::File& cacheFile,
+                                               const juce::File& sourceFile);
+    static juce::Result writeFile(const juce::File& cacheFile, const Header& header,
+                                  const PeakPyramid::View& levels);
+
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    PeakPyramid::View view;
+    double sampleRate = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PeakCache)
+};
@@ -0,0 +1,144 @@
+#include "PeakCacheBuilder.h"
+
+PeakCacheBuilder::PeakCacheBuilder() : juce::Thread("DAIW Peak Builder")
+{
+    formatManager.registerBasicFormats();
+}
+
+PeakCacheBuilder::~PeakCacheBuilder()
+{
+    stopThread(4000);
+    cancelPendingUpdate();
+}
+
+std::shared_ptr<const PeakCache> PeakCacheBuilder::request(const juce::File& sourceFile)
+{
+    auto sourceSize = sourceFile.getSize();
+    auto sourceModified = sourceFile.getLastModificationTime().toMilliseconds();
+
+    // Ready, queued, or failed to build (nullptr) - each version of a file is only tried once
+    auto existing = caches.find(sourceFile);
+
+    if (existing != caches.end() && existing->second.sourceSize == sourceSize &&
+        existing->second.sourceModified == sourceModified)
+    {
+        return existing->second.cache;
+    }
+
+    std::shared_ptr<const PeakCache> cache = PeakCache::open(sourceFile);
+    caches[sourceFile] = {cache, sourceSize, sourceModified};
+
+    if (cache != nullptr)
+    {
+        return cache;
+    }
+
+    {
+        const juce::ScopedLock sl(queueLock);
+        queued.push_back(sourceFile);
+    }
+
+    if (!isThreadRunning())
+    {
+        startThread(juce::Thread::Priority::low);
+    }
+
+    notify();
+    return nullptr;
+}
+
+void PeakCacheBuilder::run()
+{
+    while (!threadShouldExit())
+    {
+        juce::File next;
+
+        {
+            const juce::ScopedLock sl(queueLock);
+
+            if (!queued.empty())
+            {
+                next = queued.front();
+                queued.pop_front();
+            }
+        }
+
+        if (next == juce::File())
+        {
+            wait(-1);
+            continue;
+        }
+
+        auto result = build(next);
+
+        if (result.failed())
+        {
+            DBG("PeakCacheBuilder: " + result.getErrorMessage());
+        }
+
+        {
+            const juce::ScopedLock sl(queueLock);
+            built.add(next);
+        }
+
+        triggerAsyncUpdate();
+    }
+}
+
+juce::Result PeakCacheBuilder::build(const juce::File& sourceFile)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(sourceFile));
+
+    if (reader == nullptr)
+    {
+        return juce::Result::fail("Could not read " + sourceFile.getFullPathName());
+    }
+
+    auto numChannels = static_cast<int>(reader->numChannels);
+    PeakPyramid pyramid(numChannels, reader->sampleRate);
+    juce::AudioBuffer<float> buffer(numChannels, chunkSize);
+
+    for (juce::int64 position = 0; position < reader->lengthInSamples; position += chunkSize)
+    {
+        if (threadShouldExit())
+        {
+            return juce::Result::fail("Cancelled");
+        }
+
+        auto numSamples = static_cast<int>(
+            juce::jmin(static_cast<juce::int64>(chunkSize), reader->lengthInSamples - position));
+
+        reader->read(&buffer, 0, numSamples, position, true, true);
+        pyramid.addSamples(buffer.getArrayOfReadPointers(), numSamples);
+    }
+
+    pyramid.finish();
+    return PeakCache::write(pyramid, sourceFile);
+}
+
+void PeakCacheBuilder::handleAsyncUpdate()
+{
+    juce::Array<juce::File> finished;
+
+    {
+        const juce::ScopedLock sl(queueLock);
+        finished.swapWith(built);
+    }
+
+    for (const auto& sourceFile : finished)
+    {
+        std::shared_ptr<const PeakCache> cache = PeakCache::open(sourceFile);
+
+        if (cache == nullptr)
+        {
+            continue;
+        }
+
+        // Stamped with the audio the cache was made from, so a rewrite since is noticed
+        auto& entry = caches[sourceFile];
+        entry.cache = cache;
+        entry.sourceSize = sourceFile.getSize();
+        entry.sourceModified = sourceFile.getLastModificationTime().toMilliseconds();
+        listeners.call([&sourceFile](Listener& l) { l.peakCacheReady(sourceFile); });
+    }
+}
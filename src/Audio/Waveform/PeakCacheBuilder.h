@@ -0,0 +1,70 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PeakCache.h"
+
+#include <deque>
+#include <map>
+#include <memory>
+
+/**
+ * PeakCacheBuilder hands out peak caches for audio files, building the ones
+ * that are missing or stale on a background thread.
+ *
+ * request() returns the cache straight away when its sidecar is up to date.
+ * Otherwise the file is queued: the builder thread reads it a chunk at a time
+ * through a PeakPyramid, writes the sidecar, and listeners are told on the
+ * message thread once the mapped cache is ready. Every request checks the
+ * audio file's size and modification time first, so a file rewritten in place
+ * (re-recorded, re-rendered) is built again rather than showing old peaks.
+ * Recordings don't need this: the Recorder builds their pyramids as it writes
+ * them.
+ */
+class PeakCacheBuilder : private juce::Thread, private juce::AsyncUpdater
+{
+public:
+    class Listener
+    {
+    public:
+        virtual ~Listener() = default;
+
+        // Message thread
+        virtual void peakCacheReady(const juce::File& sourceFile) = 0;
+    };
+
+    PeakCacheBuilder();
+    ~PeakCacheBuilder() override;
+
+    // Message thread: nullptr while the cache is still being built (or can't be)
+    std::shared_ptr<const PeakCache> request(const juce::File& sourceFile);
+
+    void addListener(Listener* listener) { listeners.add(listener); }
+    void removeListener(Listener* listener) { listeners.remove(listener); }
+
+    static constexpr int chunkSize = 65536; // Samples per channel per read
+
+private:
+    void run() override;
+    juce::Result build(const juce::File& sourceFile);
+    void handleAsyncUpdate() override;
+
+    juce::AudioFormatManager formatManager;
+
+    // Message thread: what request() last found for each file, and the file as it was then
+    struct Entry
+    {
+        std::shared_ptr<const PeakCache> cache; // nullptr while building, or if it failed
+        juce::int64 sourceSize = 0;
+        juce::int64 sourceModified = 0;
+    };
+
+    std::map<juce::File, Entry> caches;
+    juce::ListenerList<Listener> listeners;
+
+    // Queued and finished files, between the message thread and the builder
+    juce::CriticalSection queueLock;
+    std::deque<juce::File> queued;
+    juce::Array<juce::File> built;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PeakCacheBuilder)
+};
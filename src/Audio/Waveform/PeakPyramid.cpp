@@ -0,0 +1,326 @@
+#include "PeakPyramid.h"
+#include "../DSP/Vec4.h"
+
+#include <limits>
+
+using namespace simd;
+
+namespace
+{
+constexpr float fullScale = 32767.0f;
+} // namespace
+
+//==============================================================================
+// View
+//==============================================================================
+
+bool PeakPyramid::View::getColumns(int channel, juce::int64 startSample,
+                                   juce::int64 endSample, int numColumns,
+                                   Column* results) const
+{
+    if (channel < 0 || channel >= numChannels || numLevels == 0 || numColumns <= 0 ||
+        endSample <= startSample)
+    {
+        return false;
+    }
+
+    auto samplesPerColumn = static_cast<double>(endSample - startSample) / numColumns;
+
+    if (samplesPerColumn < static_cast<double>(1 << baseShift))
+    {
+        return false;
+    }
+
+    // The coarsest level whose entries still fit inside a column, so every column
+    // reads at most a handful of entries
+    int level = 0;
+
+    while (level + 1 < numLevels &&
+           static_cast<double>(juce::int64(1) << (baseShift + level + 1)) <= samplesPerColumn)
+    {
+        ++level;
+    }
+
+    for (int column = 0; column < numColumns; ++column)
+    {
+        auto from = startSample + static_cast<juce::int64>(column * samplesPerColumn);
+        auto to = startSample + static_cast<juce::int64>((column + 1) * samplesPerColumn);
+        auto position = juce::jmax(juce::int64(0), from);
+
+        int min = std::numeric_limits<int>::max();
+        int max = std::numeric_limits<int>::min();
+        double sumOfSquares = 0.0;
+        juce::int64 count = 0;
+
+        // Upper levels lag behind while a pyramid is still growing, so whatever the
+        // chosen level doesn't cover yet comes from the levels below (one entry each)
+        for (auto l = level; l >= 0 && position < to; --l)
+        {
+            const auto shift = baseShift + l;
+            const auto* entries = levels[l];
+            auto first = position >> shift;
+            auto last = juce::jmin(levelSizes[l], ((to - 1) >> shift) + 1);
+
+            for (auto i = first; i < last; ++i)
+            {
+                const auto& entry = entries[i * numChannels + channel];
+                min = juce::jmin(min, static_cast<int>(entry.min));
+                max = juce::jmax(max, static_cast<int>(entry.max));
+                sumOfSquares += static_cast<double>(entry.rms) * entry.rms;
+                ++count;
+            }
+
+            position = juce::jmax(position, last << shift);
+        }
+
+        if (count == 0)
+        {
+            results[column] = Column();
+            continue;
+        }
+
+        results[column].min = static_cast<float>(min) / fullScale;
+        results[column].max = static_cast<float>(max) / fullScale;
+        results[column].rms =
+            static_cast<float>(std::sqrt(sumOfSquares / static_cast<double>(count))) / fullScale;
+    }
+
+    return true;
+}
+
+//==============================================================================
+// PeakPyramid
+//==============================================================================
+
+PeakPyramid::PeakPyramid(int channels, double rate)
+    : numChannels(juce::jmax(1, channels)), sampleRate(rate),
+      pending(static_cast<size_t>(numChannels))
+{
+    // Reserved so a level never moves while the one below it is being read
+    levels.reserve(maxLevels);
+    levels.resize(1);
+}
+
+void PeakPyramid::addSamples(const float* const* channels, int numSamplesToAdd)
+{
+    jassert(!finished);
+
+    constexpr int entrySize = 1 << baseShift;
+    int offset = 0;
+
+    while (offset < numSamplesToAdd)
+    {
+        auto count = juce::jmin(numSamplesToAdd - offset, entrySize - pendingSamples);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            Accumulator block;
+            reduce(channels[channel] + offset, count, block.min, block.max, block.sumOfSquares);
+
+            auto& accumulator = pending[static_cast<size_t>(channel)];
+
+            if (pendingSamples == 0)
+            {
+                accumulator = block;
+            }
+            else
+            {
+                accumulator.min = juce::jmin(accumulator.min, block.min);
+                accumulator.max = juce::jmax(accumulator.max, block.max);
+                accumulator.sumOfSquares += block.sumOfSquares;
+            }
+        }
+
+        pendingSamples += count;
+        offset += count;
+
+        if (pendingSamples == entrySize)
+        {
+            appendBase(entrySize);
+        }
+    }
+}
+
+void PeakPyramid::finish()
+{
+    if (finished)
+    {
+        return;
+    }
+
+    if (pendingSamples > 0)
+    {
+        appendBase(pendingSamples);
+    }
+
+    const juce::ScopedLock sl(lock);
+
+    // Streaming only builds parents for complete pairs; give the odd entry at the end
+    // of each level a parent of its own
+    for (size_t level = 0; level + 1 < static_cast<size_t>(maxLevels); ++level)
+    {
+        auto size = static_cast<juce::int64>(levels[level].size()) / numChannels;
+
+        if (size <= 1)
+        {
+            break;
+        }
+
+        if (levels.size() == level + 1)
+        {
+            levels.emplace_back();
+        }
+
+        auto& parents = levels[level + 1];
+
+        for (auto i = static_cast<juce::int64>(parents.size()) / numChannels; i < (size + 1) / 2;
+             ++i)
+        {
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                auto left = levels[level][static_cast<size_t>(2 * i * numChannels + channel)];
+                parents.push_back(
+                    2 * i + 1 < size
+                        ? combine(left, levels[level][static_cast<size_t>(
+                                            (2 * i + 1) * numChannels + channel)])
+                        : left);
+            }
+        }
+    }
+
+    finished = true;
+}
+
+void PeakPyramid::appendBase(int numSamplesInEntry)
+{
+    const juce::ScopedLock sl(lock);
+
+    for (const auto& accumulator : pending)
+    {
+        auto rms = std::sqrt(accumulator.sumOfSquares / static_cast<float>(numSamplesInEntry));
+        levels[0].push_back(makeEntry(accumulator.min, accumulator.max, rms));
+    }
+
+    numSamples += numSamplesInEntry;
+    pendingSamples = 0;
+    cascade(0);
+}
+
+void PeakPyramid::cascade(int level)
+{
+    auto& entries = levels[static_cast<size_t>(level)];
+    auto size = static_cast<juce::int64>(entries.size()) / numChannels;
+
+    // Every second entry completes a pair, which makes one entry on the level above
+    if (size < 2 || size % 2 != 0 || level + 1 >= maxLevels)
+    {
+        return;
+    }
+
+    if (levels.size() == static_cast<size_t>(level + 1))
+    {
+        levels.emplace_back();
+    }
+
+    auto& parents = levels[static_cast<size_t>(level + 1)];
+    auto* pair = entries.data() + (size - 2) * numChannels;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        parents.push_back(combine(pair[channel], pair[numChannels + channel]));
+    }
+
+    cascade(level + 1);
+}
+
+PeakPyramid::View PeakPyramid::makeView() const
+{
+    View view;
+    view.numChannels = numChannels;
+    view.numSamples = numSamples;
+    view.numLevels = static_cast<int>(levels.size());
+
+    for (size_t level = 0; level < levels.size(); ++level)
+    {
+        view.levels[level] = levels[level].data();
+        view.levelSizes[level] = static_cast<juce::int64>(levels[level].size()) / numChannels;
+    }
+
+    return view;
+}
+
+PeakPyramid::View PeakPyramid::getView() const
+{
+    jassert(finished);
+
+    const juce::ScopedLock sl(lock);
+    return makeView();
+}
+
+bool PeakPyramid::getColumns(int channel, juce::int64 startSample, juce::int64 endSample,
+                             int numColumns, Column* results) const
+{
+    // The view points into the vectors, so it is only good while the lock is held
+    const juce::ScopedLock sl(lock);
+    return makeView().getColumns(channel, startSample, endSample, numColumns, results);
+}
+
+juce::int64 PeakPyramid::getNumSamples() const
+{
+    const juce::ScopedLock sl(lock);
+    return numSamples;
+}
+
+void PeakPyramid::reduce(const float* samples, int numSamplesToReduce, float& min, float& max,
+                         float& sumOfSquares) noexcept
+{
+    if (numSamplesToReduce <= 0)
+    {
+        min = max = sumOfSquares = 0.0f;
+        return;
+    }
+
+    auto minVec = vecBroadcast(samples[0]);
+    auto maxVec = minVec;
+    auto sumVec = vecZero();
+    int i = 0;
+
+    for (; i + 4 <= numSamplesToReduce; i += 4)
+    {
+        auto x = vecLoad(samples + i);
+        minVec = vecMin(minVec, x);
+        maxVec = vecMax(maxVec, x);
+        sumVec = vecAdd(sumVec, vecMul(x, x));
+    }
+
+    min = minAcross(minVec);
+    max = maxAcross(maxVec);
+    sumOfSquares = sumAcross(sumVec);
+
+    for (; i < numSamplesToReduce; ++i)
+    {
+        min = juce::jmin(min, samples[i]);
+        max = juce::jmax(max, samples[i]);
+        sumOfSquares += samples[i] * samples[i];
+    }
+}
+
+PeakPyramid::Entry PeakPyramid::makeEntry(float min, float max, float rms) noexcept
+{
+    auto quantise = [](float value)
+    {
+        return static_cast<juce::int16>(juce::roundToInt(juce::jlimit(-1.0f, 1.0f, value) *
+                                                         fullScale));
+    };
+
+    return {quantise(min), quantise(max), quantise(rms)};
+}
+
+PeakPyramid::Entry PeakPyramid::combine(const Entry& a, const Entry& b) noexcept
+{
+    auto meanSquare =
+        0.5 * (static_cast<double>(a.rms) * a.rms + static_cast<double>(b.rms) * b.rms);
+
+    return {juce::jmin(a.min, b.min), juce::jmax(a.max, b.max),
+            static_cast<juce::int16>(juce::roundToInt(std::sqrt(meanSquare)))};
+}
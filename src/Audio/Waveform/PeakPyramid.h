@@ -0,0 +1,110 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <atomic>
+#include <vector>
+
+/**
+ * PeakPyramid summarises audio for waveform drawing at every zoom level.
+ *
+ * Level 0 holds a min/max/RMS entry per 2^baseShift samples for each channel,
+ * and every level above it halves the one below, so a view at any zoom reads
+ * from the coarsest level that is still finer than a pixel and does O(pixels)
+ * work however long the audio is. Below level 0 (fewer than 256 samples per
+ * pixel) the caller draws from the samples themselves.
+ *
+ * Samples are added incrementally (a whole file on a background thread, or a
+ * recording as the writer thread drains it) and the pyramid can be queried
+ * from any thread while it grows. finish() closes the partial entries at the
+ * end, after which PeakCache::write() can save it as a sidecar cache file.
+ */
+class PeakPyramid
+{
+public:
+    // Stored entry: full scale is 32767
+    struct Entry
+    {
+        juce::int16 min = 0;
+        juce::int16 max = 0;
+        juce::int16 rms = 0;
+    };
+
+    // One pixel column of a query, in sample units
+    struct Column
+    {
+        float min = 0.0f;
+        float max = 0.0f;
+        float rms = 0.0f;
+    };
+
+    static constexpr int baseShift = 8; // 256 samples per level 0 entry
+    static constexpr int maxLevels = 16;
+
+    /** A read-only view of the levels, over memory owned by a pyramid or a mapped file. */
+    struct View
+    {
+        int numChannels = 0;
+        juce::int64 numSamples = 0;
+        int numLevels = 0;
+        const Entry* levels[maxLevels] = {}; // Interleaved by channel
+        juce::int64 levelSizes[maxLevels] = {}; // Entries per channel
+
+        // Fills numColumns columns spanning [startSample, endSample). False when the
+        // range is finer than level 0 or the channel doesn't exist
+        bool getColumns(int channel, juce::int64 startSample, juce::int64 endSample,
+                        int numColumns, Column* results) const;
+    };
+
+    PeakPyramid(int numChannels, double sampleRate);
+
+    // Builder thread: one pointer per channel
+    void addSamples(const float* const* channels, int numSamples);
+
+    // Builder thread: summarises what is left over at the end (no samples after this)
+    void finish();
+
+    // Any thread
+    bool getColumns(int channel, juce::int64 startSample, juce::int64 endSample,
+                    int numColumns, Column* results) const;
+    juce::int64 getNumSamples() const;
+    int getNumChannels() const { return numChannels; }
+    double getSampleRate() const { return sampleRate; }
+    bool isFinished() const { return finished; }
+
+    // Once finished, when the levels no longer move
+    View getView() const;
+
+    // Min, max and sum of squares of a run of samples (SSE/NEON, four at a time)
+    static void reduce(const float* samples, int numSamples, float& min, float& max,
+                       float& sumOfSquares) noexcept;
+
+    static Entry makeEntry(float min, float max, float rms) noexcept;
+    static Entry combine(const Entry& a, const Entry& b) noexcept;
+
+private:
+    struct Accumulator
+    {
+        float min = 0.0f;
+        float max = 0.0f;
+        float sumOfSquares = 0.0f;
+    };
+
+    void appendBase(int numSamplesInEntry);
+    void cascade(int level);
+    View makeView() const;
+
+    const int numChannels;
+    const double sampleRate;
+
+    juce::CriticalSection lock; // Held while levels grow, and by queries
+    std::vector<std::vector<Entry>> levels;
+    juce::int64 numSamples = 0;
+    std::atomic<bool> finished{false};
+
+    // Builder thread: the level 0 entry being filled
+    std::vector<Accumulator> pending;
+    int pendingSamples = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PeakPyramid)
+};
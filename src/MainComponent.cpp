@@ -1,6 +1,6 @@
 #include "MainComponent.h"
 
-MainComponent::MainComponent() : settingsWindow(audioEngine)
+MainComponent::MainComponent() : settingsWindow(audioEngine), frameScheduler(*this)
 {
     // Apply custom look and feel
     juce::LookAndFeel::setDefaultLookAndFeel(&lookAndFeel);
@@ -15,9 +15,11 @@ MainComponent::MainComponent() : settingsWindow(audioEngine)
 
     // Setup level meters
     inputMeter.setLabel("INPUT");
+    inputMeter.setScheduler(&frameScheduler);
     addAndMakeVisible(inputMeter);
 
     outputMeter.setLabel("OUTPUT");
+    outputMeter.setScheduler(&frameScheduler);
     addAndMakeVisible(outputMeter);
 
     // Add settings window as child (invisible by default)
@@ -26,8 +28,8 @@ MainComponent::MainComponent() : settingsWindow(audioEngine)
     // Start audio engine
     audioEngine.start();
 
-    // Start timer for level meter updates
-    startTimerHz(30);
+    // Meter data is pulled once per frame
+    frameScheduler.addSource([this] { pullMeterFrames(); });
 
     setSize(1280, 800);
 
@@ -37,16 +39,25 @@ MainComponent::MainComponent() : settingsWindow(audioEngine)
 
 MainComponent::~MainComponent()
 {
-    stopTimer();
     juce::LookAndFeel::setDefaultLookAndFeel(nullptr);
     audioEngine.stop();
 }
 
-void MainComponent::timerCallback()
+void MainComponent::pullMeterFrames()
 {
-    // Update level meters with current audio levels
-    inputMeter.setLevels(audioEngine.getInputLevelLeft(), audioEngine.getInputLevelRight());
-    outputMeter.setLevels(audioEngine.getOutputLevelLeft(), audioEngine.getOutputLevelRight());
+    // Fold every block the audio thread produced since the last frame into one,
+    // so short transients between frames still reach the meters
+    MeterFrame inputFrame;
+    if (audioEngine.getInputMeterFifo().drain(inputFrame) > 0)
+    {
+        inputMeter.setLevels(inputFrame);
+    }
+
+    MeterFrame outputFrame;
+    if (audioEngine.getOutputMeterFifo().drain(outputFrame) > 0)
+    {
+        outputMeter.setLevels(outputFrame);
+    }
 }
 
 void MainComponent::paint(juce::Graphics& g)
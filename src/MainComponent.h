@@ -4,9 +4,10 @@
 #include "Audio/AudioEngine.h"
 #include "UI/LookAndFeel/DAIWLookAndFeel.h"
 #include "UI/Components/LevelMeter.h"
+#include "UI/FrameScheduler.h"
 #include "UI/SettingsWindow.h"
 
-class MainComponent : public juce::Component, public juce::ApplicationCommandTarget, private juce::Timer
+class MainComponent : public juce::Component, public juce::ApplicationCommandTarget
 {
 public:
     MainComponent();
@@ -30,12 +31,15 @@ public:
     juce::ApplicationCommandManager& getCommandManager() { return commandManager; }
 
 private:
-    void timerCallback() override;
+    void pullMeterFrames();
 
     DAIWLookAndFeel lookAndFeel;
     AudioEngine audioEngine;
     SettingsWindow settingsWindow;
 
+    // Drives every meter and animation in the window, once per display frame
+    FrameScheduler frameScheduler;
+
     // Level meters
     StereoLevelMeter inputMeter;
     StereoLevelMeter outputMeter;
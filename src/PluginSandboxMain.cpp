@@ -0,0 +1,47 @@
+#include <JuceHeader.h>
+#include "Audio/Plugins/PluginSandbox.h"
+#include "Audio/Plugins/PluginSandboxWorker.h"
+#include "Audio/Plugins/PluginScanWorker.h"
+#include "Audio/Plugins/PluginScanner.h"
+#include "Audio/Plugins/SandboxProtocol.h"
+
+#include <memory>
+
+/**
+ * DAIW_PluginSandbox hosts one plugin for the engine in a process of its own
+ * (started by PluginSandbox), or scans plugin binaries for it (started by
+ * PluginScanner). It is never run by hand, and quits when the engine that
+ * started it goes away.
+ */
+int main(int argc, char* argv[])
+{
+    auto commandLine = juce::StringArray(argv + 1, argc - 1).joinIntoString(" ");
+
+    // Plugins need a message thread; no window of ours is ever created
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    std::unique_ptr<juce::ChildProcessWorker> worker;
+    bool connected = false;
+
+    if (commandLine.contains(SandboxProtocol::scannerCommandLineId))
+    {
+        worker = std::make_unique<PluginScanWorker>();
+        connected = worker->initialiseFromCommandLine(commandLine,
+                                                      SandboxProtocol::scannerCommandLineId,
+                                                      PluginScanner::processPingTimeoutMs);
+    }
+    else
+    {
+        worker = std::make_unique<PluginSandboxWorker>();
+        connected = worker->initialiseFromCommandLine(commandLine, SandboxProtocol::commandLineId,
+                                                      PluginSandbox::pingTimeoutMs);
+    }
+
+    if (!connected)
+    {
+        return 1;
+    }
+
+    juce::MessageManager::getInstance()->runDispatchLoop();
+    return 0;
+}
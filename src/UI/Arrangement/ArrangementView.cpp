@@ -0,0 +1,631 @@
+#include "ArrangementView.h"
+#include "../LookAndFeel/DAIWLookAndFeel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tuple>
+
+namespace
+{
+constexpr juce::int64 unknownEnd = std::numeric_limits<juce::int64>::max();
+constexpr float clipHeaderHeight = 16.0f;
+constexpr float clipInset = 2.0f;
+
+bool sameClip(const AudioClip& a, const AudioClip& b)
+{
+    return a.file == b.file && a.timelineStart == b.timelineStart &&
+           a.sourceOffset == b.sourceOffset && a.length == b.length;
+}
+
+bool containsClip(const std::vector<AudioClip>& clips, const AudioClip& clip)
+{
+    return std::any_of(clips.begin(), clips.end(),
+                       [&clip](const AudioClip& other) { return sameClip(clip, other); });
+}
+} // namespace
+
+//==============================================================================
+bool ArrangementView::TileKey::operator<(const TileKey& other) const
+{
+    return std::tie(lane, index, samplesPerPixel) <
+           std::tie(other.lane, other.index, other.samplesPerPixel);
+}
+
+//==============================================================================
+ArrangementView::ArrangementView(PeakCacheBuilder& builder, Transport& transport,
+                                 FrameScheduler& scheduler)
+    : peakCaches(builder),
+      renderPool(juce::ThreadPoolOptions{}
+                     .withThreadName("DAIW Tile Renderer")
+                     .withNumberOfThreads(numRenderThreads)
+                     .withDesiredThreadPriority(juce::Thread::Priority::low)),
+      playhead(*this, transport, scheduler)
+{
+    setOpaque(true);
+    formatManager.registerBasicFormats();
+    peakCaches.addListener(this);
+    addAndMakeVisible(playhead);
+}
+
+ArrangementView::~ArrangementView()
+{
+    // Jobs write into rendered, so none may outlive the view
+    renderPool.removeAllJobs(true, 4000);
+    cancelPendingUpdate();
+    peakCaches.removeListener(this);
+}
+
+void ArrangementView::setLanes(std::vector<Lane> newLanes)
+{
+    auto numLanes = juce::jmax(lanes.size(), newLanes.size());
+
+    for (size_t i = 0; i < numLanes; ++i)
+    {
+        setLaneClips(static_cast<int>(i),
+                     i < newLanes.size() ? newLanes[i].clips : std::vector<AudioClip>());
+    }
+
+    // Tiles of lanes that are gone will never be drawn again
+    for (auto it = tiles.begin(); it != tiles.end();)
+    {
+        auto removed = it->first.lane >= static_cast<int>(newLanes.size());
+        it = removed ? tiles.erase(it) : std::next(it);
+    }
+
+    if (newLanes.size() != lanes.size())
+    {
+        repaint();
+    }
+
+    lanes = std::move(newLanes);
+}
+
+void ArrangementView::setLaneClips(int laneIndex, std::vector<AudioClip> clips)
+{
+    if (laneIndex < 0)
+    {
+        return;
+    }
+
+    if (laneIndex >= static_cast<int>(lanes.size()))
+    {
+        lanes.resize(static_cast<size_t>(laneIndex) + 1);
+        repaint();
+    }
+
+    auto& lane = lanes[static_cast<size_t>(laneIndex)];
+
+    // Only clips that were added, removed or moved touch any tiles
+    auto invalidateClip = [this, laneIndex](const AudioClip& clip)
+    {
+        auto peaks = peakCaches.request(clip.file);
+        invalidate(laneIndex, clip.timelineStart, getClipEnd(clip, peaks.get()));
+    };
+
+    for (const auto& clip : lane.clips)
+    {
+        if (!containsClip(clips, clip))
+        {
+            invalidateClip(clip);
+        }
+    }
+
+    for (const auto& clip : clips)
+    {
+        if (!containsClip(lane.clips, clip))
+        {
+            invalidateClip(clip);
+        }
+    }
+
+    lane.clips = std::move(clips);
+}
+
+void ArrangementView::setVisibleRange(juce::int64 startSample, double newSamplesPerPixel)
+{
+    newSamplesPerPixel = juce::jmax(1.0, newSamplesPerPixel);
+    auto newScroll = static_cast<juce::int64>(
+        std::llround(static_cast<double>(startSample) / newSamplesPerPixel));
+
+    if (newScroll == scrollPixels && newSamplesPerPixel == samplesPerPixel)
+    {
+        return;
+    }
+
+    // Tiles of other zooms stay cached, so zooming back is a blit too
+    scrollPixels = newScroll;
+    samplesPerPixel = newSamplesPerPixel;
+    repaint();
+}
+
+void ArrangementView::setVerticalOffset(int pixels)
+{
+    if (pixels != verticalOffset)
+    {
+        verticalOffset = pixels;
+        repaint();
+    }
+}
+
+juce::int64 ArrangementView::getStartSample() const
+{
+    return static_cast<juce::int64>(static_cast<double>(scrollPixels) * samplesPerPixel);
+}
+
+void ArrangementView::resized()
+{
+    playhead.setBounds(getLocalBounds());
+}
+
+void ArrangementView::paint(juce::Graphics& g)
+{
+    auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    // Tiles are rendered at the display's resolution; a different display needs new ones
+    if (scale != tileScale)
+    {
+        tiles.clear();
+        tileScale = scale;
+    }
+
+    ++paintCount;
+    g.fillAll(DAIWLookAndFeel::Colors::background);
+
+    auto area = g.getClipBounds();
+    auto numLanes = static_cast<int>(lanes.size());
+    auto firstLane = juce::jmax(0, (area.getY() + verticalOffset) / laneHeight);
+    auto lastLane = juce::jmin(numLanes - 1,
+                               (area.getBottom() - 1 + verticalOffset) / laneHeight);
+    auto firstIndex = (scrollPixels + area.getX()) / tileWidth;
+    auto lastIndex = (scrollPixels + area.getRight() - 1) / tileWidth;
+
+    for (int lane = firstLane; lane <= lastLane; ++lane)
+    {
+        for (auto index = juce::jmax(static_cast<juce::int64>(0), firstIndex); index <= lastIndex;
+             ++index)
+        {
+            TileKey key{lane, index, samplesPerPixel};
+            auto [entry, added] = tiles.try_emplace(key);
+            auto& tile = entry->second;
+
+            if (added)
+            {
+                tile.generation = ++nextGeneration;
+            }
+
+            auto bounds = getTileBounds(key);
+            tile.lastUsed = paintCount;
+
+            // An outdated image is still closer than nothing while its replacement renders
+            if (tile.image.isValid())
+            {
+                g.drawImage(tile.image, bounds.toFloat());
+            }
+            else
+            {
+                g.setColour(DAIWLookAndFeel::Colors::panelBackground);
+                g.fillRect(bounds.withTrimmedBottom(1));
+            }
+
+            if (tile.stale && !tile.pending)
+            {
+                requestTile(key, tile);
+            }
+        }
+    }
+
+    evictTiles();
+}
+
+void ArrangementView::requestTile(const TileKey& key, Tile& tile)
+{
+    if (key.lane >= static_cast<int>(lanes.size()))
+    {
+        return;
+    }
+
+    auto tileStart = static_cast<juce::int64>(static_cast<double>(key.index * tileWidth) *
+                                              key.samplesPerPixel);
+    auto tileEnd = static_cast<juce::int64>(static_cast<double>((key.index + 1) * tileWidth) *
+                                            key.samplesPerPixel);
+
+    // Peaks are looked up here: the builder is message-thread only
+    std::vector<ClipToDraw> clips;
+
+    for (const auto& clip : lanes[static_cast<size_t>(key.lane)].clips)
+    {
+        auto peaks = peakCaches.request(clip.file);
+        auto end = getClipEnd(clip, peaks.get());
+
+        if (clip.timelineStart < tileEnd && end > tileStart)
+        {
+            clips.push_back({clip, end == unknownEnd ? -1 : end, std::move(peaks)});
+        }
+    }
+
+    tile.pending = true;
+
+    renderPool.addJob(
+        [this, key, generation = tile.generation, scale = tileScale, clips = std::move(clips)]
+        {
+            auto image = renderTile(key, scale, clips, formatManager);
+
+            {
+                const juce::ScopedLock sl(renderedLock);
+                rendered.push_back({key, generation, std::move(image)});
+            }
+
+            triggerAsyncUpdate();
+        });
+}
+
+void ArrangementView::handleAsyncUpdate()
+{
+    std::vector<RenderedTile> finished;
+
+    {
+        const juce::ScopedLock sl(renderedLock);
+        finished.swap(rendered);
+    }
+
+    for (auto& result : finished)
+    {
+        auto tile = tiles.find(result.key);
+
+        // Evicted, or changed again while this was rendering
+        if (tile == tiles.end() || tile->second.generation != result.generation)
+        {
+            continue;
+        }
+
+        tile->second.image = std::move(result.image);
+        tile->second.stale = false;
+        tile->second.pending = false;
+
+        if (result.key.samplesPerPixel == samplesPerPixel)
+        {
+            repaint(getTileBounds(result.key));
+        }
+    }
+}
+
+void ArrangementView::peakCacheReady(const juce::File& sourceFile)
+{
+    auto peaks = peakCaches.request(sourceFile);
+
+    for (size_t lane = 0; lane < lanes.size(); ++lane)
+    {
+        for (const auto& clip : lanes[lane].clips)
+        {
+            if (clip.file == sourceFile)
+            {
+                invalidate(static_cast<int>(lane), clip.timelineStart,
+                           getClipEnd(clip, peaks.get()));
+            }
+        }
+    }
+}
+
+void ArrangementView::invalidate(int laneIndex, juce::int64 startSample, juce::int64 endSample)
+{
+    for (auto& [key, tile] : tiles)
+    {
+        if (key.lane != laneIndex)
+        {
+            continue;
+        }
+
+        auto tileSamples = static_cast<double>(tileWidth) * key.samplesPerPixel;
+        auto tileStart = static_cast<double>(key.index) * tileSamples;
+
+        if (static_cast<double>(startSample) >= tileStart + tileSamples ||
+            static_cast<double>(endSample) <= tileStart)
+        {
+            continue;
+        }
+
+        // A job already under way for the old contents is simply ignored when it lands
+        tile.generation = ++nextGeneration;
+        tile.stale = true;
+        tile.pending = false;
+
+        if (key.samplesPerPixel == samplesPerPixel)
+        {
+            repaint(getTileBounds(key));
+        }
+    }
+}
+
+void ArrangementView::evictTiles()
+{
+    if (static_cast<int>(tiles.size()) <= maxCachedTiles)
+    {
+        return;
+    }
+
+    // Least recently drawn first, never anything on screen now
+    std::vector<std::pair<juce::uint32, TileKey>> candidates;
+
+    for (const auto& [key, tile] : tiles)
+    {
+        auto onScreen = key.samplesPerPixel == samplesPerPixel &&
+                        getTileBounds(key).intersects(getLocalBounds());
+
+        if (!onScreen)
+        {
+            candidates.emplace_back(tile.lastUsed, key);
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    auto excess = static_cast<size_t>(static_cast<int>(tiles.size()) - maxCachedTiles);
+
+    for (size_t i = 0; i < juce::jmin(excess, candidates.size()); ++i)
+    {
+        tiles.erase(candidates[i].second);
+    }
+}
+
+juce::int64 ArrangementView::getClipEnd(const AudioClip& clip, const PeakCache* peaks) const
+{
+    if (clip.length > 0)
+    {
+        return clip.timelineStart + clip.length;
+    }
+
+    if (peaks != nullptr)
+    {
+        return clip.timelineStart + juce::jmax(static_cast<juce::int64>(0),
+                                               peaks->getNumSamples() - clip.sourceOffset);
+    }
+
+    // "To the end of the file" with no peaks yet: the length isn't known without opening it
+    return unknownEnd;
+}
+
+juce::Rectangle<int> ArrangementView::getTileBounds(const TileKey& key) const
+{
+    return {static_cast<int>(key.index * tileWidth - scrollPixels),
+            key.lane * laneHeight - verticalOffset, tileWidth, laneHeight};
+}
+
+juce::Image ArrangementView::renderTile(const TileKey& key, float scale,
+                                        const std::vector<ClipToDraw>& clips,
+                                        juce::AudioFormatManager& formatManager)
+{
+    auto width = juce::roundToInt(static_cast<float>(tileWidth) * scale);
+    auto height = juce::roundToInt(static_cast<float>(laneHeight) * scale);
+    juce::Image image(juce::Image::RGB, width, height, false, juce::SoftwareImageType());
+
+    juce::Graphics g(image);
+    g.addTransform(juce::AffineTransform::scale(scale));
+
+    g.setColour(DAIWLookAndFeel::Colors::panelBackground);
+    g.fillRect(0, 0, tileWidth, laneHeight);
+    g.setColour(DAIWLookAndFeel::Colors::border);
+    g.fillRect(0, laneHeight - 1, tileWidth, 1);
+
+    // Everything below is in samples from the tile's left edge, one column per physical pixel
+    auto tileStart = static_cast<double>(key.index * tileWidth) * key.samplesPerPixel;
+    auto samplesPerColumn = key.samplesPerPixel / static_cast<double>(scale);
+    auto columnWidth = 1.0f / scale;
+
+    std::vector<PeakPyramid::Column> columns;
+    std::vector<PeakPyramid::Column> channelColumns;
+    juce::AudioBuffer<float> samples;
+
+    for (const auto& toDraw : clips)
+    {
+        const auto& clip = toDraw.clip;
+        auto end = toDraw.timelineEnd;
+        std::unique_ptr<juce::AudioFormatReader> reader;
+
+        // "To the end of the file" with no peaks to say where that is
+        if (end < 0)
+        {
+            reader.reset(formatManager.createReaderFor(clip.file));
+            end = clip.timelineStart;
+
+            if (reader != nullptr)
+            {
+                end += juce::jmax(static_cast<juce::int64>(0),
+                                  reader->lengthInSamples - clip.sourceOffset);
+            }
+        }
+
+        auto x0 = static_cast<float>((static_cast<double>(clip.timelineStart) - tileStart) /
+                                     key.samplesPerPixel);
+        auto x1 = static_cast<float>((static_cast<double>(end) - tileStart) / key.samplesPerPixel);
+
+        if (x1 <= 0.0f || x0 >= static_cast<float>(tileWidth))
+        {
+            continue;
+        }
+
+        // Drawn at the clip's own position, so pieces in neighbouring tiles line up
+        juce::Rectangle<float> block(x0, clipInset, x1 - x0,
+                                     static_cast<float>(laneHeight) - 2.0f * clipInset - 1.0f);
+        g.setColour(DAIWLookAndFeel::Colors::surface);
+        g.fillRoundedRectangle(block, 3.0f);
+        g.setColour(DAIWLookAndFeel::Colors::primaryAccent.withAlpha(0.6f));
+        g.drawRoundedRectangle(block, 3.0f, 1.0f);
+
+        g.setColour(DAIWLookAndFeel::Colors::textSecondary);
+        g.setFont(juce::FontOptions(11.0f));
+        g.drawText(clip.file.getFileNameWithoutExtension(),
+                   block.withHeight(clipHeaderHeight).reduced(4.0f, 0.0f),
+                   juce::Justification::centredLeft, true);
+
+        // Columns of this clip inside the tile
+        auto firstColumn = juce::jmax(0, static_cast<int>(std::ceil(x0 * scale)));
+        auto lastColumn = juce::jmin(width, static_cast<int>(std::floor(x1 * scale)));
+        auto numColumns = lastColumn - firstColumn;
+
+        if (numColumns <= 0)
+        {
+            continue;
+        }
+
+        auto clipOffset = tileStart + firstColumn * samplesPerColumn -
+                          static_cast<double>(clip.timelineStart);
+        auto sourceStart = clip.sourceOffset + static_cast<juce::int64>(clipOffset);
+        auto sourceEnd = sourceStart + static_cast<juce::int64>(numColumns * samplesPerColumn);
+
+        if (sourceEnd <= sourceStart)
+        {
+            continue;
+        }
+
+        columns.assign(static_cast<size_t>(numColumns), {});
+        channelColumns.resize(static_cast<size_t>(numColumns));
+        auto haveColumns = false;
+
+        if (toDraw.peaks != nullptr)
+        {
+            // Channels are merged into one outline
+            for (int channel = 0; channel < toDraw.peaks->getNumChannels(); ++channel)
+            {
+                if (!toDraw.peaks->getColumns(channel, sourceStart, sourceEnd, numColumns,
+                                              channelColumns.data()))
+                {
+                    haveColumns = false;
+                    break;
+                }
+
+                for (int c = 0; c < numColumns; ++c)
+                {
+                    auto& merged = columns[static_cast<size_t>(c)];
+                    const auto& column = channelColumns[static_cast<size_t>(c)];
+                    merged.min = juce::jmin(merged.min, column.min);
+                    merged.max = juce::jmax(merged.max, column.max);
+                }
+
+                haveColumns = true;
+            }
+        }
+
+        // Closer in than the peaks go: summarise the samples themselves. Further out than
+        // that, with no peaks yet, the bare block stands in until peakCacheReady() redraws
+        // it, rather than reading every sample the tile spans
+        if (!haveColumns)
+        {
+            if (samplesPerColumn >= static_cast<double>(1 << PeakPyramid::baseShift))
+            {
+                continue;
+            }
+
+            if (reader == nullptr)
+            {
+                reader.reset(formatManager.createReaderFor(clip.file));
+            }
+
+            if (reader == nullptr)
+            {
+                continue;
+            }
+
+            auto numSamples = static_cast<int>(sourceEnd - sourceStart);
+            auto numChannels = static_cast<int>(reader->numChannels);
+            samples.setSize(numChannels, numSamples, false, false, true);
+            reader->read(&samples, 0, numSamples, sourceStart, true, true);
+            columns.assign(static_cast<size_t>(numColumns), {});
+
+            for (int c = 0; c < numColumns; ++c)
+            {
+                auto from = static_cast<int>(c * samplesPerColumn);
+                auto to = juce::jmin(numSamples, static_cast<int>((c + 1) * samplesPerColumn));
+
+                if (to <= from)
+                {
+                    continue;
+                }
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    float min = 0.0f, max = 0.0f, sumOfSquares = 0.0f;
+                    PeakPyramid::reduce(samples.getReadPointer(channel, from), to - from, min,
+                                        max, sumOfSquares);
+
+                    auto& merged = columns[static_cast<size_t>(c)];
+                    merged.min = juce::jmin(merged.min, min);
+                    merged.max = juce::jmax(merged.max, max);
+                }
+            }
+        }
+
+        auto waveTop = block.getY() + clipHeaderHeight;
+        auto halfHeight = (block.getBottom() - waveTop) * 0.5f;
+        auto centre = waveTop + halfHeight;
+        juce::RectangleList<float> outline;
+
+        for (int c = 0; c < numColumns; ++c)
+        {
+            const auto& column = columns[static_cast<size_t>(c)];
+            auto top = centre - juce::jlimit(-1.0f, 1.0f, column.max) * halfHeight;
+            auto bottom = centre - juce::jlimit(-1.0f, 1.0f, column.min) * halfHeight;
+            outline.addWithoutMerging({static_cast<float>(firstColumn + c) * columnWidth, top,
+                                       columnWidth, juce::jmax(columnWidth, bottom - top)});
+        }
+
+        g.setColour(DAIWLookAndFeel::Colors::primaryAccent.withAlpha(0.8f));
+        g.fillRectList(outline);
+    }
+
+    return image;
+}
+
+//==============================================================================
+ArrangementView::PlayheadOverlay::PlayheadOverlay(ArrangementView& owner, Transport& t,
+                                                  FrameScheduler& s)
+    : view(owner), transport(t), scheduler(s)
+{
+    setInterceptsMouseClicks(false, false);
+    scheduler.addClient(this);
+
+    // Starts the frames when playback starts, or a stopped playhead is moved
+    sourceId = scheduler.addSource(
+        [this]
+        {
+            if (transport.isPlaying() || getPlayheadX() != drawnX)
+            {
+                scheduler.wake();
+            }
+        });
+}
+
+ArrangementView::PlayheadOverlay::~PlayheadOverlay()
+{
+    scheduler.removeSource(sourceId);
+    scheduler.removeClient(this);
+}
+
+bool ArrangementView::PlayheadOverlay::advanceFrame(FrameScheduler& frameScheduler, double)
+{
+    auto x = getPlayheadX();
+
+    if (x != drawnX)
+    {
+        frameScheduler.invalidate(*this, {drawnX, 0, playheadWidth, getHeight()});
+        frameScheduler.invalidate(*this, {x, 0, playheadWidth, getHeight()});
+        drawnX = x;
+    }
+
+    return transport.isPlaying();
+}
+
+void ArrangementView::PlayheadOverlay::paint(juce::Graphics& g)
+{
+    // The view may have scrolled underneath since the last frame
+    drawnX = getPlayheadX();
+    g.setColour(DAIWLookAndFeel::Colors::textPrimary.withAlpha(0.9f));
+    g.fillRect(drawnX, 0, playheadWidth, getHeight());
+}
+
+int ArrangementView::PlayheadOverlay::getPlayheadX() const
+{
+    auto pixels = static_cast<double>(transport.getPosition()) / view.samplesPerPixel;
+    return static_cast<int>(std::llround(pixels) - view.scrollPixels);
+}
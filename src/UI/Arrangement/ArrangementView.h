@@ -0,0 +1,159 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../Audio/Streaming/ClipStream.h"
+#include "../../Audio/Transport.h"
+#include "../../Audio/Waveform/PeakCacheBuilder.h"
+#include "../FrameScheduler.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+/**
+ * ArrangementView draws the track lanes and their clips on the timeline.
+ *
+ * The timeline is cut into tiles a fixed number of pixels wide, one row per
+ * lane, cached as images keyed by lane, tile position and zoom. Painting only
+ * blits tiles, so scrolling and the playhead cost the same however many clips
+ * a session has. Missing and outdated tiles are rendered on a background pool
+ * (waveforms come from the peak caches) and swapped in when they are done;
+ * until then the old image, or the bare lane, is shown.
+ *
+ * Changing a lane's clips only invalidates the tiles the changed clips cover,
+ * and a peak cache finishing only those its file appears in. Tiles away from
+ * the view are evicted once more than maxCachedTiles are held.
+ *
+ * The playhead is a separate overlay advanced by the FrameScheduler, so moving
+ * it repaints two thin strips rather than the tiles underneath.
+ */
+class ArrangementView : public juce::Component,
+                        private juce::AsyncUpdater,
+                        private PeakCacheBuilder::Listener
+{
+public:
+    struct Lane
+    {
+        juce::String name;
+        std::vector<AudioClip> clips;
+    };
+
+    ArrangementView(PeakCacheBuilder& peakCaches, Transport& transport,
+                    FrameScheduler& scheduler);
+    ~ArrangementView() override;
+
+    // Message thread
+    void setLanes(std::vector<Lane> newLanes);
+    void setLaneClips(int laneIndex, std::vector<AudioClip> clips);
+    const std::vector<Lane>& getLanes() const { return lanes; }
+
+    // Scroll and zoom: the sample at the left edge, and samples per pixel
+    void setVisibleRange(juce::int64 startSample, double samplesPerPixel);
+    void setVerticalOffset(int pixels);
+
+    juce::int64 getStartSample() const;
+    double getSamplesPerPixel() const { return samplesPerPixel; }
+    int getNumCachedTiles() const { return static_cast<int>(tiles.size()); }
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+    static constexpr int tileWidth = 256;
+    static constexpr int laneHeight = 80;
+    static constexpr int playheadWidth = 2;
+    static constexpr int maxCachedTiles = 512;
+    static constexpr int numRenderThreads = 2;
+
+private:
+    /** Draws the playhead over the tiles, moving it one frame at a time. */
+    class PlayheadOverlay : public juce::Component, private FrameScheduler::Client
+    {
+    public:
+        PlayheadOverlay(ArrangementView& view, Transport& transport, FrameScheduler& scheduler);
+        ~PlayheadOverlay() override;
+
+        void paint(juce::Graphics& g) override;
+
+    private:
+        bool advanceFrame(FrameScheduler& scheduler, double elapsedSeconds) override;
+        int getPlayheadX() const;
+
+        ArrangementView& view;
+        Transport& transport;
+        FrameScheduler& scheduler;
+        int sourceId = 0;
+        int drawnX = -1;
+    };
+
+    struct TileKey
+    {
+        int lane = 0;
+        juce::int64 index = 0;
+        double samplesPerPixel = 0.0;
+
+        bool operator<(const TileKey& other) const;
+    };
+
+    struct Tile
+    {
+        juce::Image image;
+        juce::uint32 generation = 0; // Renewed whenever what the tile shows changes
+        bool stale = true;
+        bool pending = false;
+        juce::uint32 lastUsed = 0; // Paint that last drew it
+    };
+
+    // Everything a render job needs, copied so it never touches the view
+    struct ClipToDraw
+    {
+        AudioClip clip;
+        juce::int64 timelineEnd = 0;
+        std::shared_ptr<const PeakCache> peaks;
+    };
+
+    struct RenderedTile
+    {
+        TileKey key;
+        juce::uint32 generation = 0;
+        juce::Image image;
+    };
+
+    void requestTile(const TileKey& key, Tile& tile);
+    void handleAsyncUpdate() override;
+    void peakCacheReady(const juce::File& sourceFile) override;
+
+    // Marks the lane's tiles over [startSample, endSample) for re-rendering
+    void invalidate(int laneIndex, juce::int64 startSample, juce::int64 endSample);
+    void evictTiles();
+
+    juce::int64 getClipEnd(const AudioClip& clip, const PeakCache* peaks) const;
+    juce::Rectangle<int> getTileBounds(const TileKey& key) const;
+
+    static juce::Image renderTile(const TileKey& key, float scale,
+                                  const std::vector<ClipToDraw>& clips,
+                                  juce::AudioFormatManager& formatManager);
+
+    PeakCacheBuilder& peakCaches;
+    std::vector<Lane> lanes;
+
+    juce::int64 scrollPixels = 0; // Left edge, in pixels from the timeline start
+    double samplesPerPixel = 1024.0;
+    int verticalOffset = 0;
+
+    // Message thread
+    std::map<TileKey, Tile> tiles;
+    juce::uint32 paintCount = 0;
+    juce::uint32 nextGeneration = 0; // Never reused, so late results can't match a new tile
+    float tileScale = 1.0f;
+
+    // Render jobs hand their images back here
+    juce::CriticalSection renderedLock;
+    std::vector<RenderedTile> rendered;
+
+    juce::AudioFormatManager formatManager; // For zooms finer than the peak caches
+    juce::ThreadPool renderPool;
+
+    PlayheadOverlay playhead;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ArrangementView)
+};
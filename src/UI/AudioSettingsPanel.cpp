@@ -6,6 +6,8 @@ AudioSettingsPanel::AudioSettingsPanel(AudioEngine& engine) : audioEngine(engine
 {
     // Listen for device changes
     audioEngine.getDeviceManager().addChangeListener(this);
+    audioEngine.getDeviceReconfigurer().addListener(this);
+    audioEngine.getDeviceRegistry().addListener(this);
 
     // Section header
     sectionLabel.setText("Audio Device Configuration", juce::dontSendNotification);
@@ -50,13 +52,36 @@ AudioSettingsPanel::AudioSettingsPanel(AudioEngine& engine) : audioEngine(engine
     statusLabel.setFont(juce::Font(juce::FontOptions(12.0f)));
     addAndMakeVisible(statusLabel);
 
+    // Performance readout (DSP load and xruns from the callback profiler)
+    performanceLabel.setColour(juce::Label::textColourId, DAIWLookAndFeel::Colors::textMuted);
+    performanceLabel.setFont(juce::Font(juce::FontOptions(12.0f)));
+    addAndMakeVisible(performanceLabel);
+
+    exportStatsButton.setButtonText("Export Stats...");
+    exportStatsButton.onClick = [this]() { exportPerformanceStats(); };
+    addAndMakeVisible(exportStatsButton);
+
+    measureLatencyButton.setButtonText("Measure Latency");
+    measureLatencyButton.setTooltip("Loop output 1 back to input 1, then measure the round trip");
+    measureLatencyButton.onClick = [this]() { measureLatency(); };
+    addAndMakeVisible(measureLatencyButton);
+
     // Initial population
     refreshDeviceLists();
     refreshCurrentSettings();
+    refreshPerformance();
+
+    // Rescan in the background for anything plugged in since; the lists follow if it was
+    audioEngine.getDeviceRegistry().refresh();
+
+    startTimerHz(4);
 }
 
 AudioSettingsPanel::~AudioSettingsPanel()
 {
+    stopTimer();
+    audioEngine.getDeviceRegistry().removeListener(this);
+    audioEngine.getDeviceReconfigurer().removeListener(this);
     audioEngine.getDeviceManager().removeChangeListener(this);
 }
 
@@ -97,37 +122,220 @@ void AudioSettingsPanel::resized()
     bufferSizeCombo.setBounds(bufferSizeRow.removeFromLeft(comboWidth));
     bounds.removeFromTop(spacing * 2);
 
-    // Status
+    // Status, with the live performance readout directly beneath it
     statusLabel.setBounds(bounds.removeFromTop(20));
+    performanceLabel.setBounds(bounds.removeFromTop(20));
+    bounds.removeFromTop(spacing);
+
+    auto buttonRow = bounds.removeFromTop(28);
+    exportStatsButton.setBounds(buttonRow.removeFromLeft(120));
+    buttonRow.removeFromLeft(spacing);
+    measureLatencyButton.setBounds(buttonRow.removeFromLeft(140));
 }
 
 void AudioSettingsPanel::changeListenerCallback(juce::ChangeBroadcaster* /*source*/)
 {
-    // Device configuration changed externally
-    refreshCurrentSettings();
+    // Device configuration changed externally (our own changes refresh once they complete)
+    if (!audioEngine.getDeviceReconfigurer().isBusy())
+    {
+        refreshCurrentSettings();
+    }
+}
+
+void AudioSettingsPanel::deviceReconfigurationChanged(const DeviceReconfigurer::Progress& progress)
+{
+    using State = DeviceReconfigurer::State;
+
+    if (progress.state == State::running || progress.state == State::failed)
+    {
+        refreshCurrentSettings();
+
+        if (progress.error.isNotEmpty())
+        {
+            auto text = "Error: " + progress.error;
+            text += progress.rolledBack ? " (previous device restored)" : "";
+            statusLabel.setText(text, juce::dontSendNotification);
+            statusLabel.setColour(juce::Label::textColourId, DAIWLookAndFeel::Colors::error);
+        }
+
+        return;
+    }
+
+    auto colour = progress.state == State::rollingBack ? DAIWLookAndFeel::Colors::warning
+                                                       : DAIWLookAndFeel::Colors::primaryAccent;
+
+    statusLabel.setText(progress.description + "...", juce::dontSendNotification);
+    statusLabel.setColour(juce::Label::textColourId, colour);
+}
+
+void AudioSettingsPanel::showPending(const juce::String& text)
+{
+    statusLabel.setText(text, juce::dontSendNotification);
+    statusLabel.setColour(juce::Label::textColourId, DAIWLookAndFeel::Colors::primaryAccent);
+}
+
+void AudioSettingsPanel::timerCallback()
+{
+    if (isShowing())
+    {
+        refreshPerformance();
+    }
+}
+
+void AudioSettingsPanel::refreshPerformance()
+{
+    auto stats = audioEngine.getCallbackStats();
+
+    if (stats.callbacks == 0)
+    {
+        performanceLabel.setText("CPU --", juce::dontSendNotification);
+        return;
+    }
+
+    auto xruns = juce::jmax(stats.missedCallbacks, static_cast<juce::int64>(stats.deviceXRuns));
+
+    auto text = "CPU " + juce::String(stats.averageLoad * 100.0, 1) + "% (p99 " +
+                juce::String(stats.load.p99 * 100.0, 0) + "%) | XRuns " + juce::String(xruns);
+
+    if (stats.diskUnderruns > 0)
+    {
+        text += " | Disk " + juce::String(stats.diskUnderruns);
+    }
+
+    performanceLabel.setText(text, juce::dontSendNotification);
+
+    // Warn once the callback is using most of its deadline or dropping out
+    auto colour = DAIWLookAndFeel::Colors::textMuted;
+    if (xruns > 0 || stats.diskUnderruns > 0 || stats.load.p99 > 0.8)
+    {
+        colour = DAIWLookAndFeel::Colors::warning;
+    }
+    performanceLabel.setColour(juce::Label::textColourId, colour);
+}
+
+void AudioSettingsPanel::exportPerformanceStats()
+{
+    exportChooser = std::make_unique<juce::FileChooser>(
+        "Export audio callback stats",
+        juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+            .getChildFile("daiw-callback-stats.json"),
+        "*.json");
+
+    auto flags = juce::FileBrowserComponent::saveMode |
+                 juce::FileBrowserComponent::canSelectFiles |
+                 juce::FileBrowserComponent::warnAboutOverwriting;
+
+    exportChooser->launchAsync(flags, [this](const juce::FileChooser& chooser)
+    {
+        auto file = chooser.getResult();
+        if (file == juce::File())
+        {
+            return;
+        }
+
+        auto result = audioEngine.exportCallbackStats(file);
+
+        if (result.failed())
+        {
+            statusLabel.setText("Error: " + result.getErrorMessage(), juce::dontSendNotification);
+            statusLabel.setColour(juce::Label::textColourId, DAIWLookAndFeel::Colors::error);
+        }
+        else
+        {
+            statusLabel.setText("Exported stats to " + file.getFileName(),
+                                juce::dontSendNotification);
+            statusLabel.setColour(juce::Label::textColourId, DAIWLookAndFeel::Colors::success);
+        }
+    });
+}
+
+void AudioSettingsPanel::measureLatency()
+{
+    juce::Component::SafePointer<AudioSettingsPanel> safeThis(this);
+
+    auto result = audioEngine.measureLatency(
+        0, 0,
+        [safeThis](const LatencyCalibrator::Measurement& measurement)
+        {
+            if (safeThis == nullptr)
+            {
+                return;
+            }
+
+            safeThis->measureLatencyButton.setEnabled(true);
+            safeThis->refreshCurrentSettings();
+
+            if (!measurement.succeeded)
+            {
+                safeThis->statusLabel.setText("Error: " + measurement.error,
+                                              juce::dontSendNotification);
+                safeThis->statusLabel.setColour(juce::Label::textColourId,
+                                                DAIWLookAndFeel::Colors::error);
+            }
+        });
+
+    if (result.failed())
+    {
+        statusLabel.setText("Error: " + result.getErrorMessage(), juce::dontSendNotification);
+        statusLabel.setColour(juce::Label::textColourId, DAIWLookAndFeel::Colors::error);
+        return;
+    }
+
+    measureLatencyButton.setEnabled(false);
+    showPending("Measuring round trip from output 1 to input 1...");
 }
 
 void AudioSettingsPanel::refreshDeviceLists()
 {
-    // Input devices
-    inputDeviceCombo.clear();
-    auto inputDevices = audioEngine.getAvailableInputDevices();
+    // Straight from the registry's cache; nothing is scanned here
+    rebuildDeviceCombo(inputDeviceCombo, true);
+    rebuildDeviceCombo(outputDeviceCombo, false);
+}
+
+void AudioSettingsPanel::rebuildDeviceCombo(juce::ComboBox& combo, bool isInput)
+{
+    combo.clear(juce::dontSendNotification);
+    auto devices = isInput ? audioEngine.getAvailableInputDevices()
+                           : audioEngine.getAvailableOutputDevices();
     int itemId = 1;
-    for (const auto& device : inputDevices)
+    for (const auto& device : devices)
     {
-        inputDeviceCombo.addItem(device, itemId++);
+        combo.addItem(device, itemId++);
     }
+}
 
-    // Output devices
-    outputDeviceCombo.clear();
-    auto outputDevices = audioEngine.getAvailableOutputDevices();
-    itemId = 1;
-    for (const auto& device : outputDevices)
+void AudioSettingsPanel::updateDeviceCombo(juce::ComboBox& combo,
+                                           const DeviceRegistry::Diff& diff, bool isInput)
+{
+    auto inList = [isInput](const DeviceRegistry::Device& device)
+    { return isInput ? device.isInput : device.isOutput; };
+
+    // ComboBox can't remove single items, so a removal (or a device changing direction)
+    // rebuilds the list from the cache
+    if (!diff.removed.empty() || !diff.changed.empty())
+    {
+        rebuildDeviceCombo(combo, isInput);
+        return;
+    }
+
+    for (const auto& device : diff.added)
     {
-        outputDeviceCombo.addItem(device, itemId++);
+        if (inList(device))
+        {
+            combo.addItem(device.name, combo.getNumItems() + 1);
+        }
     }
 }
 
+void AudioSettingsPanel::deviceListChanged(const DeviceRegistry::Diff& diff)
+{
+    updateDeviceCombo(inputDeviceCombo, diff, true);
+    updateDeviceCombo(outputDeviceCombo, diff, false);
+
+    // Puts the selection back on the current device
+    refreshCurrentSettings();
+}
+
 void AudioSettingsPanel::refreshCurrentSettings()
 {
     // Select current input device
@@ -153,7 +361,7 @@ void AudioSettingsPanel::refreshCurrentSettings()
     }
 
     // Sample rates
-    sampleRateCombo.clear();
+    sampleRateCombo.clear(juce::dontSendNotification);
     auto sampleRates = audioEngine.getAvailableSampleRates();
     auto currentSampleRate = audioEngine.getSampleRate();
     int selectedIndex = 0;
@@ -171,7 +379,7 @@ void AudioSettingsPanel::refreshCurrentSettings()
     sampleRateCombo.setSelectedItemIndex(selectedIndex, juce::dontSendNotification);
 
     // Buffer sizes
-    bufferSizeCombo.clear();
+    bufferSizeCombo.clear(juce::dontSendNotification);
     auto bufferSizes = audioEngine.getAvailableBufferSizes();
     auto currentBufferSize = audioEngine.getBufferSize();
     selectedIndex = 0;
@@ -200,11 +408,17 @@ void AudioSettingsPanel::refreshCurrentSettings()
     }
     bufferSizeCombo.setSelectedItemIndex(selectedIndex, juce::dontSendNotification);
 
-    // Update status
+    // Update status: the buffer alone, then the full round trip (measured if we can)
     if (currentSampleRate > 0 && currentBufferSize > 0)
     {
         auto latencyMs = static_cast<double>(currentBufferSize) / currentSampleRate * 1000.0;
-        statusLabel.setText("Latency: " + juce::String(latencyMs, 1) + " ms",
+        auto measured = audioEngine.getMeasuredLatency();
+        auto roundTrip = measured >= 0 ? measured : audioEngine.getReportedLatency();
+        auto roundTripMs = static_cast<double>(roundTrip) / currentSampleRate * 1000.0;
+
+        statusLabel.setText("Latency: " + juce::String(latencyMs, 1) + " ms buffer | " +
+                                juce::String(roundTripMs, 1) + " ms round trip " +
+                                (measured >= 0 ? "(measured)" : "(reported)"),
                             juce::dontSendNotification);
         statusLabel.setColour(juce::Label::textColourId, DAIWLookAndFeel::Colors::textMuted);
     }
@@ -220,31 +434,9 @@ void AudioSettingsPanel::inputDeviceChanged()
     auto deviceName = inputDeviceCombo.getText();
     DBG("Attempting to set input device to: " + deviceName);
 
-    statusLabel.setText("Setting input device...", juce::dontSendNotification);
-    statusLabel.setColour(juce::Label::textColourId, DAIWLookAndFeel::Colors::primaryAccent);
-
-    auto error = audioEngine.setInputDevice(deviceName);
-
-    if (error.isNotEmpty())
-    {
-        DBG("Failed to set input device: " + error);
-        statusLabel.setText("Error: " + error, juce::dontSendNotification);
-        statusLabel.setColour(juce::Label::textColourId, DAIWLookAndFeel::Colors::error);
-        // Refresh to show the actual current device
-        refreshCurrentSettings();
-    }
-    else
-    {
-        DBG("Successfully set input device to: " + deviceName);
-        // Don't call refreshCurrentSettings() here - let the change listener handle it
-        // Just update the status
-        auto latencyMs = static_cast<double>(audioEngine.getBufferSize()) /
-                         audioEngine.getSampleRate() * 1000.0;
-        statusLabel.setText("Input: " + deviceName + " | Latency: " +
-                                juce::String(latencyMs, 1) + " ms",
-                            juce::dontSendNotification);
-        statusLabel.setColour(juce::Label::textColourId, DAIWLookAndFeel::Colors::success);
-    }
+    // Applied in the background; deviceReconfigurationChanged() reports how it went
+    showPending("Setting input device to " + deviceName + "...");
+    audioEngine.setInputDevice(deviceName);
 }
 
 void AudioSettingsPanel::outputDeviceChanged()
@@ -252,29 +444,8 @@ void AudioSettingsPanel::outputDeviceChanged()
     auto deviceName = outputDeviceCombo.getText();
     DBG("Attempting to set output device to: " + deviceName);
 
-    statusLabel.setText("Setting output device...", juce::dontSendNotification);
-    statusLabel.setColour(juce::Label::textColourId, DAIWLookAndFeel::Colors::primaryAccent);
-
-    auto error = audioEngine.setOutputDevice(deviceName);
-
-    if (error.isNotEmpty())
-    {
-        DBG("Failed to set output device: " + error);
-        statusLabel.setText("Error: " + error, juce::dontSendNotification);
-        statusLabel.setColour(juce::Label::textColourId, DAIWLookAndFeel::Colors::error);
-        // Refresh to show the actual current device
-        refreshCurrentSettings();
-    }
-    else
-    {
-        DBG("Successfully set output device to: " + deviceName);
-        auto latencyMs = static_cast<double>(audioEngine.getBufferSize()) /
-                         audioEngine.getSampleRate() * 1000.0;
-        statusLabel.setText("Output: " + deviceName + " | Latency: " +
-                                juce::String(latencyMs, 1) + " ms",
-                            juce::dontSendNotification);
-        statusLabel.setColour(juce::Label::textColourId, DAIWLookAndFeel::Colors::success);
-    }
+    showPending("Setting output device to " + deviceName + "...");
+    audioEngine.setOutputDevice(deviceName);
 }
 
 void AudioSettingsPanel::sampleRateChanged()
@@ -284,18 +455,9 @@ void AudioSettingsPanel::sampleRateChanged()
 
     if (index >= 0 && index < sampleRates.size())
     {
-        auto error = audioEngine.setSampleRate(sampleRates[index]);
-
-        if (error.isNotEmpty())
-        {
-            DBG("Failed to set sample rate: " + error);
-            statusLabel.setText("Error: " + error, juce::dontSendNotification);
-            statusLabel.setColour(juce::Label::textColourId, DAIWLookAndFeel::Colors::error);
-        }
-        else
-        {
-            refreshCurrentSettings();
-        }
+        showPending("Setting sample rate to " + juce::String(static_cast<int>(sampleRates[index])) +
+                    " Hz...");
+        audioEngine.setSampleRate(sampleRates[index]);
     }
 }
 
@@ -306,17 +468,7 @@ void AudioSettingsPanel::bufferSizeChanged()
 
     if (index >= 0 && index < bufferSizes.size())
     {
-        auto error = audioEngine.setBufferSize(bufferSizes[index]);
-
-        if (error.isNotEmpty())
-        {
-            DBG("Failed to set buffer size: " + error);
-            statusLabel.setText("Error: " + error, juce::dontSendNotification);
-            statusLabel.setColour(juce::Label::textColourId, DAIWLookAndFeel::Colors::error);
-        }
-        else
-        {
-            refreshCurrentSettings();
-        }
+        showPending("Setting buffer size to " + juce::String(bufferSizes[index]) + " samples...");
+        audioEngine.setBufferSize(bufferSizes[index]);
     }
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../Audio/DeviceReconfigurer.h"
+#include "../Audio/DeviceRegistry.h"
 
 class AudioEngine;
 
@@ -11,8 +13,18 @@ class AudioEngine;
  * - Output device selection
  * - Sample rate selection
  * - Buffer size selection
+ * - Live DSP load / xrun readout, exportable as JSON
+ * - Round-trip latency measurement through a loopback
+ *
+ * Device changes are posted to the engine and applied in the background; the
+ * status line follows their progress. Device lists come from the engine's
+ * registry cache and are patched as devices are plugged in or removed.
  */
-class AudioSettingsPanel : public juce::Component, private juce::ChangeListener
+class AudioSettingsPanel : public juce::Component,
+                           private juce::ChangeListener,
+                           private juce::Timer,
+                           private DeviceReconfigurer::Listener,
+                           private DeviceRegistry::Listener
 {
 public:
     explicit AudioSettingsPanel(AudioEngine& audioEngine);
@@ -23,14 +35,24 @@ public:
 
 private:
     void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+    void timerCallback() override;
+    void deviceReconfigurationChanged(const DeviceReconfigurer::Progress& progress) override;
+    void deviceListChanged(const DeviceRegistry::Diff& diff) override;
 
     void refreshDeviceLists();
+    void rebuildDeviceCombo(juce::ComboBox& combo, bool isInput);
+    void updateDeviceCombo(juce::ComboBox& combo, const DeviceRegistry::Diff& diff, bool isInput);
     void refreshCurrentSettings();
 
     void inputDeviceChanged();
     void outputDeviceChanged();
     void sampleRateChanged();
     void bufferSizeChanged();
+    void showPending(const juce::String& text);
+
+    void refreshPerformance();
+    void exportPerformanceStats();
+    void measureLatency();
 
     AudioEngine& audioEngine;
 
@@ -55,6 +77,10 @@ private:
 
     // Status
     juce::Label statusLabel;
+    juce::Label performanceLabel;
+    juce::TextButton exportStatsButton;
+    juce::TextButton measureLatencyButton;
+    std::unique_ptr<juce::FileChooser> exportChooser;
 
     // Layout constants
     static constexpr int rowHeight = 36;
@@ -4,9 +4,24 @@
 // LevelMeter
 //==============================================================================
 
-LevelMeter::LevelMeter()
+LevelMeter::~LevelMeter()
 {
-    startTimerHz(30); // 30 fps update
+    setScheduler(nullptr);
+}
+
+void LevelMeter::setScheduler(FrameScheduler* newScheduler)
+{
+    if (scheduler != nullptr)
+    {
+        scheduler->removeClient(this);
+    }
+
+    scheduler = newScheduler;
+
+    if (scheduler != nullptr)
+    {
+        scheduler->addClient(this);
+    }
 }
 
 void LevelMeter::setLevel(float newLevel)
@@ -17,90 +32,285 @@ void LevelMeter::setLevel(float newLevel)
     if (currentLevel > displayLevel)
     {
         displayLevel = currentLevel;
+        changed();
+    }
+    else if (displayLevel > currentLevel)
+    {
+        // Nothing to redraw yet, but the decay has to run
+        if (scheduler != nullptr)
+        {
+            scheduler->wake();
+        }
+        else
+        {
+            // No decay without a scheduler: show the level as it is
+            displayLevel = currentLevel;
+            changed();
+        }
     }
 }
 
-void LevelMeter::timerCallback()
+void LevelMeter::setLevel(float newLevel, float newPeak, bool clipped)
 {
+    setLevel(newLevel);
+
+    newPeak = juce::jlimit(0.0f, 1.0f, newPeak);
+
+    if (newPeak >= peakLevel && newPeak > 0.0f)
+    {
+        peakLevel = newPeak;
+        peakHoldRemaining = peakHoldTime;
+        changed();
+    }
+
+    if (clipped)
+    {
+        clipHoldRemaining = clipHoldTime;
+        changed();
+    }
+}
+
+void LevelMeter::setVertical(bool shouldBeVertical)
+{
+    if (vertical != shouldBeVertical)
+    {
+        vertical = shouldBeVertical;
+        resized();
+        repaint();
+    }
+}
+
+void LevelMeter::changed()
+{
+    if (scheduler == nullptr)
+    {
+        updatePixels();
+        return;
+    }
+
+    scheduler->wake();
+}
+
+bool LevelMeter::advanceFrame(FrameScheduler& /*frameScheduler*/, double elapsedSeconds)
+{
+    auto frames = elapsedSeconds * decayFrameRate;
+
     // Decay the display level
     if (displayLevel > currentLevel)
     {
-        displayLevel *= decayRate;
+        displayLevel *= static_cast<float>(std::pow(decayRate, frames));
         if (displayLevel < 0.001f)
         {
             displayLevel = 0.0f;
         }
-        repaint();
     }
     else if (displayLevel < currentLevel)
     {
         displayLevel = currentLevel;
-        repaint();
+    }
+
+    // Hold the peak marker, then let it fall slowly
+    if (peakHoldRemaining > 0.0)
+    {
+        peakHoldRemaining -= elapsedSeconds;
+    }
+    else if (peakLevel > 0.0f)
+    {
+        peakLevel *= static_cast<float>(std::pow(peakDecayRate, frames));
+        if (peakLevel < 0.001f)
+        {
+            peakLevel = 0.0f;
+        }
+    }
+
+    if (clipHoldRemaining > 0.0)
+    {
+        clipHoldRemaining -= elapsedSeconds;
+    }
+
+    updatePixels();
+
+    return displayLevel != currentLevel || peakLevel > 0.0f || clipHoldRemaining > 0.0;
+}
+
+int LevelMeter::levelToPixels(float level) const
+{
+    return static_cast<int>(
+        std::upper_bound(pixelThresholds.begin(), pixelThresholds.end(), level) -
+        pixelThresholds.begin());
+}
+
+void LevelMeter::updatePixels()
+{
+    auto newLevelPixels = levelToPixels(displayLevel);
+    auto newPeakPixels = levelToPixels(peakLevel);
+    auto newShowingClip = clipHoldRemaining > 0.0;
+
+    if (newShowingClip != showingClip)
+    {
+        showingClip = newShowingClip;
+        invalidate(getLocalBounds());
+    }
+
+    if (newLevelPixels != levelPixels)
+    {
+        invalidate(getStrip(juce::jmin(levelPixels, newLevelPixels),
+                            juce::jmax(levelPixels, newLevelPixels)));
+        levelPixels = newLevelPixels;
+    }
+
+    // The marker covers the two pixels below its level
+    if (newPeakPixels != peakPixels)
+    {
+        invalidate(getStrip(peakPixels - 2, peakPixels));
+        invalidate(getStrip(newPeakPixels - 2, newPeakPixels));
+        peakPixels = newPeakPixels;
     }
 }
 
-void LevelMeter::paint(juce::Graphics& g)
+void LevelMeter::invalidate(juce::Rectangle<int> area)
 {
+    if (area.isEmpty())
+    {
+        return;
+    }
+
+    if (scheduler != nullptr)
+    {
+        scheduler->invalidate(*this, area);
+    }
+    else
+    {
+        repaint(area);
+    }
+}
+
+juce::Rectangle<int> LevelMeter::getStrip(int from, int to) const
+{
+    auto bar = getLocalBounds().reduced(1);
+    from = juce::jmax(0, from);
+
+    if (to <= from)
+    {
+        return {};
+    }
+
+    if (vertical)
+    {
+        return {bar.getX(), bar.getBottom() - to, bar.getWidth(), to - from};
+    }
+
+    return {bar.getX() + from, bar.getY(), to - from, bar.getHeight()};
+}
+
+void LevelMeter::resized()
+{
+    auto bar = getLocalBounds().reduced(1);
+    auto length = juce::jmax(0, vertical ? bar.getHeight() : bar.getWidth());
+
+    // Pixel i lights once the level's place on the -60..0 dB scale passes its centre
+    pixelThresholds.resize(static_cast<size_t>(length));
+
+    for (int i = 0; i < length; ++i)
+    {
+        auto position = (static_cast<float>(i) + 0.5f) / static_cast<float>(length);
+        auto db = juce::jmap(position, minimumDecibels, 0.0f);
+        pixelThresholds[static_cast<size_t>(i)] = juce::Decibels::decibelsToGain(db);
+    }
+
+    levelPixels = levelToPixels(displayLevel);
+    peakPixels = levelToPixels(peakLevel);
+
+    // Re-rendered at the next paint, at whatever scale it happens at
+    backgroundImage = {};
+    fillImage = {};
+}
+
+void LevelMeter::renderImages(float scale)
+{
+    imageScale = scale;
+
+    auto width = juce::roundToInt(static_cast<float>(getWidth()) * scale);
+    auto height = juce::roundToInt(static_cast<float>(getHeight()) * scale);
+
+    if (width <= 0 || height <= 0)
+    {
+        return;
+    }
+
     auto bounds = getLocalBounds().toFloat().reduced(1.0f);
 
-    // Background
-    g.setColour(DAIWLookAndFeel::Colors::surface);
-    g.fillRoundedRectangle(bounds, 3.0f);
+    // Background and border
+    backgroundImage = juce::Image(juce::Image::ARGB, width, height, true);
+    {
+        juce::Graphics g(backgroundImage);
+        g.addTransform(juce::AffineTransform::scale(scale));
+
+        g.setColour(DAIWLookAndFeel::Colors::surface);
+        g.fillRoundedRectangle(bounds, 3.0f);
 
-    // Calculate filled portion
-    float fillAmount = displayLevel;
+        g.setColour(DAIWLookAndFeel::Colors::border);
+        g.drawRoundedRectangle(getLocalBounds().toFloat().reduced(0.5f), 3.0f, 1.0f);
+    }
 
-    // Convert to decibels for more natural display
-    // -60dB to 0dB range mapped to 0-1
-    if (fillAmount > 0.0f)
+    // The full-scale bar: green to yellow from -24 dB, to red from -9 dB
+    fillImage = juce::Image(juce::Image::ARGB, width, height, true);
     {
-        float db = juce::Decibels::gainToDecibels(fillAmount, -60.0f);
-        fillAmount = juce::jmap(db, -60.0f, 0.0f, 0.0f, 1.0f);
+        juce::Graphics g(fillImage);
+        g.addTransform(juce::AffineTransform::scale(scale));
+
+        auto start = vertical ? bounds.getBottomLeft() : bounds.getTopLeft();
+        auto end = vertical ? bounds.getTopLeft() : bounds.getTopRight();
+        juce::ColourGradient gradient(DAIWLookAndFeel::Colors::success, start,
+                                      DAIWLookAndFeel::Colors::error.brighter(0.5f), end, false);
+        gradient.addColour(0.55, DAIWLookAndFeel::Colors::success);
+        gradient.addColour(0.65, DAIWLookAndFeel::Colors::warning.brighter(0.15f));
+        gradient.addColour(0.8, DAIWLookAndFeel::Colors::warning.brighter(0.3f));
+        gradient.addColour(0.9, DAIWLookAndFeel::Colors::error.brighter(0.4f));
+
+        g.setGradientFill(gradient);
+        g.fillRoundedRectangle(bounds, 3.0f);
     }
+}
+
+void LevelMeter::paint(juce::Graphics& g)
+{
+    auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
 
-    if (fillAmount > 0.0f)
+    if (backgroundImage.isNull() || scale != imageScale)
     {
-        juce::Rectangle<float> fillBounds;
+        renderImages(scale);
+    }
 
-        if (vertical)
-        {
-            float fillHeight = bounds.getHeight() * fillAmount;
-            fillBounds = bounds.removeFromBottom(fillHeight);
-        }
-        else
-        {
-            float fillWidth = bounds.getWidth() * fillAmount;
-            fillBounds = bounds.removeFromLeft(fillWidth);
-        }
+    if (backgroundImage.isNull())
+    {
+        return;
+    }
 
-        // Gradient from green to yellow to red
-        juce::Colour fillColour;
-        if (fillAmount < 0.6f)
-        {
-            fillColour = DAIWLookAndFeel::Colors::success;
-        }
-        else if (fillAmount < 0.85f)
-        {
-            fillColour = DAIWLookAndFeel::Colors::warning;
-        }
-        else
-        {
-            fillColour = DAIWLookAndFeel::Colors::error;
-        }
+    // Everything comes from the cached images; the clip region is usually one strip
+    auto area = getLocalBounds().toFloat();
+    g.drawImage(backgroundImage, area);
 
-        // Add glow effect for high levels
-        if (fillAmount > 0.5f)
-        {
-            fillColour = fillColour.brighter(fillAmount - 0.5f);
-        }
+    if (levelPixels > 0)
+    {
+        juce::Graphics::ScopedSaveState state(g);
+        g.reduceClipRegion(getStrip(0, levelPixels));
+        g.drawImage(fillImage, area);
+    }
 
-        g.setColour(fillColour);
-        g.fillRoundedRectangle(fillBounds, 3.0f);
+    // Peak marker
+    if (peakPixels > 0)
+    {
+        g.setColour(DAIWLookAndFeel::Colors::textPrimary.withAlpha(0.8f));
+        g.fillRect(getStrip(peakPixels - 2, peakPixels));
     }
 
-    // Border
-    g.setColour(DAIWLookAndFeel::Colors::border);
-    g.drawRoundedRectangle(getLocalBounds().toFloat().reduced(0.5f), 3.0f, 1.0f);
+    // Red border while a recent block clipped
+    if (showingClip)
+    {
+        g.setColour(DAIWLookAndFeel::Colors::error);
+        g.drawRoundedRectangle(area.reduced(0.5f), 3.0f, 1.0f);
+    }
 }
 
 //==============================================================================
@@ -111,7 +321,12 @@ StereoLevelMeter::StereoLevelMeter()
 {
     addAndMakeVisible(leftMeter);
     addAndMakeVisible(rightMeter);
-    startTimerHz(30);
+}
+
+void StereoLevelMeter::setScheduler(FrameScheduler* scheduler)
+{
+    leftMeter.setScheduler(scheduler);
+    rightMeter.setScheduler(scheduler);
 }
 
 void StereoLevelMeter::setLevels(float left, float right)
@@ -120,9 +335,10 @@ void StereoLevelMeter::setLevels(float left, float right)
     rightMeter.setLevel(right);
 }
 
-void StereoLevelMeter::timerCallback()
+void StereoLevelMeter::setLevels(const MeterFrame& frame)
 {
-    // Timer handled by individual meters
+    leftMeter.setLevel(frame.rms[0], frame.truePeak[0], frame.clipped);
+    rightMeter.setLevel(frame.rms[1], frame.truePeak[1], frame.clipped);
 }
 
 void StereoLevelMeter::paint(juce::Graphics& g)
@@ -1,36 +1,91 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../../Audio/MeterFifo.h"
+#include "../FrameScheduler.h"
 #include "../LookAndFeel/DAIWLookAndFeel.h"
 
+#include <vector>
+
 /**
  * LevelMeter displays audio levels with smooth decay.
  *
+ * The bar shows RMS, a thin marker holds the recent peak, and the border
+ * turns red for a moment after a clipped block.
  * Can display as vertical or horizontal bar.
+ *
+ * Decay and hold are advanced by a FrameScheduler shared with the rest of the
+ * window; without one the meter just shows each level as it is set.
+ *
+ * Painting is cheap enough for a full mixer of meters: the background and the
+ * gradient bar are rendered once per size into images, levels map to pixels
+ * through a per-pixel threshold table (no decibel maths per frame), and only
+ * the strip between the old and new level (and the old and new peak marker)
+ * is repainted.
  */
-class LevelMeter : public juce::Component, private juce::Timer
+class LevelMeter : public juce::Component, private FrameScheduler::Client
 {
 public:
-    LevelMeter();
-    ~LevelMeter() override = default;
+    LevelMeter() = default;
+    ~LevelMeter() override;
+
+    void setScheduler(FrameScheduler* newScheduler);
 
     void paint(juce::Graphics& g) override;
+    void resized() override;
 
     // Set the current level (0.0 to 1.0)
     void setLevel(float newLevel);
 
+    // Set the current RMS level, peak level and clip state
+    void setLevel(float newLevel, float newPeak, bool clipped);
+
     // Set whether the meter is vertical (default) or horizontal
-    void setVertical(bool shouldBeVertical) { vertical = shouldBeVertical; }
+    void setVertical(bool shouldBeVertical);
+
+    // Pixels lit along the bar for a level (-60 dB to 0 dB)
+    int levelToPixels(float level) const;
+
+    static constexpr float minimumDecibels = -60.0f;
 
 private:
-    void timerCallback() override;
+    bool advanceFrame(FrameScheduler& frameScheduler, double elapsedSeconds) override;
+    void changed();
+    void updatePixels();
+    void invalidate(juce::Rectangle<int> area);
+    void renderImages(float scale);
 
+    // The part of the bar covering pixels [from, to), counted from the bottom (or left)
+    juce::Rectangle<int> getStrip(int from, int to) const;
+
+    FrameScheduler* scheduler = nullptr;
     float currentLevel = 0.0f;
     float displayLevel = 0.0f;
+    float peakLevel = 0.0f;
+    double peakHoldRemaining = 0.0;
+    double clipHoldRemaining = 0.0;
     bool vertical = true;
 
-    // Decay rate (how fast the meter falls)
+    // What is on screen, so only the difference gets repainted
+    int levelPixels = 0;
+    int peakPixels = 0;
+    bool showingClip = false;
+
+    // Rebuilt on resize: the gain at which each pixel of the bar lights, and the
+    // images the bar is drawn from (at the display's pixel scale)
+    std::vector<float> pixelThresholds;
+    juce::Image backgroundImage;
+    juce::Image fillImage;
+    float imageScale = 0.0f;
+
+    // Decay rate (how fast the meter falls), per 1/30 s whatever the display rate
+    static constexpr double decayFrameRate = 30.0;
     static constexpr float decayRate = 0.92f;
+    static constexpr float peakDecayRate = 0.97f;
+
+    // How long (in seconds) the peak marker and clip indicator hold
+    static constexpr double peakHoldTime = 1.0;
+    static constexpr double clipHoldTime = 1.5;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LevelMeter)
 };
@@ -38,24 +93,27 @@ private:
 /**
  * StereoLevelMeter displays left and right channel levels.
  */
-class StereoLevelMeter : public juce::Component, private juce::Timer
+class StereoLevelMeter : public juce::Component
 {
 public:
     StereoLevelMeter();
     ~StereoLevelMeter() override = default;
 
+    void setScheduler(FrameScheduler* scheduler);
+
     void paint(juce::Graphics& g) override;
     void resized() override;
 
     // Set levels for left and right channels (0.0 to 1.0)
     void setLevels(float left, float right);
 
+    // Set levels from a (folded) meter frame
+    void setLevels(const MeterFrame& frame);
+
     // Set label
     void setLabel(const juce::String& text) { label = text; }
 
 private:
-    void timerCallback() override;
-
     LevelMeter leftMeter;
     LevelMeter rightMeter;
     juce::String label;
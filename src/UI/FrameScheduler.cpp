@@ -0,0 +1,142 @@
+#include "FrameScheduler.h"
+
+FrameScheduler::FrameScheduler(juce::Component& hostComponent) : host(hostComponent)
+{
+}
+
+FrameScheduler::~FrameScheduler()
+{
+    stopTimer();
+    vblank.reset();
+}
+
+void FrameScheduler::addClient(Client* client)
+{
+    if (std::find(clients.begin(), clients.end(), client) == clients.end())
+    {
+        clients.push_back(client);
+    }
+}
+
+void FrameScheduler::removeClient(Client* client)
+{
+    clients.erase(std::remove(clients.begin(), clients.end(), client), clients.end());
+}
+
+int FrameScheduler::addSource(std::function<void()> pull)
+{
+    auto sourceId = ++nextSourceId;
+    sources.emplace_back(sourceId, std::move(pull));
+    wake();
+    return sourceId;
+}
+
+void FrameScheduler::removeSource(int sourceId)
+{
+    auto matches = [sourceId](const auto& source) { return source.first == sourceId; };
+    sources.erase(std::remove_if(sources.begin(), sources.end(), matches), sources.end());
+}
+
+void FrameScheduler::invalidate(juce::Component& component)
+{
+    invalidate(component, component.getLocalBounds());
+}
+
+void FrameScheduler::invalidate(juce::Component& component, juce::Rectangle<int> area)
+{
+    if (!component.isShowing())
+    {
+        return;
+    }
+
+    // Anything outside the host repaints on its own
+    if (&component != &host && !host.isParentOf(&component))
+    {
+        component.repaint(area);
+        return;
+    }
+
+    dirty.add(host.getLocalArea(&component, area));
+}
+
+void FrameScheduler::wake()
+{
+    stopTimer();
+
+    if (vblank == nullptr)
+    {
+        lastFrameMs = juce::Time::getMillisecondCounterHiRes();
+        vblank = std::make_unique<juce::VBlankAttachment>(&host, [this] { frame(); });
+    }
+}
+
+void FrameScheduler::frame()
+{
+    auto now = juce::Time::getMillisecondCounterHiRes();
+    auto elapsed = juce::jmin((now - lastFrameMs) / 1000.0, maxFrameSeconds);
+    lastFrameMs = now;
+
+    // The attachment can't be released from inside its own callback, so the idle
+    // poll does it on its first tick unless something starts moving before then
+    if (renderFrame(elapsed))
+    {
+        stopTimer();
+    }
+    else if (!isTimerRunning())
+    {
+        startTimerHz(idlePollHz);
+    }
+}
+
+bool FrameScheduler::renderFrame(double elapsedSeconds)
+{
+    pullSources();
+
+    auto moving = false;
+
+    // By index: a client may remove itself (or another) while advancing
+    for (size_t i = 0; i < clients.size(); ++i)
+    {
+        moving = clients[i]->advanceFrame(*this, elapsedSeconds) || moving;
+    }
+
+    flush();
+    return moving;
+}
+
+void FrameScheduler::pullSources()
+{
+    for (auto& source : sources)
+    {
+        source.second();
+    }
+}
+
+void FrameScheduler::flush()
+{
+    // Neighbouring meters merge into one area; the rest go out as they are
+    dirty.consolidate();
+
+    for (const auto& area : dirty)
+    {
+        host.repaint(area);
+    }
+
+    repainted.swapWith(dirty);
+    dirty.clear();
+}
+
+void FrameScheduler::timerCallback()
+{
+    vblank.reset();
+
+    if (sources.empty())
+    {
+        stopTimer();
+        return;
+    }
+
+    // A client that gets something to show wakes the scheduler from here
+    pullSources();
+    flush();
+}
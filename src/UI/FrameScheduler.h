@@ -0,0 +1,83 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * FrameScheduler drives every meter and animation in a window from one
+ * display-synchronised callback, instead of a timer per component.
+ *
+ * Each frame it runs the sources (which pull new data, e.g. draining the
+ * meter FIFOs), then advances every client by the time since the previous
+ * frame. Clients mark what they need redrawn with invalidate(); the areas are
+ * merged and repainted through the host in one pass at the end of the frame.
+ *
+ * When no client is still moving the frame callback is released, and the
+ * sources are polled at idlePollHz until a client wakes the scheduler again
+ * (a meter does so as soon as it receives a level worth drawing). With no
+ * sources either, nothing runs at all.
+ *
+ * Message thread only. The host must outlive its clients.
+ */
+class FrameScheduler : private juce::Timer
+{
+public:
+    class Client
+    {
+    public:
+        virtual ~Client() = default;
+
+        // Advance by the time since the last frame; true while still moving
+        virtual bool advanceFrame(FrameScheduler& scheduler, double elapsedSeconds) = 0;
+    };
+
+    explicit FrameScheduler(juce::Component& host);
+    ~FrameScheduler() override;
+
+    void addClient(Client* client);
+    void removeClient(Client* client);
+
+    // Called at the start of every frame, and on the idle poll; returns an id for removeSource
+    int addSource(std::function<void()> pull);
+    void removeSource(int sourceId);
+
+    // Repaint this component's area (or part of it) at the end of the frame
+    void invalidate(juce::Component& component);
+    void invalidate(juce::Component& component, juce::Rectangle<int> area);
+
+    // Resume frame callbacks if they were stopped
+    void wake();
+
+    bool isRunning() const { return vblank != nullptr; }
+
+    // One frame at a fixed step with no display attached (offscreen rendering and
+    // benchmarks); true while any client is still moving
+    bool renderFrame(double elapsedSeconds);
+
+    // What the last frame repainted, merged, in host coordinates
+    const juce::RectangleList<int>& getLastRepaintedArea() const { return repainted; }
+
+    static constexpr int idlePollHz = 10;
+    static constexpr double maxFrameSeconds = 0.1; // Longest step after a stall
+
+private:
+    void frame();
+    void pullSources();
+    void flush();
+    void timerCallback() override;
+
+    juce::Component& host;
+    std::unique_ptr<juce::VBlankAttachment> vblank;
+    std::vector<Client*> clients;
+    std::vector<std::pair<int, std::function<void()>>> sources;
+    int nextSourceId = 0;
+    juce::RectangleList<int> dirty; // In host coordinates
+    juce::RectangleList<int> repainted;
+    double lastFrameMs = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FrameScheduler)
+};